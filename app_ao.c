@@ -0,0 +1,572 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Active objects.
+* Event queues: a ring of APP_AO_EVT per object, many posters and one reader (the AO task). A poster reserves
+* a slot by incrementing QHead with LDREX/STREX, fills it and writes its signal last; the AO task reads the
+* slot at QTail once its signal is set, frees it (APP_AO_SIG_NONE) and increments QTail. A poster preempted
+* between the reservation and the signal write only delays that object: the ready bit is set after the
+* publication, so the AO task comes back to it.
+*
+* Scheduling: one ready bit per priority, set by the posters (LDREX/STREX) and scanned with count-leading-
+* zeros. The AO task clears the bit, takes one event and sets the bit again if more are queued, so objects
+* of the same priority do not exist and higher ones are always served first, one event at a time.
+*
+* Time events and the report are handled by the AO task itself, with the task semaphore pend timeout set to
+* the nearest due time: no timer task, no extra stack.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <system_MK64F12.h>
+
+#include  "app_ao.h"
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_AO               *App_AO_Tbl[APP_CFG_AO_MAX];       /* Objects, indexed by priority.                        */
+static  CPU_INT08U            App_AO_Nbr;
+static  volatile  CPU_INT32U  App_AO_Rdy;                       /* One bit per priority with queued events.             */
+static  CPU_BOOLEAN           App_AO_Running;
+
+static  APP_AO_TMR           *App_AO_TmrListPtr;
+
+static  OS_TICK               App_AO_ReportPeriod;              /* In ticks, 0 = no report.                             */
+static  OS_TICK               App_AO_ReportDue;
+static  CPU_TS_TMR_FREQ       App_AO_TS_Freq;
+
+static  OS_TCB                App_AO_TaskTCB;
+static  CPU_STK               App_AO_TaskStk[APP_CFG_AO_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         App_AO_Task      (void        *p_arg);
+
+static  CPU_BOOLEAN  App_AO_Get       (APP_AO      *p_ao,
+                                       APP_AO_EVT  *p_evt);
+
+static  OS_TICK      App_AO_TmrUpdate (void);
+
+static  void         App_AO_RdySet    (CPU_INT08U   prio);
+
+static  void         App_AO_RdyClr    (CPU_INT08U   prio);
+
+static  CPU_INT32U   App_AO_TS_to_uS  (CPU_INT64U   ts);
+
+
+/*
+*********************************************************************************************************
+*                                           App_AO_Create()
+*
+* Description : Registers an object and queues its APP_AO_SIG_INIT event. Call before App_AO_Start().
+*
+* Argument(s) : p_ao        object (usually the first member of the app's own structure).
+*               p_name      name printed in the report.
+*               prio        priority, 0 to APP_CFG_AO_MAX - 1, higher values first; one object per priority.
+*               init        initial state handler, receives APP_AO_SIG_INIT.
+*               p_q         event queue storage.
+*               q_size      number of events in p_q, rounded down to a power of 2.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_AO_Create (APP_AO       *p_ao,
+                     CPU_CHAR     *p_name,
+                     CPU_INT08U    prio,
+                     APP_AO_FNCT   init,
+                     APP_AO_EVT   *p_q,
+                     CPU_INT16U    q_size)
+{
+    CPU_INT16U  i;
+
+
+    if ((prio >= APP_CFG_AO_MAX) ||
+        (App_AO_Tbl[prio] != (APP_AO *)0) ||
+        (q_size == 0u)) {
+        return;
+    }
+
+    while ((q_size & (q_size - 1u)) != 0u) {                    /* Keep the highest bit: free-running indexes wrap      */
+        q_size &= q_size - 1u;                                  /* cleanly on 2^32 only with a power of 2               */
+    }
+
+    p_ao->State   = init;
+    p_ao->NamePtr = p_name;
+    p_ao->Prio    = prio;
+    p_ao->QPtr    = p_q;
+    p_ao->QSize   = q_size;
+    p_ao->QHead   = 0u;
+    p_ao->QTail   = 0u;
+    p_ao->QMax    = 0u;
+    p_ao->DropCtr = 0u;
+    p_ao->DispCtr = 0u;
+    p_ao->LatSum  = 0u;
+    p_ao->LatMax  = 0u;
+    for (i = 0u; i < q_size; i++) {
+        p_q[i].Sig = APP_AO_SIG_NONE;
+    }
+
+    App_AO_Tbl[prio] = p_ao;
+    App_AO_Nbr++;
+
+    (void)App_AO_Post(p_ao, APP_AO_SIG_INIT, 0u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            App_AO_Start()
+*
+* Description : Creates the AO task, which delivers the INIT events and then runs the objects.
+*
+* Argument(s) : report_period_s     interval between two reports, in seconds (0 = no report).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_AO_Start (CPU_INT16U  report_period_s)
+{
+    OS_ERR   os_err;
+    CPU_ERR  cpu_err;
+
+
+    App_AO_ReportPeriod = (OS_TICK)report_period_s * OSCfg_TickRate_Hz;
+    App_AO_ReportDue    = OSTimeGet(&os_err) + App_AO_ReportPeriod;
+    App_AO_TS_Freq      = CPU_TS_TmrFreqGet(&cpu_err);
+
+    OSTaskCreate(&App_AO_TaskTCB,
+                 "Active objects",
+                  App_AO_Task,
+                  0u,
+                  APP_CFG_AO_TASK_PRIO,
+                 &App_AO_TaskStk[0u],
+                 (APP_CFG_AO_TASK_STK_SIZE / 10u),
+                  APP_CFG_AO_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+
+    App_AO_Running = DEF_YES;
+}
+
+
+/*
+*********************************************************************************************************
+*                                            App_AO_Post()
+*
+* Description : Queues an event. May be called from a task, a kernel-aware ISR or a state handler; fast ISRs
+*               defer the post with App_IRQ_Defer().
+*
+* Argument(s) : p_ao        destination object.
+*               sig         signal, APP_AO_SIG_USER or above.
+*               par         parameter passed with the event.
+*
+* Return(s)   : DEF_FALSE if the queue is full (the event is lost and counted), DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_AO_Post (APP_AO       *p_ao,
+                          APP_AO_SIG    sig,
+                          CPU_INT32U    par)
+{
+    APP_AO_EVT  *p_slot;
+    CPU_INT32U   head;
+    CPU_INT32U   used;
+    OS_ERR       os_err;
+
+
+    do {                                                        /* Reserve a slot                                       */
+        head = __LDREXW((volatile CPU_INT32U *)&p_ao->QHead);
+        if ((head - p_ao->QTail) >= p_ao->QSize) {
+            __CLREX();
+            p_ao->DropCtr++;                                    /* Statistics only, a lost increment is harmless        */
+            return (DEF_FALSE);
+        }
+    } while (__STREXW(head + 1u, (volatile CPU_INT32U *)&p_ao->QHead) != 0u);
+
+    p_slot      = &p_ao->QPtr[head & (p_ao->QSize - 1u)];
+    p_slot->Par = par;
+    p_slot->TS  = OS_TS_GET();
+    __DMB();                                                    /* Contents visible before the signal                   */
+    p_slot->Sig = sig;
+
+    used = head + 1u - p_ao->QTail;
+    if (used > p_ao->QMax) {
+        p_ao->QMax = (CPU_INT16U)used;
+    }
+
+    App_AO_RdySet(p_ao->Prio);
+    if (App_AO_Running == DEF_YES) {
+        (void)OSTaskSemPost(&App_AO_TaskTCB, OS_OPT_POST_NONE, &os_err);
+    }
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            App_AO_Tran()
+*
+* Description : State transition: sends APP_AO_SIG_EXIT to the current state and APP_AO_SIG_ENTRY to the new
+*               one. Call from a state handler of the object only.
+*
+* Argument(s) : p_ao        object.
+*               state       new state handler.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_AO_Tran (APP_AO       *p_ao,
+                   APP_AO_FNCT   state)
+{
+    APP_AO_EVT  evt;
+
+
+    evt.Par     = 0u;
+    evt.TS      = OS_TS_GET();
+
+    evt.Sig     = APP_AO_SIG_EXIT;
+    p_ao->State(p_ao, &evt);
+
+    p_ao->State = state;
+    evt.Sig     = APP_AO_SIG_ENTRY;
+    state(p_ao, &evt);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   App_AO_TmrArm() / App_AO_TmrDisarm()
+*
+* Description : Arms a time event: 'sig' is posted to 'p_ao' after 'dly' ticks, then every 'period' ticks
+*               (0 = one-shot). Re-arming an armed time event restarts it. Call from a state handler, or
+*               before App_AO_Start().
+*
+* Note(s)     : (1) An event that was already due is still in the queue after a disarm or a re-arm: handlers
+*                   must tolerate a stale time event (usually by state).
+*********************************************************************************************************
+*/
+
+void  App_AO_TmrArm (APP_AO_TMR  *p_tmr,
+                     APP_AO      *p_ao,
+                     APP_AO_SIG   sig,
+                     OS_TICK      dly,
+                     OS_TICK      period)
+{
+    OS_ERR  os_err;
+
+
+    if (p_tmr->Linked != DEF_YES) {
+        p_tmr->NextPtr    = App_AO_TmrListPtr;
+        App_AO_TmrListPtr = p_tmr;
+        p_tmr->Linked     = DEF_YES;
+    }
+
+    p_tmr->AO_Ptr = p_ao;
+    p_tmr->Sig    = sig;
+    p_tmr->Due    = OSTimeGet(&os_err) + ((dly == 0u) ? 1u : dly);
+    p_tmr->Period = period;
+    p_tmr->Armed  = DEF_YES;
+}
+
+
+void  App_AO_TmrDisarm (APP_AO_TMR  *p_tmr)
+{
+    p_tmr->Armed = DEF_NO;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_AO_Report()
+*
+* Description : Prints, for each object, the events dispatched and their dispatch latency since the previous
+*               report, the queue high-water mark and the lost posts; then the shared stack use and the RAM
+*               of the framework against one task (TCB and APP_CFG_TASK_START_STK_SIZE stack) per object.
+*               Runs in the AO task.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_AO_Report (void)
+{
+    APP_AO      *p_ao;
+    APP_AO_TMR  *p_tmr;
+    CPU_INT32U   ram;
+    CPU_INT32U   ram_tasks;
+    CPU_INT08U   i;
+    char         tmp[112];
+#if (OS_CFG_STAT_TASK_STK_CHK_EN > 0u)
+    CPU_STK_SIZE  stk_free;
+    CPU_STK_SIZE  stk_used;
+    OS_ERR        os_err;
+#endif
+
+
+    ram = sizeof(OS_TCB) + sizeof(App_AO_TaskStk);
+    for (i = 0u; i < APP_CFG_AO_MAX; i++) {
+        p_ao = App_AO_Tbl[i];
+        if (p_ao == (APP_AO *)0) {
+            continue;
+        }
+        ram += sizeof(APP_AO) + p_ao->QSize * sizeof(APP_AO_EVT);
+
+        sprintf(tmp, "%-8.8s: %u events, dispatch %u us avg, %u us max, queue %u/%u, %u lost\n\r",
+                p_ao->NamePtr,
+                (unsigned)p_ao->DispCtr,
+                (unsigned)((p_ao->DispCtr == 0u) ? 0u : App_AO_TS_to_uS(p_ao->LatSum / p_ao->DispCtr)),
+                (unsigned)App_AO_TS_to_uS(p_ao->LatMax),
+                (unsigned)p_ao->QMax,
+                (unsigned)p_ao->QSize,
+                (unsigned)p_ao->DropCtr);
+        APP_TRACE_DBG(( tmp ));
+
+        p_ao->DispCtr = 0u;                                     /* Only the AO task writes these                        */
+        p_ao->LatSum  = 0u;
+        p_ao->LatMax  = 0u;
+    }
+    for (p_tmr = App_AO_TmrListPtr; p_tmr != (APP_AO_TMR *)0; p_tmr = p_tmr->NextPtr) {
+        ram += sizeof(APP_AO_TMR);
+    }
+    ram_tasks = App_AO_Nbr * (sizeof(OS_TCB) + APP_CFG_TASK_START_STK_SIZE * sizeof(CPU_STK));
+
+#if (OS_CFG_STAT_TASK_STK_CHK_EN > 0u)
+    OSTaskStkChk(&App_AO_TaskTCB, &stk_free, &stk_used, &os_err);
+    sprintf(tmp, "AO stack: %u of %u bytes used\n\r",
+            (unsigned)(stk_used * sizeof(CPU_STK)),
+            (unsigned)sizeof(App_AO_TaskStk));
+    APP_TRACE_DBG(( tmp ));
+#endif
+    sprintf(tmp, "AO RAM: %u bytes for %u objects, %u bytes with one task per object\n\r",
+            (unsigned)ram,
+            (unsigned)App_AO_Nbr,
+            (unsigned)ram_tasks);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_AO_Task (void  *p_arg)
+{
+    APP_AO      *p_ao;
+    APP_AO_EVT   evt;
+    CPU_INT32U   rdy;
+    CPU_INT08U   prio;
+    CPU_TS       lat;
+    OS_TICK      dly;
+    OS_ERR       os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        dly = App_AO_TmrUpdate();                               /* Posts the due time events                            */
+
+        rdy = App_AO_Rdy;
+        if (rdy == 0u) {
+            (void)OSTaskSemPend(dly,                            /* 0: nothing armed, wait for a post                    */
+                                OS_OPT_PEND_BLOCKING,
+                                (CPU_TS *)0,
+                               &os_err);
+            continue;
+        }
+
+        prio = (CPU_INT08U)(31u - CPU_CntLeadZeros(rdy));       /* Highest ready object                                 */
+        p_ao = App_AO_Tbl[prio];
+        App_AO_RdyClr(prio);
+        if (App_AO_Get(p_ao, &evt) != DEF_YES) {                /* Not published yet: the poster sets the bit again     */
+            continue;
+        }
+        if (p_ao->QHead != p_ao->QTail) {
+            App_AO_RdySet(prio);
+        }
+
+        lat = OS_TS_GET() - evt.TS;
+        p_ao->DispCtr++;
+        p_ao->LatSum += lat;
+        if (lat > p_ao->LatMax) {
+            p_ao->LatMax = lat;
+        }
+
+        p_ao->State(p_ao, &evt);                                /* Run to completion                                    */
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            App_AO_Get()
+*
+* Description : Takes the event at the tail of the queue, if it is published.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_AO_Get (APP_AO      *p_ao,
+                                 APP_AO_EVT  *p_evt)
+{
+    APP_AO_EVT  *p_slot;
+    CPU_INT32U   tail;
+
+
+    tail   = p_ao->QTail;
+    p_slot = &p_ao->QPtr[tail & (p_ao->QSize - 1u)];
+    if (p_slot->Sig == APP_AO_SIG_NONE) {
+        return (DEF_NO);
+    }
+    __DMB();
+
+    p_evt->Sig  = p_slot->Sig;
+    p_evt->Par  = p_slot->Par;
+    p_evt->TS   = p_slot->TS;
+    p_slot->Sig = APP_AO_SIG_NONE;
+    __DMB();                                                    /* Slot free before it can be reserved again            */
+    p_ao->QTail = tail + 1u;
+
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_AO_TmrUpdate()
+*
+* Description : Posts the time events that are due, prints the report when due and returns the number of
+*               ticks until the next of them (0 when none is pending).
+*********************************************************************************************************
+*/
+
+static  OS_TICK  App_AO_TmrUpdate (void)
+{
+    APP_AO_TMR  *p_tmr;
+    OS_TICK      now;
+    OS_TICK      next;
+    OS_TICK      remain;
+    OS_ERR       os_err;
+
+
+    now  = OSTimeGet(&os_err);
+    next = 0u;
+
+    for (p_tmr = App_AO_TmrListPtr; p_tmr != (APP_AO_TMR *)0; p_tmr = p_tmr->NextPtr) {
+        if (p_tmr->Armed != DEF_YES) {
+            continue;
+        }
+        if ((OS_TICK)(now - p_tmr->Due) < 0x80000000u) {        /* Due                                                  */
+            (void)App_AO_Post(p_tmr->AO_Ptr, p_tmr->Sig, 0u);
+            if (p_tmr->Period == 0u) {
+                p_tmr->Armed = DEF_NO;
+                continue;
+            }
+            p_tmr->Due += p_tmr->Period;                        /* Stay on the period grid ...                          */
+            if ((OS_TICK)(now - p_tmr->Due) < 0x80000000u) {
+                p_tmr->Due = now + p_tmr->Period;               /* ... unless a whole period was missed                 */
+            }
+        }
+        remain = p_tmr->Due - now;
+        if ((next == 0u) || (remain < next)) {
+            next = remain;
+        }
+    }
+
+    if (App_AO_ReportPeriod != 0u) {
+        if ((OS_TICK)(now - App_AO_ReportDue) < 0x80000000u) {
+            App_AO_Report();
+            App_AO_ReportDue = now + App_AO_ReportPeriod;
+        }
+        remain = App_AO_ReportDue - now;
+        if ((next == 0u) || (remain < next)) {
+            next = remain;
+        }
+    }
+
+    return (next);
+}
+
+
+/*
+*********************************************************************************************************
+*                                   App_AO_RdySet() / App_AO_RdyClr()
+*
+* Description : Atomic update of the ready bits (LDREX/STREX, retried if anything wrote them in between).
+*********************************************************************************************************
+*/
+
+static  void  App_AO_RdySet (CPU_INT08U  prio)
+{
+    CPU_INT32U  rdy;
+
+
+    do {
+        rdy = __LDREXW(&App_AO_Rdy);
+    } while (__STREXW(rdy | DEF_BIT(prio), &App_AO_Rdy) != 0u);
+}
+
+
+static  void  App_AO_RdyClr (CPU_INT08U  prio)
+{
+    CPU_INT32U  rdy;
+
+
+    do {
+        rdy = __LDREXW(&App_AO_Rdy);
+    } while (__STREXW(rdy & ~DEF_BIT(prio), &App_AO_Rdy) != 0u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_AO_TS_to_uS()
+*
+* Description : Converts CPU timestamp ticks to microseconds.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_AO_TS_to_uS (CPU_INT64U  ts)
+{
+    if (App_AO_TS_Freq == 0u) {
+        return (0u);
+    }
+    return ((CPU_INT32U)((ts * 1000000u) / App_AO_TS_Freq));
+}
@@ -0,0 +1,153 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Active objects: event-driven state machines that share one uC/OS-III task and its stack. Each object has an
+* event queue and a current state (a handler function); the task takes the next event of the highest priority
+* object that has one and runs the handler to completion. Handlers never block: waiting is done by returning
+* and receiving a later event, e.g. from a time event (APP_AO_TMR).
+*
+* Events are posted from tasks, kernel-aware ISRs and other handlers with App_AO_Post(); the queues are
+* lock-free, a post never masks interrupts. Fast (kernel-unaware) ISRs post through App_IRQ_Defer().
+* The dispatch latency (post to handler) of each object, the shared stack use and the RAM compared to one task
+* per object are printed periodically on the serial port.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_AO_H
+#define  APP_AO_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_AO_TASK_PRIO
+#define  APP_CFG_AO_TASK_PRIO                    (APP_CFG_TASK_START_PRIO + 1u)
+#endif
+
+#ifndef  APP_CFG_AO_TASK_STK_SIZE                               /* Shared by every handler: size for the deepest one.   */
+#define  APP_CFG_AO_TASK_STK_SIZE                512u
+#endif
+
+#ifndef  APP_CFG_AO_MAX                                         /* Objects, also the number of priorities (<= 32).      */
+#define  APP_CFG_AO_MAX                            8u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               SIGNALS
+*
+* Note(s) : (1) Signals below APP_AO_SIG_USER are reserved: APP_AO_SIG_INIT is the first event of every object,
+*               ENTRY/EXIT are sent by App_AO_Tran() to the new/old state.
+*********************************************************************************************************
+*/
+
+#define  APP_AO_SIG_NONE                           0u           /* Marks a free queue slot, never delivered.            */
+#define  APP_AO_SIG_INIT                           1u
+#define  APP_AO_SIG_ENTRY                          2u
+#define  APP_AO_SIG_EXIT                           3u
+#define  APP_AO_SIG_USER                           4u
+
+#define  APP_AO_MS_TO_TICKS(ms)                  ((OS_TICK)((((ms) * OSCfg_TickRate_Hz) + 999u) / 1000u))
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  CPU_INT16U  APP_AO_SIG;
+
+typedef  struct  app_ao_evt {
+    volatile  APP_AO_SIG   Sig;                                 /* Written last by the poster: publishes the slot.      */
+    CPU_INT32U             Par;
+    CPU_TS                 TS;                                  /* Post time.                                           */
+} APP_AO_EVT;
+
+typedef  struct  app_ao  APP_AO;
+
+typedef  void  (*APP_AO_FNCT)(APP_AO            *p_ao,          /* State handler.                                       */
+                              const  APP_AO_EVT *p_evt);
+
+struct  app_ao {                                                /* Embed as the first member of the app's object.       */
+    APP_AO_FNCT            State;
+    CPU_CHAR              *NamePtr;
+    CPU_INT08U             Prio;
+    APP_AO_EVT            *QPtr;
+    CPU_INT16U             QSize;
+    volatile  CPU_INT32U   QHead;                               /* Slots reserved by the posters (free running).        */
+    volatile  CPU_INT32U   QTail;                               /* Slots consumed by the AO task (free running).        */
+    CPU_INT16U             QMax;                                /* Queue high-water mark.                               */
+    CPU_INT32U             DropCtr;                             /* Posts lost on a full queue.                          */
+    CPU_INT32U             DispCtr;
+    CPU_INT64U             LatSum;
+    CPU_TS                 LatMax;
+};
+
+typedef  struct  app_ao_tmr  APP_AO_TMR;
+
+struct  app_ao_tmr {                                            /* Time event: posts Sig to an object when due.         */
+    APP_AO                *AO_Ptr;
+    APP_AO_SIG             Sig;
+    OS_TICK                Due;
+    OS_TICK                Period;                              /* 0 = one-shot.                                        */
+    CPU_BOOLEAN            Armed;
+    CPU_BOOLEAN            Linked;
+    APP_AO_TMR            *NextPtr;
+};
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_AO_Create    (APP_AO       *p_ao,
+                               CPU_CHAR     *p_name,
+                               CPU_INT08U    prio,
+                               APP_AO_FNCT   init,
+                               APP_AO_EVT   *p_q,
+                               CPU_INT16U    q_size);
+
+void         App_AO_Start     (CPU_INT16U    report_period_s);
+
+CPU_BOOLEAN  App_AO_Post      (APP_AO       *p_ao,
+                               APP_AO_SIG    sig,
+                               CPU_INT32U    par);
+
+void         App_AO_Tran      (APP_AO       *p_ao,
+                               APP_AO_FNCT   state);
+
+void         App_AO_TmrArm    (APP_AO_TMR   *p_tmr,
+                               APP_AO       *p_ao,
+                               APP_AO_SIG    sig,
+                               OS_TICK       dly,
+                               OS_TICK       period);
+
+void         App_AO_TmrDisarm (APP_AO_TMR   *p_tmr);
+
+void         App_AO_Report    (void);
+
+#endif
@@ -0,0 +1,624 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Blink engine (hashed timing wheel).
+* Every armed channel is filed under Slot[Expiry % APP_CFG_BLINK_SLOT_NBR] in an unsorted doubly linked list:
+* filing and unfiling are a few pointer writes. Visiting a slot expires the channels whose Expiry is the
+* current wheel tick and leaves those filed for a later turn of the wheel. The next non-empty slot is found in
+* SlotMap with one rotate and one count-leading-zeros, so empty slots are never visited.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_mem.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <board.h>
+
+#include  "app_blink.h"
+#include  "app_intdis.h"
+#include  "app_ledmeter.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_BLINK_SLOT_MASK                    (APP_CFG_BLINK_SLOT_NBR - 1u)
+
+#if (APP_CFG_BLINK_SLOT_NBR == 32u)
+#define  APP_BLINK_MAP_MASK                      DEF_INT_32U_MAX_VAL
+#else
+#define  APP_BLINK_MAP_MASK                     ((1uL << APP_CFG_BLINK_SLOT_NBR) - 1u)
+#endif
+
+#define  APP_BLINK_BENCH_CH_MAX                   64u
+#define  APP_BLINK_BENCH_TICK_MS                  10u
+#define  APP_BLINK_BENCH_S                        10u           /* Simulated time per channel count.                    */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_BLINK     App_Blink_BenchWheel;
+static  APP_BLINK_CH  App_Blink_BenchCh[APP_BLINK_BENCH_CH_MAX];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_Blink_Cur      (APP_BLINK               *p_blink);
+
+static  CPU_INT32U  App_Blink_NextDist (APP_BLINK               *p_blink);
+
+static  void        App_Blink_File     (APP_BLINK               *p_blink,
+                                        APP_BLINK_CH            *p_ch);
+
+static  void        App_Blink_Unfile   (APP_BLINK               *p_blink,
+                                        APP_BLINK_CH            *p_ch);
+
+static  void        App_Blink_Edge     (APP_BLINK_CH            *p_ch,
+                                        CPU_INT32U               t);
+
+static  void        App_Blink_Apply    (APP_BLINK               *p_blink,
+                                        APP_BLINK_CH            *p_ch,
+                                        const APP_BLINK_CH_CFG  *p_cfg,
+                                        CPU_INT32U               t);
+
+static  void        App_Blink_Advance  (APP_BLINK               *p_blink,
+                                        CPU_INT32U               due);
+
+static  void        App_Blink_BenchRun (CPU_INT08U               ch_nbr);
+
+
+/*
+*********************************************************************************************************
+*                                          App_Blink_Init()
+*
+* Description : Initializes an empty wheel.
+*
+* Argument(s) : p_blink     engine to initialize.
+*               tick_ms     wheel tick, in ms: the resolution of the periods and on-times.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Blink_Init (APP_BLINK   *p_blink,
+                      CPU_INT16U   tick_ms)
+{
+    OS_ERR  os_err;
+
+
+    Mem_Clr(p_blink, sizeof(APP_BLINK));
+    p_blink->Tick_ms = tick_ms;
+    p_blink->TickPer = (OS_TICK)((tick_ms * OSCfg_TickRate_Hz) / 1000u);
+    if (p_blink->TickPer == 0u) {
+        p_blink->TickPer = 1u;
+    }
+    p_blink->Idle      = DEF_TRUE;
+    p_blink->Base      = OSTimeGet(&os_err);
+    p_blink->StatStart = p_blink->Base;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Blink_ChInit()
+*
+* Description : Initializes a channel, LED off.
+*
+* Argument(s) : p_ch        channel to initialize.
+*               pin         GPIO pin of the LED, or APP_BLINK_PIN_NONE.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Blink_ChInit (APP_BLINK_CH  *p_ch,
+                        CPU_INT32U     pin)
+{
+    Mem_Clr(p_ch, sizeof(APP_BLINK_CH));
+    p_ch->Pin = pin;
+    if (pin != APP_BLINK_PIN_NONE) {
+        APP_LED_SET(pin);                                       /* setting the pin turns the LED off                    */
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_Blink_ChSet()
+*
+* Description : Changes the blink of a channel. The new pattern starts at once, with an on-time if bit 0 of
+*               the pattern is set; the engine task is woken up if the first edge is earlier than its wake-up.
+*
+* Argument(s) : p_blink     engine.
+*               p_ch        initialized channel.
+*               p_cfg       new blink, see app_blink.h Note #1, or 0 to turn the LED off.
+*
+* Return(s)   : DEF_TRUE if the blink was applied, DEF_FALSE if the configuration is invalid (unchanged).
+*
+* Note(s)     : (1) Task level only.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_Blink_ChSet (APP_BLINK               *p_blink,
+                              APP_BLINK_CH            *p_ch,
+                              const APP_BLINK_CH_CFG  *p_cfg)
+{
+    CPU_BOOLEAN  wake;
+    OS_ERR       os_err;
+    CPU_SR_ALLOC();
+
+
+    if (p_cfg != (APP_BLINK_CH_CFG *)0) {
+        if ((p_cfg->Period_ms == 0u) ||
+            (p_cfg->On_ms      > p_cfg->Period_ms) ||
+           ((p_cfg->Period_ms % p_blink->Tick_ms) != 0u) ||
+           ((p_cfg->On_ms     % p_blink->Tick_ms) != 0u) ||
+            (p_cfg->PatternLen == 0u) ||
+            (p_cfg->PatternLen  > 32u)) {
+            APP_TRACE_DBG(("Blink: invalid configuration.\n\r"));
+            return (DEF_FALSE);
+        }
+    }
+
+    APP_CRITICAL_ENTER();
+    App_Blink_Apply(p_blink, p_ch, p_cfg, App_Blink_Cur(p_blink));
+    wake = DEF_NO;
+    if ((p_ch->Armed     == DEF_YES) &&
+        (p_blink->TCBPtr != (OS_TCB *)0)) {
+        if ((p_blink->Idle == DEF_YES) ||
+            ((CPU_INT32S)(p_ch->Expiry - p_blink->Wake) < 0)) {
+            wake = DEF_YES;
+        }
+    }
+    APP_CRITICAL_EXIT();
+
+    if (wake == DEF_YES) {
+        (void)OSTaskSemPost(p_blink->TCBPtr, OS_OPT_POST_NONE, &os_err);
+    }
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_Blink_Run()
+*
+* Description : Engine task: sleeps until the next edge, drives the LEDs of the expired channels and files
+*               their next edge, forever. Call from the body of a dedicated task.
+*
+* Argument(s) : p_blink     initialized engine.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Wake-ups are absolute wheel ticks converted to kernel ticks, so the time spent in the wheel
+*                   and any preemption do not accumulate into the periods. A late task expires every edge it
+*                   missed, in order.
+*
+*               (2) App_Blink_ChSet() posts the task semaphore when it arms an edge earlier than the wake-up.
+*********************************************************************************************************
+*/
+
+void  App_Blink_Run (APP_BLINK  *p_blink)
+{
+    CPU_INT32U   dist;
+    CPU_INT32U   t0;
+    CPU_INT32U   dt;
+    OS_TICK      dly;
+    CPU_BOOLEAN  pend;
+    OS_ERR       os_err;
+    CPU_SR_ALLOC();
+
+
+    p_blink->TCBPtr = OSTCBCurPtr;
+
+    while (DEF_ON) {
+        APP_CRITICAL_ENTER();
+        dist = App_Blink_NextDist(p_blink);
+        pend = DEF_YES;
+        dly  = 0u;                                              /* Pend forever while every LED is steady.              */
+        if (dist == 0u) {
+            p_blink->Idle = DEF_YES;
+        } else {
+            p_blink->Idle = DEF_NO;
+            p_blink->Wake = p_blink->Now + dist;
+            dly = (p_blink->Base + p_blink->Wake * p_blink->TickPer) - OSTimeGet(&os_err);
+            if ((CPU_INT32S)dly <= 0) {                         /* Late: expire at once.                                */
+                pend = DEF_NO;
+            }
+        }
+        APP_CRITICAL_EXIT();
+
+        if (pend == DEF_YES) {
+            (void)OSTaskSemPend(dly, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
+        }
+
+        t0 = App_TS_Rd32();
+        App_Blink_Advance(p_blink, App_Blink_Cur(p_blink));
+        dt = App_TS_Rd32() - t0;
+
+        APP_CRITICAL_ENTER();
+        p_blink->WakeCtr++;
+        p_blink->CycSum += dt;
+        if (dt > p_blink->CycMax) {
+            p_blink->CycMax = dt;
+        }
+        APP_CRITICAL_EXIT();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Blink_Report()
+*
+* Description : Prints the number of blinking channels, the wake-ups and edges per second and the time spent
+*               in the wheel per wake-up since the previous report, and restarts the measurement window.
+*
+* Argument(s) : p_blink     running engine.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Blink_Report (APP_BLINK  *p_blink)
+{
+    CPU_INT32U  armed;
+    CPU_INT32U  wakes;
+    CPU_INT32U  edges;
+    CPU_INT32U  cyc_sum;
+    CPU_INT32U  cyc_max;
+    CPU_INT32U  window;
+    OS_TICK     now;
+    OS_ERR      os_err;
+    char        tmp[112];
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    now     = OSTimeGet(&os_err);
+    window  = now - p_blink->StatStart;
+    armed   = p_blink->ArmedNbr;
+    wakes   = p_blink->WakeCtr;
+    edges   = p_blink->EdgeCtr;
+    cyc_sum = p_blink->CycSum;
+    cyc_max = p_blink->CycMax;
+    p_blink->WakeCtr   = 0u;
+    p_blink->EdgeCtr   = 0u;
+    p_blink->CycSum    = 0u;
+    p_blink->CycMax    = 0u;
+    p_blink->StatStart = now;
+    APP_CRITICAL_EXIT();
+
+    if (window == 0u) {
+        return;
+    }
+
+    sprintf(tmp, "Blink: %u channels blinking, %u wake-ups/s, %u edges/s, %u cycles per wake-up (max %u)\n\r",
+            (unsigned)armed,
+            (unsigned)(((CPU_INT64U)wakes * OSCfg_TickRate_Hz) / window),
+            (unsigned)(((CPU_INT64U)edges * OSCfg_TickRate_Hz) / window),
+            (unsigned)((wakes == 0u) ? 0u : (cyc_sum / wakes)),
+            (unsigned)cyc_max);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_Blink_Bench()
+*
+* Description : Runs 3, 16 and 64 virtual channels (periods of 100 ms to 1 s, one in four with a pattern) on a
+*               private wheel for APP_BLINK_BENCH_S simulated seconds and prints, for each count, the edges
+*               and wake-ups per second, the CPU cycles spent in the wheel and the RAM, next to the same LEDs
+*               with one task each (one wake-up per edge, one TCB and stack per LED).
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The wheel is advanced directly, one wheel tick at a time: the cycles do not include the
+*                   context switch of a wake-up, which both designs pay, the engine once per wake-up and the
+*                   task per LED once per edge.
+*********************************************************************************************************
+*/
+
+void  App_Blink_Bench (void)
+{
+    char  tmp[96];
+
+
+    App_TS_Init();
+
+    sprintf(tmp, "Blink engine, %u ms wheel tick, %u slots, %u s simulated:\n\r",
+            (unsigned)APP_BLINK_BENCH_TICK_MS, (unsigned)APP_CFG_BLINK_SLOT_NBR, (unsigned)APP_BLINK_BENCH_S);
+    APP_TRACE_DBG(( tmp ));
+    App_Blink_BenchRun( 3u);
+    App_Blink_BenchRun(16u);
+    App_Blink_BenchRun(64u);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/* current wheel tick, from the kernel tick */
+static  CPU_INT32U  App_Blink_Cur (APP_BLINK  *p_blink)
+{
+    OS_ERR  os_err;
+
+
+    return ((OSTimeGet(&os_err) - p_blink->Base) / p_blink->TickPer);
+}
+
+
+/* wheel ticks from Now to the next non-empty slot (1 to APP_CFG_BLINK_SLOT_NBR), 0 if the wheel is empty */
+static  CPU_INT32U  App_Blink_NextDist (APP_BLINK  *p_blink)
+{
+    CPU_INT32U  map;
+    CPU_INT32U  s;
+
+
+    map = p_blink->SlotMap;
+    if (map == 0u) {
+        return (0u);
+    }
+                                                                /* Rotate so that bit 0 is the slot after Now.          */
+    s = (p_blink->Now + 1u) & APP_BLINK_SLOT_MASK;
+    if (s != 0u) {
+        map = ((map >> s) | (map << (APP_CFG_BLINK_SLOT_NBR - s))) & APP_BLINK_MAP_MASK;
+    }
+
+    return ((31u - __CLZ(map & (0u - map))) + 1u);              /* Lowest set bit.                                      */
+}
+
+
+static  void  App_Blink_File (APP_BLINK     *p_blink,
+                              APP_BLINK_CH  *p_ch)
+{
+    CPU_INT32U  ix;
+
+
+    ix            = p_ch->Expiry & APP_BLINK_SLOT_MASK;
+    p_ch->PrevPtr = (APP_BLINK_CH *)0;
+    p_ch->NextPtr = p_blink->Slot[ix];
+    if (p_ch->NextPtr != (APP_BLINK_CH *)0) {
+        p_ch->NextPtr->PrevPtr = p_ch;
+    }
+    p_blink->Slot[ix]  = p_ch;
+    p_blink->SlotMap  |= DEF_BIT(ix);
+    p_ch->Armed        = DEF_YES;
+    p_blink->ArmedNbr++;
+}
+
+
+static  void  App_Blink_Unfile (APP_BLINK     *p_blink,
+                                APP_BLINK_CH  *p_ch)
+{
+    CPU_INT32U  ix;
+
+
+    ix = p_ch->Expiry & APP_BLINK_SLOT_MASK;
+    if (p_ch->PrevPtr != (APP_BLINK_CH *)0) {
+        p_ch->PrevPtr->NextPtr = p_ch->NextPtr;
+    } else {
+        p_blink->Slot[ix] = p_ch->NextPtr;
+        if (p_ch->NextPtr == (APP_BLINK_CH *)0) {
+            p_blink->SlotMap &= ~DEF_BIT(ix);
+        }
+    }
+    if (p_ch->NextPtr != (APP_BLINK_CH *)0) {
+        p_ch->NextPtr->PrevPtr = p_ch->PrevPtr;
+    }
+    p_ch->Armed = DEF_NO;
+    p_blink->ArmedNbr--;
+}
+
+
+/* edge of an unfiled channel at wheel tick 't': drives the LED and sets the time of the next edge */
+static  void  App_Blink_Edge (APP_BLINK_CH  *p_ch,
+                              CPU_INT32U     t)
+{
+    if (p_ch->Lit == DEF_YES) {                                 /* End of the on-time.                                  */
+        p_ch->Lit    = DEF_NO;
+        p_ch->Expiry = t + (p_ch->Period - p_ch->On);
+        if (p_ch->Pin != APP_BLINK_PIN_NONE) {
+            APP_LED_SET(p_ch->Pin);
+        }
+    } else if ((p_ch->Pattern & DEF_BIT(p_ch->PatternIx)) != 0u) {
+        p_ch->Lit    = DEF_YES;                                 /* Start of a lit period.                               */
+        p_ch->Expiry = t + p_ch->On;
+        if (p_ch->Pin != APP_BLINK_PIN_NONE) {
+            APP_LED_CLR(p_ch->Pin);                             /* clearing the pin turns the LED on                    */
+        }
+    } else {
+        p_ch->Expiry = t + p_ch->Period;                        /* Dark period: one edge only.                          */
+    }
+
+    if (p_ch->Lit == DEF_NO) {                                  /* The next edge starts a period.                       */
+        p_ch->PatternIx++;
+        if (p_ch->PatternIx >= p_ch->PatternLen) {
+            p_ch->PatternIx = 0u;
+        }
+    }
+}
+
+
+/* applies a configuration at wheel tick 't', in a critical section */
+static  void  App_Blink_Apply (APP_BLINK               *p_blink,
+                               APP_BLINK_CH            *p_ch,
+                               const APP_BLINK_CH_CFG  *p_cfg,
+                               CPU_INT32U               t)
+{
+    if (p_ch->Armed == DEF_YES) {
+        App_Blink_Unfile(p_blink, p_ch);
+    }
+
+    p_ch->Lit = DEF_NO;
+    if ((p_cfg == (APP_BLINK_CH_CFG *)0) || (p_cfg->On_ms == 0u)) {
+        if (p_ch->Pin != APP_BLINK_PIN_NONE) {
+            APP_LED_SET(p_ch->Pin);
+        }
+        return;
+    }
+    if (p_cfg->On_ms == p_cfg->Period_ms) {                     /* Steady: not in the wheel.                            */
+        p_ch->Lit = DEF_YES;
+        if (p_ch->Pin != APP_BLINK_PIN_NONE) {
+            APP_LED_CLR(p_ch->Pin);
+        }
+        return;
+    }
+
+    p_ch->Period     = p_cfg->Period_ms / p_blink->Tick_ms;
+    p_ch->On         = p_cfg->On_ms     / p_blink->Tick_ms;
+    p_ch->Pattern    = p_cfg->Pattern;
+    p_ch->PatternLen = p_cfg->PatternLen;
+    p_ch->PatternIx  = 0u;
+
+    App_Blink_Edge(p_ch, t);                                    /* First period starts now.                             */
+    App_Blink_File(p_blink, p_ch);
+}
+
+
+/* expires, in order, the edges of the non-empty slots up to wheel tick 'due' */
+static  void  App_Blink_Advance (APP_BLINK   *p_blink,
+                                 CPU_INT32U   due)
+{
+    APP_BLINK_CH  *p_ch;
+    APP_BLINK_CH  *p_next;
+    CPU_INT32U     dist;
+    CPU_SR_ALLOC();
+
+
+    while ((CPU_INT32S)(due - p_blink->Now) > 0) {
+        APP_CRITICAL_ENTER();                                   /* One slot per critical section.                       */
+        dist = App_Blink_NextDist(p_blink);
+        if ((dist == 0u) ||
+            ((CPU_INT32S)(due - (p_blink->Now + dist)) < 0)) {
+            p_blink->Now = due;
+            APP_CRITICAL_EXIT();
+            break;
+        }
+        p_blink->Now += dist;
+
+        p_ch = p_blink->Slot[p_blink->Now & APP_BLINK_SLOT_MASK];
+        while (p_ch != (APP_BLINK_CH *)0) {
+            p_next = p_ch->NextPtr;
+            if (p_ch->Expiry == p_blink->Now) {                 /* Others are filed for a later turn.                   */
+                App_Blink_Unfile(p_blink, p_ch);
+                App_Blink_Edge(p_ch, p_blink->Now);
+                App_Blink_File(p_blink, p_ch);                  /* In front of the list: not visited again.             */
+                p_blink->EdgeCtr++;
+            }
+            p_ch = p_next;
+        }
+        APP_CRITICAL_EXIT();
+    }
+}
+
+
+/* one line of App_Blink_Bench(): 'ch_nbr' virtual channels on the private wheel */
+static  void  App_Blink_BenchRun (CPU_INT08U  ch_nbr)
+{
+    APP_BLINK         *p_blink;
+    APP_BLINK_CH_CFG   cfg;
+    CPU_INT32U         ticks;
+    CPU_INT32U         t;
+    CPU_INT32U         t0;
+    CPU_INT32U         dt;
+    CPU_INT32U         edges;
+    CPU_INT32U         wakes;
+    CPU_INT32U         cyc_sum;
+    CPU_INT32U         cyc_max;
+    CPU_INT32U         ram_wheel;
+    CPU_INT32U         ram_tasks;
+    CPU_INT16U         period;
+    CPU_INT08U         i;
+    char               tmp[128];
+    CPU_SR_ALLOC();
+
+
+    p_blink = &App_Blink_BenchWheel;
+    App_Blink_Init(p_blink, APP_BLINK_BENCH_TICK_MS);
+    for (i = 0u; i < ch_nbr; i++) {
+        period         = (CPU_INT16U)(10u + ((i * 7u) % 91u));  /* 100 ms to 1 s, spread over the slots.                */
+        cfg.Period_ms  = period * APP_BLINK_BENCH_TICK_MS;
+        cfg.On_ms      = (period / 2u) * APP_BLINK_BENCH_TICK_MS;
+        cfg.Pattern    = ((i & 3u) == 3u) ? 0x5u : 0x1u;        /* Double flash, then two dark periods.                 */
+        cfg.PatternLen = ((i & 3u) == 3u) ?   4u :   1u;
+        App_Blink_ChInit(&App_Blink_BenchCh[i], APP_BLINK_PIN_NONE);
+        APP_CRITICAL_ENTER();
+        App_Blink_Apply(p_blink, &App_Blink_BenchCh[i], &cfg, 0u);
+        APP_CRITICAL_EXIT();
+    }
+
+    ticks   = (APP_BLINK_BENCH_S * 1000u) / APP_BLINK_BENCH_TICK_MS;
+    edges   = 0u;
+    wakes   = 0u;
+    cyc_sum = 0u;
+    cyc_max = 0u;
+    for (t = 1u; t <= ticks; t++) {
+        p_blink->EdgeCtr = 0u;
+        t0 = App_TS_Rd32();
+        App_Blink_Advance(p_blink, t);
+        dt = App_TS_Rd32() - t0;
+        if (p_blink->EdgeCtr != 0u) {                           /* The engine task would have woken up.                 */
+            edges   += p_blink->EdgeCtr;
+            wakes++;
+            cyc_sum += dt;
+            if (dt > cyc_max) {
+                cyc_max = dt;
+            }
+        }
+    }
+
+    ram_wheel = sizeof(APP_BLINK) + ch_nbr * sizeof(APP_BLINK_CH)
+              + sizeof(OS_TCB)    + APP_CFG_TASK_START_STK_SIZE * sizeof(CPU_STK);
+    ram_tasks = ch_nbr * (sizeof(OS_TCB) + APP_CFG_TASK_START_STK_SIZE * sizeof(CPU_STK));
+
+    sprintf(tmp, "  %2u channels: %4u edges/s, %3u wake-ups/s (task per LED: %4u), RAM %5u bytes (task per LED: %6u)\n\r",
+            (unsigned)ch_nbr,
+            (unsigned)(edges / APP_BLINK_BENCH_S),
+            (unsigned)(wakes / APP_BLINK_BENCH_S),
+            (unsigned)(edges / APP_BLINK_BENCH_S),
+            (unsigned)ram_wheel,
+            (unsigned)ram_tasks);
+    APP_TRACE_DBG(( tmp ));
+    sprintf(tmp, "               wheel %u cycles per wake-up (max %u), %u cycles per edge\n\r",
+            (unsigned)((wakes == 0u) ? 0u : (cyc_sum / wakes)),
+            (unsigned)cyc_max,
+            (unsigned)((edges == 0u) ? 0u : (cyc_sum / edges)));
+    APP_TRACE_DBG(( tmp ));
+}
@@ -0,0 +1,127 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Blink engine: any number of LED channels, each with its own period, on-time and pattern, driven by a single
+* task instead of one task (stack, TCB and two context switches per period) per LED. The on and off edges of
+* all the channels are kept in one hashed timing wheel: a channel is filed under the slot of its next edge
+* (edge time modulo the number of slots), so arming and expiring an edge are O(1) whatever the number of
+* channels. A bitmap of the non-empty slots lets the task sleep straight to the next edge: it wakes up only
+* when an LED changes, and never while all the LEDs are steady.
+*
+* App_Blink_Bench() prints the cost of the engine at 3, 16 and 64 virtual channels.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_BLINK_H
+#define  APP_BLINK_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_BLINK_SLOT_NBR
+#define  APP_CFG_BLINK_SLOT_NBR                   32u           /* Wheel slots: power of 2, at most 32 (one bit each).  */
+#endif
+
+#define  APP_BLINK_PIN_NONE                      DEF_INT_32U_MAX_VAL   /* Virtual channel: edges only, no pin.     */
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*
+* Note(s) : (1) A channel lights its LED for On_ms at the start of every period whose bit is set in Pattern,
+*               bit 0 first, and starts again at bit 0 after PatternLen periods. Pattern 1 and PatternLen 1
+*               is a plain blink. On_ms 0 keeps the LED off and On_ms equal to Period_ms keeps it on: a steady
+*               channel is not in the wheel.
+*
+*           (2) Channels are allocated by the caller and owned by the engine while they blink.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_blink_ch_cfg {
+    CPU_INT16U   Period_ms;                                     /* Multiple of the wheel tick.                          */
+    CPU_INT16U   On_ms;                                         /* Multiple of the wheel tick, see Note #1.             */
+    CPU_INT32U   Pattern;
+    CPU_INT08U   PatternLen;                                    /* 1 to 32 periods.                                     */
+} APP_BLINK_CH_CFG;
+
+typedef  struct  app_blink_ch  APP_BLINK_CH;
+
+struct  app_blink_ch {
+    APP_BLINK_CH  *NextPtr;                                     /* Channels filed under the same slot.                  */
+    APP_BLINK_CH  *PrevPtr;
+    CPU_INT32U     Expiry;                                      /* Wheel tick of the next edge.                         */
+    CPU_INT32U     Pin;                                         /* LED pin (active low) or APP_BLINK_PIN_NONE.          */
+    CPU_INT32U     Period;                                      /* Wheel ticks.                                         */
+    CPU_INT32U     On;
+    CPU_INT32U     Pattern;
+    CPU_INT08U     PatternLen;
+    CPU_INT08U     PatternIx;                                   /* Period of the pattern in progress.                   */
+    CPU_BOOLEAN    Lit;
+    CPU_BOOLEAN    Armed;                                       /* Filed in the wheel.                                  */
+};
+
+typedef  struct  app_blink {
+    APP_BLINK_CH  *Slot[APP_CFG_BLINK_SLOT_NBR];
+    CPU_INT32U     SlotMap;                                     /* Bit n set: Slot[n] is not empty.                     */
+    CPU_INT32U     Now;                                         /* Last wheel tick processed.                           */
+    CPU_INT32U     Wake;                                        /* Wheel tick the task sleeps until.                    */
+    CPU_BOOLEAN    Idle;                                        /* Task sleeps until a channel is armed.                */
+    OS_TICK        Base;                                        /* Kernel tick of wheel tick 0.                         */
+    OS_TICK        TickPer;                                     /* Kernel ticks per wheel tick.                         */
+    CPU_INT16U     Tick_ms;
+    OS_TCB        *TCBPtr;                                      /* Task running App_Blink_Run().                        */
+    CPU_INT32U     ArmedNbr;                                    /* Channels in the wheel.                               */
+
+    CPU_INT32U     WakeCtr;                                     /* Statistics since the previous report.                */
+    CPU_INT32U     EdgeCtr;
+    CPU_INT32U     CycSum;                                      /* CPU cycles spent in the wheel per wake-up.           */
+    CPU_INT32U     CycMax;
+    OS_TICK        StatStart;
+} APP_BLINK;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_Blink_Init   (APP_BLINK               *p_blink,
+                               CPU_INT16U               tick_ms);
+
+void         App_Blink_ChInit (APP_BLINK_CH            *p_ch,
+                               CPU_INT32U               pin);
+
+CPU_BOOLEAN  App_Blink_ChSet  (APP_BLINK               *p_blink,
+                               APP_BLINK_CH            *p_ch,
+                               const APP_BLINK_CH_CFG  *p_cfg);
+
+void         App_Blink_Run    (APP_BLINK               *p_blink);
+
+void         App_Blink_Report (APP_BLINK               *p_blink);
+
+void         App_Blink_Bench  (void);
+
+#endif
@@ -0,0 +1,456 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Switch debounce engine.
+* App_Debounce_Edge() (PORT ISR) masks the pin interrupt and arms a settle countdown; PIT1 runs at 1 kHz only
+* while at least one switch is settling. Every sample that differs from the previous one restarts the countdown
+* (and is counted as a bounce); when the countdown expires the pin interrupt is enabled again and, if the
+* stable level differs from the last delivered one, the app callback is called. An edge storm therefore costs
+* one PORT interrupt per switch action plus one PIT interrupt per millisecond of settling.
+*
+* The PORT digital filter (1 kHz LPO, APP_CFG_DEBOUNCE_DFILT_WIDTH cycles) may also be enabled per pin: it
+* removes the shortest glitches before they reach the PORT interrupt logic. The filter settings are shared by
+* all the pins of a port.
+*
+* PIT1 stops in VLPS/LLS: a settling switch holds the app_lowpwr stop lock.
+* The switches are registered with the app_portisr dispatcher, which calls App_Debounce_Edge() for them. The
+* edge path is in SRAM with the dispatcher (app_ramfunc.h); the PIT path runs once per millisecond and is not.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  "fsl_interrupt_manager.h"
+#include  "fsl_clock_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <system_MK64F12.h>
+#include  <board.h>
+#include  <fsl_gpio_common.h>
+
+#include  "app_debounce.h"
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_pin.h"
+#include  "app_portisr.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_DEBOUNCE_PIT_CH                       1u
+#define  APP_DEBOUNCE_PIT_IRQn                   PIT1_IRQn
+#define  APP_DEBOUNCE_SAMPLE_HZ                 1000u
+
+#define  APP_DEBOUNCE_IRQC_DIS                     0x0u         /* PORT_PCR[IRQC] encodings                             */
+#define  APP_DEBOUNCE_IRQC_EITHER                  0xBu
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_debounce_ch {
+    CPU_INT32U          Pin;
+    CPU_CHAR           *NamePtr;
+    PORT_Type          *PortPtr;
+    CPU_INT32U          PinIx;                                  /* Pin number within the port.                          */
+    APP_DEBOUNCE_FNCT   Fnct;
+    void               *ArgPtr;
+    CPU_INT32U          Stable;                                 /* Last delivered level.                                */
+    CPU_INT32U          Last;                                   /* Last sampled level.                                  */
+    CPU_INT16U          Cnt;                                    /* Settle countdown in ms, 0 when not settling.         */
+    CPU_INT32U          RawCtr;                                 /* Edges that reached the PORT ISR.                     */
+    CPU_INT32U          BounceCtr;                              /* Level changes sampled while settling.                */
+    CPU_INT32U          DeliverCtr;                             /* Levels passed to the callback.                       */
+} APP_DEBOUNCE_CH;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_DEBOUNCE_CH  App_Debounce_Ch[APP_CFG_DEBOUNCE_CH_MAX];
+static  CPU_INT08U       App_Debounce_ChNbr;
+static  CPU_INT16U       App_Debounce_ReportPeriod_s;
+
+static  OS_TCB           App_Debounce_TaskTCB;
+static  CPU_STK          App_Debounce_TaskStk[APP_CFG_DEBOUNCE_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void              App_Debounce_Task    (void             *p_arg);
+
+APP_RAMFUNC  static  APP_DEBOUNCE_CH  *App_Debounce_ChFind  (CPU_INT32U        pin);
+
+APP_RAMFUNC  static  void              App_Debounce_IntSet  (APP_DEBOUNCE_CH  *p_ch,
+                                                             CPU_INT32U        irqc);
+
+static  void              App_Debounce_PIT_ISR (void);
+
+APP_RAMFUNC  static  void              App_Debounce_PortISR (CPU_INT32U        pin,
+                                                             void             *p_arg);
+
+
+/*
+*********************************************************************************************************
+*                                         App_Debounce_Init()
+*
+* Description : Sets up PIT1 as the 1 kHz sampling clock (stopped until the first edge). Call after OSA_Init()
+*               and before App_Debounce_ChAdd().
+*
+* Argument(s) : report_period_s     interval between two edge count reports, in seconds (0 = no report task).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Debounce_Init (CPU_INT16U  report_period_s)
+{
+    OS_ERR  os_err;
+
+
+    App_Debounce_ReportPeriod_s = report_period_s;
+
+    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT->MCR   &= ~PIT_MCR_MDIS_MASK;                           /* Other PIT channels may already be in use             */
+    PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].TCTRL = 0u;
+    PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].LDVAL = (CLOCK_SYS_GetBusClockFreq() / APP_DEBOUNCE_SAMPLE_HZ) - 1u;
+    PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].TFLG  = PIT_TFLG_TIF_MASK;
+
+    INT_SYS_InstallHandler(APP_DEBOUNCE_PIT_IRQn, App_Debounce_PIT_ISR);
+    INT_SYS_EnableIRQ(APP_DEBOUNCE_PIT_IRQn);
+
+    if (report_period_s == 0u) {
+        return;
+    }
+
+    OSTaskCreate(&App_Debounce_TaskTCB,
+                 "Debounce report",
+                  App_Debounce_Task,
+                  0u,
+                  APP_CFG_DEBOUNCE_TASK_PRIO,
+                 &App_Debounce_TaskStk[0u],
+                 (APP_CFG_DEBOUNCE_TASK_STK_SIZE / 10u),
+                  APP_CFG_DEBOUNCE_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Debounce_ChAdd()
+*
+* Description : Registers a switch. The pin is set to interrupt on either edge, whatever "gpio_pins.c" says,
+*               since releases must be seen as well to track the level, and its edges are routed to
+*               App_Debounce_Edge() through the PORT dispatcher. Call after OSA_Init().
+*
+* Argument(s) : pin         GPIO pin of the switch.
+*               p_name      name printed in the report.
+*               dfilt_en    DEF_TRUE to also enable the PORT digital filter on the pin.
+*               fnct        callback, called with each debounced level change.
+*               p_arg       argument passed to the callback.
+*
+* Return(s)   : DEF_FALSE if APP_CFG_DEBOUNCE_CH_MAX switches are already registered, DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_Debounce_ChAdd (CPU_INT32U          pin,
+                                 CPU_CHAR           *p_name,
+                                 CPU_BOOLEAN         dfilt_en,
+                                 APP_DEBOUNCE_FNCT   fnct,
+                                 void               *p_arg)
+{
+    APP_DEBOUNCE_CH  *p_ch;
+    CPU_SR_ALLOC();
+
+
+    if (App_Debounce_ChNbr >= APP_CFG_DEBOUNCE_CH_MAX) {
+        return (DEF_FALSE);
+    }
+
+    p_ch           = &App_Debounce_Ch[App_Debounce_ChNbr];
+    p_ch->Pin      = pin;
+    p_ch->NamePtr  = p_name;
+    p_ch->PortPtr  = (PORT_Type *)g_portBaseAddr[GPIO_EXTRACT_PORT(pin)];
+    p_ch->PinIx    = GPIO_EXTRACT_PIN(pin);
+    p_ch->Fnct     = fnct;
+    p_ch->ArgPtr   = p_arg;
+    p_ch->Stable   = GPIO_DRV_ReadPinInput(pin);
+    p_ch->Last     = p_ch->Stable;
+    p_ch->Cnt      = 0u;
+
+    if (dfilt_en == DEF_TRUE) {
+        p_ch->PortPtr->DFCR  = PORT_DFCR_CS_MASK;               /* LPO clock, also runs in stop modes                   */
+        p_ch->PortPtr->DFWR  = PORT_DFWR_FILT(APP_CFG_DEBOUNCE_DFILT_WIDTH);
+        p_ch->PortPtr->DFER |= (1u << p_ch->PinIx);
+    }
+
+    APP_CRITICAL_ENTER();
+    App_Debounce_IntSet(p_ch, APP_DEBOUNCE_IRQC_EITHER);
+    App_Debounce_ChNbr++;
+    APP_CRITICAL_EXIT();
+
+    App_PortISR_Set(pin, App_Debounce_PortISR, (void *)0);
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Debounce_Edge()
+*
+* Description : Called by the PORT ISR when the interrupt flag of a registered switch is set. Clears the
+*               flag, masks the pin interrupt and starts the settle window.
+*
+* Argument(s) : pin         GPIO pin of the switch.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  void  App_Debounce_Edge (CPU_INT32U  pin)
+{
+    APP_DEBOUNCE_CH  *p_ch;
+    CPU_INT32U        basepri;
+
+
+    p_ch = App_Debounce_ChFind(pin);
+    if (p_ch == (APP_DEBOUNCE_CH *)0) {
+        APP_PIN_INT_CLR(pin);
+        return;
+    }
+
+    APP_IRQ_KA_MASK(basepri);                                   /* Whole path in SRAM, see app_irq.h                    */
+    p_ch->RawCtr++;
+    App_Debounce_IntSet(p_ch, APP_DEBOUNCE_IRQC_DIS);           /* Mask the pin and clear its flag                      */
+    p_ch->Last = APP_PIN_RD(pin);
+    if (p_ch->Cnt == 0u) {
+        App_LowPwr_StopLock();                                  /* Released when the switch has settled                 */
+    }
+    p_ch->Cnt  = APP_CFG_DEBOUNCE_SETTLE_MS;
+    PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+    APP_IRQ_KA_UNMASK(basepri);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_Debounce_Report()
+*
+* Description : Prints raw, bounce and delivered edge counts of every switch since the previous report, then
+*               restarts the counts.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Debounce_Report (void)
+{
+    APP_DEBOUNCE_CH  *p_ch;
+    CPU_INT32U        raw;
+    CPU_INT32U        bounce;
+    CPU_INT32U        deliver;
+    CPU_INT08U        i;
+    char              tmp[96];
+    CPU_SR_ALLOC();
+
+
+    for (i = 0u; i < App_Debounce_ChNbr; i++) {
+        p_ch = &App_Debounce_Ch[i];
+
+        APP_CRITICAL_ENTER();
+        raw              = p_ch->RawCtr;
+        bounce           = p_ch->BounceCtr;
+        deliver          = p_ch->DeliverCtr;
+        p_ch->RawCtr     = 0u;
+        p_ch->BounceCtr  = 0u;
+        p_ch->DeliverCtr = 0u;
+        APP_CRITICAL_EXIT();
+
+        sprintf(tmp, "%-6.6s: %u raw edges, %u bounces sampled, %u delivered\n\r",
+                p_ch->NamePtr,
+                (unsigned)raw,
+                (unsigned)bounce,
+                (unsigned)deliver);
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_Debounce_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_Debounce_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_Debounce_Report();
+    }
+}
+
+
+APP_RAMFUNC  static  APP_DEBOUNCE_CH  *App_Debounce_ChFind (CPU_INT32U  pin)
+{
+    CPU_INT08U  i;
+
+
+    for (i = 0u; i < App_Debounce_ChNbr; i++) {
+        if (App_Debounce_Ch[i].Pin == pin) {
+            return (&App_Debounce_Ch[i]);
+        }
+    }
+    return ((APP_DEBOUNCE_CH *)0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_Debounce_IntSet()
+*
+* Description : Sets the interrupt configuration of the pin and clears its interrupt flag (write-1-to-clear).
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void  App_Debounce_IntSet (APP_DEBOUNCE_CH  *p_ch,
+                                                CPU_INT32U        irqc)
+{
+    CPU_INT32U  pcr;
+
+
+    pcr = p_ch->PortPtr->PCR[p_ch->PinIx] & ~(PORT_PCR_IRQC_MASK | PORT_PCR_ISF_MASK);
+    p_ch->PortPtr->PCR[p_ch->PinIx] = pcr | PORT_PCR_IRQC(irqc) | PORT_PCR_ISF_MASK;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_Debounce_PortISR()
+*
+* Description : app_portisr handler of the registered switches.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void  App_Debounce_PortISR (CPU_INT32U   pin,
+                                                 void        *p_arg)
+{
+    (void)p_arg;
+
+    App_Debounce_Edge(pin);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_Debounce_PIT_ISR()
+*
+* Description : 1 kHz sampling of the settling switches. A level that does not change for the whole window is
+*               final: the pin interrupt is enabled again and a level change is delivered. The pin is sampled
+*               once more after unmasking so that a change in between is not lost.
+*********************************************************************************************************
+*/
+
+static  void  App_Debounce_PIT_ISR (void)
+{
+    APP_DEBOUNCE_CH  *p_ch;
+    CPU_INT32U        level;
+    CPU_INT08U        active;
+    CPU_INT08U        i;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    OSIntEnter();
+    APP_CRITICAL_EXIT();
+
+    PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].TFLG = PIT_TFLG_TIF_MASK;
+
+    active = 0u;
+    for (i = 0u; i < App_Debounce_ChNbr; i++) {
+        p_ch = &App_Debounce_Ch[i];
+        if (p_ch->Cnt == 0u) {
+            continue;
+        }
+
+        level = GPIO_DRV_ReadPinInput(p_ch->Pin);
+        if (level != p_ch->Last) {                              /* Still bouncing: restart the window                   */
+            p_ch->Last = level;
+            p_ch->Cnt  = APP_CFG_DEBOUNCE_SETTLE_MS;
+            p_ch->BounceCtr++;
+            active++;
+            continue;
+        }
+
+        p_ch->Cnt--;
+        if (p_ch->Cnt > 0u) {
+            active++;
+            continue;
+        }
+
+        App_Debounce_IntSet(p_ch, APP_DEBOUNCE_IRQC_EITHER);    /* Settled                                              */
+        if (GPIO_DRV_ReadPinInput(p_ch->Pin) != level) {        /* Changed again before the unmask: settle once more    */
+            App_Debounce_IntSet(p_ch, APP_DEBOUNCE_IRQC_DIS);
+            p_ch->Last = level ^ 1u;
+            p_ch->Cnt  = APP_CFG_DEBOUNCE_SETTLE_MS;
+            active++;
+        } else {
+            App_LowPwr_StopUnlock();
+        }
+        if (level != p_ch->Stable) {
+            p_ch->Stable = level;
+            p_ch->DeliverCtr++;
+            if (p_ch->Fnct != (APP_DEBOUNCE_FNCT)0) {
+                p_ch->Fnct(p_ch->Pin, level, p_ch->ArgPtr);
+            }
+        }
+    }
+
+    if (active == 0u) {                                         /* Nothing settling: stop sampling                      */
+        PIT->CHANNEL[APP_DEBOUNCE_PIT_CH].TCTRL = 0u;
+    }
+
+    OSIntExit();
+}
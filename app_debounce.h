@@ -0,0 +1,97 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Switch debounce engine: the first edge on a switch masks its pin interrupt and starts a settle window timed
+* by PIT1; the pin is sampled every millisecond and only a level that stayed stable for the whole window, and
+* differs from the last delivered one, is passed to the app callback. Raw versus delivered edge counts are
+* printed periodically on the serial port.
+*
+* The switch edges reach App_Debounce_Edge() through app_portisr.c: apps do not install their own PORT ISR
+* for a registered switch.
+* Needs app_lowpwr.c (stop lock while settling) unless APP_CFG_LOWPWR_EN is DEF_DISABLED.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_DEBOUNCE_H
+#define  APP_DEBOUNCE_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_DEBOUNCE_CH_MAX
+#define  APP_CFG_DEBOUNCE_CH_MAX                   4u
+#endif
+
+#ifndef  APP_CFG_DEBOUNCE_SETTLE_MS                             /* Stable time required before delivering a level.      */
+#define  APP_CFG_DEBOUNCE_SETTLE_MS               10u
+#endif
+
+#ifndef  APP_CFG_DEBOUNCE_DFILT_WIDTH                           /* PORT digital filter width, in LPO (1 kHz) cycles.    */
+#define  APP_CFG_DEBOUNCE_DFILT_WIDTH              2u
+#endif
+
+#ifndef  APP_CFG_DEBOUNCE_TASK_PRIO
+#define  APP_CFG_DEBOUNCE_TASK_PRIO              (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_DEBOUNCE_TASK_STK_SIZE
+#define  APP_CFG_DEBOUNCE_TASK_STK_SIZE          256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+                                                                /* Called from the PIT1 ISR (between OSIntEnter() and   */
+                                                                /* OSIntExit()), so it may post to kernel objects.      */
+typedef  void  (*APP_DEBOUNCE_FNCT)(CPU_INT32U   pin,
+                                    CPU_INT32U   level,         /* Pin level: 0 = pressed for the board switches.       */
+                                    void        *p_arg);
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_Debounce_Init   (CPU_INT16U          report_period_s);
+
+CPU_BOOLEAN  App_Debounce_ChAdd  (CPU_INT32U          pin,
+                                  CPU_CHAR           *p_name,
+                                  CPU_BOOLEAN         dfilt_en,
+                                  APP_DEBOUNCE_FNCT   fnct,
+                                  void               *p_arg);
+
+APP_RAMFUNC                                                     /* In SRAM with the PORT dispatcher, see app_ramfunc.h  */
+void         App_Debounce_Edge   (CPU_INT32U          pin);
+
+void         App_Debounce_Report (void);
+
+#endif
@@ -0,0 +1,450 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Frequency counter.
+* LPTMR0 counts continuously and is never stopped or reset: a gate is the difference between two samples, so
+* no edge is lost between gates. Its 16-bit counter is extended in software by the overflow interrupt (once
+* per 65536 edges). Each sample is timestamped with the CPU timestamp timer and the frequency is computed over
+* the measured time between two samples, not the nominal gate: the PIT2 interrupt latency does not add to the
+* error, which is +/- 1 edge per gate.
+*
+* PIT2 and LPTMR0 share the timer priority (app_irq.c) and do not preempt each other. The sample reads the
+* overflow flag itself, so that an overflow whose interrupt is still pending is counted exactly once.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#ifndef  APP_FREQCNT_HOST                                       /* Stand-ins of app_freqcnt_host.h otherwise            */
+#include  "fsl_interrupt_manager.h"
+#include  "fsl_clock_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+#endif
+
+#include  "app_freqcnt.h"
+#ifndef  APP_FREQCNT_HOST
+#include  "app_intdis.h"
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_FREQCNT_PIT_CH                        2u
+#define  APP_FREQCNT_PIT_IRQn                    PIT2_IRQn
+
+#define  APP_FREQCNT_LPTMR_PCS_OSCERCLK            3u           /* LPTMR_PSR[PCS] encoding                              */
+#define  APP_FREQCNT_LPTMR_TPS_PTC5                2u           /* LPTMR_CSR[TPS]: LPTMR0_ALT2                          */
+#define  APP_FREQCNT_PTC5_MUX_LPTMR                3u           /* PTC5 ALT3                                            */
+
+#ifndef  APP_FREQCNT_TCF_CLR
+#define  APP_FREQCNT_TCF_CLR()                   (LPTMR0->CSR |= LPTMR_CSR_TCF_MASK)
+#endif
+
+#ifndef  APP_FREQCNT_CNR_LATCH                                  /* CNR reads the value latched by a write               */
+#define  APP_FREQCNT_CNR_LATCH()                 (LPTMR0->CNR = 0u)
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U       App_FreqCnt_OvfCtr;                    /* Counter wraps, LPTMR0/PIT2 ISRs only.                */
+static  CPU_BOOLEAN      App_FreqCnt_PrevValid;
+static  CPU_INT64U       App_FreqCnt_PrevCnt;
+static  CPU_TS_TMR       App_FreqCnt_PrevTS;
+
+static  CPU_INT32U       App_FreqCnt_GateCtr;                   /* Since the previous report, in critical sections.     */
+static  CPU_INT64U       App_FreqCnt_CntSum;
+static  CPU_INT64U       App_FreqCnt_TS_Sum;
+static  CPU_INT32U       App_FreqCnt_FreqMin;
+static  CPU_INT32U       App_FreqCnt_FreqMax;
+static  CPU_INT32U       App_FreqCnt_FreqLast;
+static  CPU_INT32U       App_FreqCnt_FreqPeak;                  /* Highest gate frequency ever measured.                */
+static  CPU_INT32U       App_FreqCnt_OvfCtrPrev;                /* Report task only.                                    */
+
+static  CPU_INT16U       App_FreqCnt_GateMs;
+static  CPU_TS_TMR_FREQ  App_FreqCnt_TS_Freq;
+static  CPU_INT16U       App_FreqCnt_ReportPeriod_s;
+
+static  OS_TCB           App_FreqCnt_TaskTCB;
+static  CPU_STK          App_FreqCnt_TaskStk[APP_CFG_FREQCNT_TASK_STK_SIZE];
+
+#ifdef  APP_FREQCNT_HOST
+CPU_TS_TMR               App_FreqCnt_HostTS;
+APP_FREQCNT_HOST_LPTMR   App_FreqCnt_HostLPTMR;
+APP_FREQCNT_HOST_PIT     App_FreqCnt_HostPIT;
+APP_FREQCNT_HOST_SIM     App_FreqCnt_HostSIM;
+APP_FREQCNT_HOST_OSC     App_FreqCnt_HostOSC;
+APP_FREQCNT_HOST_PORT    App_FreqCnt_HostPORTC;
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         App_FreqCnt_Task     (void  *p_arg);
+
+static  void         App_FreqCnt_GateISR  (void);
+
+static  void         App_FreqCnt_OvfISR   (void);
+
+static  CPU_BOOLEAN  App_FreqCnt_OvfChk   (void);
+
+static  CPU_INT64U   App_FreqCnt_CntRd    (void);
+
+
+/*
+*********************************************************************************************************
+*                                         App_FreqCnt_Init()
+*
+* Description : Starts LPTMR0 counting the rising edges on PTC5 and PIT2 sampling the count every gate.
+*               Call after App_IRQ_Init() and CPU_Init() (timestamps).
+*
+* Argument(s) : gate_ms             gate window, in ms (resolution 1000 / gate_ms Hz, at most 30 s).
+*
+*               report_period_s     interval between two reports, in seconds (0 = no report task, the app
+*                                   calls App_FreqCnt_Report() itself).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_FreqCnt_Init (CPU_INT16U  gate_ms,
+                        CPU_INT16U  report_period_s)
+{
+    CPU_ERR  cpu_err;
+    OS_ERR   os_err;
+
+
+    App_FreqCnt_GateMs         = gate_ms;
+    App_FreqCnt_ReportPeriod_s = report_period_s;
+    App_FreqCnt_TS_Freq        = CPU_TS_TmrFreqGet(&cpu_err);
+    App_FreqCnt_FreqMin        = DEF_INT_32U_MAX_VAL;
+
+    SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK | SIM_SCGC5_PORTC_MASK;
+    OSC->CR    |= OSC_CR_ERCLKEN_MASK;                          /* LPTMR clock, see APP_CFG_FREQCNT_CLK_HZ              */
+    PORTC->PCR[5u] = PORT_PCR_MUX(APP_FREQCNT_PTC5_MUX_LPTMR);
+
+    LPTMR0->CSR = 0u;                                           /* Stop and reset the counter                           */
+    LPTMR0->PSR = LPTMR_PSR_PCS(APP_FREQCNT_LPTMR_PCS_OSCERCLK)
+                | LPTMR_PSR_PBYP_MASK;                          /* No glitch filter: every rising edge                  */
+    LPTMR0->CMR = 0xFFFFu;                                      /* Compare flag on every wrap                           */
+    LPTMR0->CSR = LPTMR_CSR_TMS_MASK                            /* Pulse counter ...                                    */
+                | LPTMR_CSR_TFC_MASK                            /* ... free running ...                                 */
+                | LPTMR_CSR_TPS(APP_FREQCNT_LPTMR_TPS_PTC5)       /* ... on PTC5                                          */
+                | LPTMR_CSR_TIE_MASK;
+    INT_SYS_InstallHandler(LPTMR0_IRQn, App_FreqCnt_OvfISR);
+    INT_SYS_EnableIRQ(LPTMR0_IRQn);
+    LPTMR0->CSR |= LPTMR_CSR_TEN_MASK;
+
+    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT->MCR   &= ~PIT_MCR_MDIS_MASK;                           /* Other PIT channels may already be in use             */
+    PIT->CHANNEL[APP_FREQCNT_PIT_CH].TCTRL = 0u;
+    PIT->CHANNEL[APP_FREQCNT_PIT_CH].LDVAL = (CLOCK_SYS_GetBusClockFreq() / 1000u) * gate_ms - 1u;
+    PIT->CHANNEL[APP_FREQCNT_PIT_CH].TFLG  = PIT_TFLG_TIF_MASK;
+    INT_SYS_InstallHandler(APP_FREQCNT_PIT_IRQn, App_FreqCnt_GateISR);
+    INT_SYS_EnableIRQ(APP_FREQCNT_PIT_IRQn);
+    PIT->CHANNEL[APP_FREQCNT_PIT_CH].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+
+    if (report_period_s == 0u) {
+        return;
+    }
+
+    OSTaskCreate(&App_FreqCnt_TaskTCB,
+                 "Freq. counter",
+                  App_FreqCnt_Task,
+                  0u,
+                  APP_CFG_FREQCNT_TASK_PRIO,
+                 &App_FreqCnt_TaskStk[0u],
+                 (APP_CFG_FREQCNT_TASK_STK_SIZE / 10u),
+                  APP_CFG_FREQCNT_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_FreqCnt_Get()
+*
+* Description : Returns the frequency measured over the last complete gate, in Hz.
+*
+* Argument(s) : none.
+*
+* Return(s)   : frequency, 0 before the first gate.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  App_FreqCnt_Get (void)
+{
+    return (App_FreqCnt_FreqLast);                              /* Single word write in the ISR                         */
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_FreqCnt_Report()
+*
+* Description : Prints the mean frequency since the previous report with the gate min/max, the resolution,
+*               the maximum measurable rate and the interrupts taken, then restarts the statistics.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_FreqCnt_Report (void)
+{
+    CPU_INT32U  gate_ctr;
+    CPU_INT64U  cnt_sum;
+    CPU_INT64U  ts_sum;
+    CPU_INT32U  freq_min;
+    CPU_INT32U  freq_max;
+    CPU_INT32U  freq_peak;
+    CPU_INT32U  ovf_ctr;
+    CPU_INT64U  cnt_ts;
+    CPU_INT32U  freq_Hz;
+    CPU_INT32U  freq_frac;
+    char        tmp[128];
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    gate_ctr  = App_FreqCnt_GateCtr;
+    cnt_sum   = App_FreqCnt_CntSum;
+    ts_sum    = App_FreqCnt_TS_Sum;
+    freq_min  = App_FreqCnt_FreqMin;
+    freq_max  = App_FreqCnt_FreqMax;
+    freq_peak = App_FreqCnt_FreqPeak;
+    ovf_ctr   = App_FreqCnt_OvfCtr;
+    App_FreqCnt_GateCtr = 0u;
+    App_FreqCnt_CntSum  = 0u;
+    App_FreqCnt_TS_Sum  = 0u;
+    App_FreqCnt_FreqMin = DEF_INT_32U_MAX_VAL;
+    App_FreqCnt_FreqMax = 0u;
+    APP_CRITICAL_EXIT();
+
+    if (gate_ctr == 0u) {
+        APP_TRACE_DBG(( "Freq. : no complete gate\n\r" ));
+    } else {
+        cnt_ts    = cnt_sum * App_FreqCnt_TS_Freq;
+        freq_Hz   = (CPU_INT32U)(cnt_ts / ts_sum);
+        freq_frac = (CPU_INT32U)(((cnt_ts % ts_sum) * 1000u) / ts_sum);
+        sprintf(tmp, "Freq. : %u.%03u Hz (gate min %u Hz, max %u Hz), %u gates of %u ms, resolution %u Hz per gate\n\r",
+                (unsigned)freq_Hz,
+                (unsigned)freq_frac,
+                (unsigned)freq_min,
+                (unsigned)freq_max,
+                (unsigned)gate_ctr,
+                (unsigned)App_FreqCnt_GateMs,
+                (unsigned)(1000u / App_FreqCnt_GateMs));
+        APP_TRACE_DBG(( tmp ));
+    }
+
+    sprintf(tmp, "        max measurable %u Hz, highest seen %u Hz, %u overflow interrupts\n\r",
+            (unsigned)APP_FREQCNT_MAX_HZ,
+            (unsigned)freq_peak,
+            (unsigned)(ovf_ctr - App_FreqCnt_OvfCtrPrev));
+    APP_TRACE_DBG(( tmp ));
+    App_FreqCnt_OvfCtrPrev = ovf_ctr;
+}
+
+
+/*
+*********************************************************************************************************
+*                                     HOST STAND-IN (app_freqcnt_host.h)
+*********************************************************************************************************
+*/
+
+#ifdef  APP_FREQCNT_HOST
+void  App_FreqCnt_HostEdges (CPU_INT32U  nbr)
+{
+    CPU_INT32U  step;
+
+
+    if ((LPTMR0->CSR & LPTMR_CSR_TEN_MASK) == 0u) {
+        return;
+    }
+    while (nbr > 0u) {
+        step          = DEF_MIN(nbr, 0x10000u - LPTMR0->CNR);
+        LPTMR0->CNR  += step;
+        nbr          -= step;
+        if (LPTMR0->CNR == 0x10000u) {                          /* Wrap: compare flag, then its interrupt               */
+            LPTMR0->CNR  = 0u;
+            LPTMR0->CSR |= LPTMR_CSR_TCF_MASK;
+            if ((LPTMR0->CSR & LPTMR_CSR_TIE_MASK) != 0u) {
+                App_FreqCnt_OvfISR();
+            }
+        }
+    }
+}
+
+
+void  App_FreqCnt_HostGate (void)
+{
+    if ((PIT->CHANNEL[APP_FREQCNT_PIT_CH].TCTRL & PIT_TCTRL_TEN_MASK) != 0u) {
+        PIT->CHANNEL[APP_FREQCNT_PIT_CH].TFLG = PIT_TFLG_TIF_MASK;
+        App_FreqCnt_GateISR();
+    }
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_FreqCnt_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_FreqCnt_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_FreqCnt_Report();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_FreqCnt_GateISR()
+*
+* Description : End of a gate (PIT2): samples the count and computes the gate frequency. No kernel call.
+*********************************************************************************************************
+*/
+
+static  void  App_FreqCnt_GateISR (void)
+{
+    CPU_TS_TMR  ts;
+    CPU_INT64U  cnt;
+    CPU_INT64U  cnt_gate;
+    CPU_TS_TMR  ts_gate;
+    CPU_INT32U  freq;
+    CPU_SR_ALLOC();
+
+
+    ts  = CPU_TS_TmrRd();                                       /* Timestamp and count as close as possible             */
+    cnt = App_FreqCnt_CntRd();
+    PIT->CHANNEL[APP_FREQCNT_PIT_CH].TFLG = PIT_TFLG_TIF_MASK;
+
+    if (App_FreqCnt_PrevValid != DEF_YES) {                     /* First sample: no gate yet                            */
+        App_FreqCnt_PrevValid = DEF_YES;
+        App_FreqCnt_PrevCnt   = cnt;
+        App_FreqCnt_PrevTS    = ts;
+        return;
+    }
+    cnt_gate            = cnt - App_FreqCnt_PrevCnt;
+    ts_gate             = ts  - App_FreqCnt_PrevTS;
+    App_FreqCnt_PrevCnt = cnt;
+    App_FreqCnt_PrevTS  = ts;
+    if (ts_gate == 0u) {
+        return;
+    }
+    freq = (CPU_INT32U)((cnt_gate * App_FreqCnt_TS_Freq) / ts_gate);
+
+    APP_CRITICAL_ENTER();
+    App_FreqCnt_GateCtr++;
+    App_FreqCnt_CntSum   += cnt_gate;
+    App_FreqCnt_TS_Sum   += ts_gate;
+    App_FreqCnt_FreqMin   = DEF_MIN(App_FreqCnt_FreqMin,  freq);
+    App_FreqCnt_FreqMax   = DEF_MAX(App_FreqCnt_FreqMax,  freq);
+    App_FreqCnt_FreqPeak  = DEF_MAX(App_FreqCnt_FreqPeak, freq);
+    App_FreqCnt_FreqLast  = freq;
+    APP_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_FreqCnt_OvfISR()
+*
+* Description : LPTMR0 wrap. Nothing to do if the gate sample has already counted it.
+*********************************************************************************************************
+*/
+
+static  void  App_FreqCnt_OvfISR (void)
+{
+    (void)App_FreqCnt_OvfChk();
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_FreqCnt_OvfChk()
+*
+* Description : Counts and clears a pending counter wrap.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_FreqCnt_OvfChk (void)
+{
+    if ((LPTMR0->CSR & LPTMR_CSR_TCF_MASK) == 0u) {
+        return (DEF_NO);
+    }
+    APP_FREQCNT_TCF_CLR();
+    App_FreqCnt_OvfCtr++;
+    return (DEF_YES);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_FreqCnt_CntRd()
+*
+* Description : Returns the edges counted since App_FreqCnt_Init(): wraps and counter register. A wrap seen
+*               after the register read may have come before or after it: the register is read again.
+*********************************************************************************************************
+*/
+
+static  CPU_INT64U  App_FreqCnt_CntRd (void)
+{
+    CPU_INT32U  cnr;
+
+
+    (void)App_FreqCnt_OvfChk();
+    APP_FREQCNT_CNR_LATCH();
+    cnr = LPTMR0->CNR & 0xFFFFu;
+    if (App_FreqCnt_OvfChk() == DEF_YES) {
+        APP_FREQCNT_CNR_LATCH();
+        cnr = LPTMR0->CNR & 0xFFFFu;
+    }
+
+    return (((CPU_INT64U)App_FreqCnt_OvfCtr << 16u) | cnr);
+}
@@ -0,0 +1,86 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Frequency counter: LPTMR0 in pulse counter mode counts the rising edges of a pin input in hardware and PIT2
+* samples the count at the end of every gate window. The CPU only runs once per gate and once per 65536 edges
+* (counter overflow), whatever the input rate, where per-edge interrupts would saturate it in the tens of kHz.
+* The frequency of each gate (min/max/mean), the resolution and the maximum measurable rate are printed
+* periodically on the serial port.
+*
+* The LPTMR pulse inputs are not on PTB9: wire the signal to PTC5 (LPTMR0_ALT2). LPTMR0 and PIT2 are used
+* exclusively (not with app_sonar.c, which times the echo with LPTMR0).
+*
+* Built with APP_FREQCNT_HOST defined, app_freqcnt.c runs on a host against the stand-ins of app_freqcnt_host.h:
+* tools/freqcnt_host.c feeds it edges and gates and checks the measured frequencies.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_FREQCNT_H
+#define  APP_FREQCNT_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#ifdef   APP_FREQCNT_HOST
+#include  "app_freqcnt_host.h"
+#else
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_FREQCNT_CLK_HZ                                 /* OSCERCLK: 50 MHz from the PHY on the FRDM-K64F.      */
+#define  APP_CFG_FREQCNT_CLK_HZ             50000000u
+#endif
+
+#ifndef  APP_CFG_FREQCNT_TASK_PRIO
+#define  APP_CFG_FREQCNT_TASK_PRIO               (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_FREQCNT_TASK_STK_SIZE
+#define  APP_CFG_FREQCNT_TASK_STK_SIZE           256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+                                                                /* Rising edges are counted in the LPTMR clock domain:  */
+                                                                /* above half of it, edges can be missed.               */
+#define  APP_FREQCNT_MAX_HZ                      (APP_CFG_FREQCNT_CLK_HZ / 2u)
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void        App_FreqCnt_Init   (CPU_INT16U   gate_ms,
+                                CPU_INT16U   report_period_s);
+
+CPU_INT32U  App_FreqCnt_Get    (void);
+
+void        App_FreqCnt_Report (void);
+
+#endif
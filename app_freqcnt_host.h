@@ -0,0 +1,198 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Host stand-in for app_freqcnt.c, included by app_freqcnt.h instead of the KSDK, uC/CPU and uC/OS-III headers
+* when APP_FREQCNT_HOST is defined; tools/freqcnt_host.c is the host program. The registers (LPTMR0, PIT, SIM,
+* OSC, PORTC) are plain memory: the host program plays the hardware with App_FreqCnt_HostEdges() (input edges,
+* with the counter wrap and its interrupt) and App_FreqCnt_HostGate() (end of a gate window), between which it
+* advances App_FreqCnt_HostTS, the CPU timestamp seen by the module. Vector installation, clock gating, pin
+* muxing and the report task have no effect; critical sections are empty (no interrupt on the host).
+*********************************************************************************************************
+*/
+
+#ifndef  APP_FREQCNT_HOST_H
+#define  APP_FREQCNT_HOST_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdint.h>
+#include  <stdio.h>
+
+
+/*
+*********************************************************************************************************
+*                                     uC/CPU AND uC/LIB STAND-INS
+*********************************************************************************************************
+*/
+
+typedef  uint8_t   CPU_INT08U;
+typedef  uint16_t  CPU_INT16U;
+typedef  uint32_t  CPU_INT32U;
+typedef  uint64_t  CPU_INT64U;
+typedef  uint8_t   CPU_BOOLEAN;
+typedef  char      CPU_CHAR;
+typedef  uint32_t  CPU_STK;
+typedef  uint32_t  CPU_TS_TMR;
+typedef  uint32_t  CPU_TS_TMR_FREQ;
+typedef  int       CPU_ERR;
+
+#define  DEF_NO                                    0u
+#define  DEF_YES                                   1u
+#define  DEF_FALSE                                 0u
+#define  DEF_TRUE                                  1u
+#define  DEF_ON                                    1u
+#define  DEF_INT_32U_MAX_VAL              4294967295u
+#define  DEF_MIN(a, b)                           (((a) < (b)) ? (a) : (b))
+#define  DEF_MAX(a, b)                           (((a) > (b)) ? (a) : (b))
+
+#define  CPU_ERR_NONE                              0
+
+#ifndef  APP_FREQCNT_HOST_TS_HZ                                 /* Core clock of the target, CPU timestamp rate.        */
+#define  APP_FREQCNT_HOST_TS_HZ            120000000u
+#endif
+
+extern  CPU_TS_TMR  App_FreqCnt_HostTS;
+
+#define  CPU_TS_TmrRd()                          App_FreqCnt_HostTS
+#define  CPU_TS_TmrFreqGet(p_err)               (*(p_err) = CPU_ERR_NONE, (CPU_TS_TMR_FREQ)APP_FREQCNT_HOST_TS_HZ)
+
+#define  CPU_SR_ALLOC()
+#define  APP_CRITICAL_ENTER()
+#define  APP_CRITICAL_EXIT()
+
+
+/*
+*********************************************************************************************************
+*                                        uC/OS-III STAND-INS
+*********************************************************************************************************
+*/
+
+typedef  int  OS_ERR;
+typedef  struct  os_tcb { int  Unused; } OS_TCB;
+
+#define  OS_ERR_NONE                               0
+#define  OS_CFG_PRIO_MAX                          64u
+
+#define  APP_TRACE_DBG(x)                        printf x
+
+#define  OSTaskCreate(p_tcb, p_name, p_task, p_arg, prio, p_stk_base, stk_limit, stk_size,                \
+                      q_size, quanta, p_ext, opt, p_err)                                                \
+                                                ((void)(p_tcb), (void)(p_task), (void)(p_stk_base),     \
+                                                 *(p_err) = OS_ERR_NONE)
+#define  OSTimeDlyHMSM(h, m, s, ms, opt, p_err)  (*(p_err) = OS_ERR_NONE)
+
+
+/*
+*********************************************************************************************************
+*                                          REGISTER STAND-INS
+*
+* Note(s) : (1) LPTMR0->CNR is the counter itself: on the target a write latches it for the next read, here
+*               APP_FREQCNT_CNR_LATCH() does nothing and TCF is cleared by APP_FREQCNT_TCF_CLR() instead of a
+*               write of 1.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_freqcnt_host_lptmr {
+    CPU_INT32U  CSR;
+    CPU_INT32U  PSR;
+    CPU_INT32U  CMR;
+    CPU_INT32U  CNR;
+} APP_FREQCNT_HOST_LPTMR;
+
+typedef  struct  app_freqcnt_host_pit_ch {
+    CPU_INT32U  LDVAL;
+    CPU_INT32U  CVAL;
+    CPU_INT32U  TCTRL;
+    CPU_INT32U  TFLG;
+} APP_FREQCNT_HOST_PIT_CH;
+
+typedef  struct  app_freqcnt_host_pit {
+    CPU_INT32U               MCR;
+    APP_FREQCNT_HOST_PIT_CH  CHANNEL[4];
+} APP_FREQCNT_HOST_PIT;
+
+typedef  struct  app_freqcnt_host_sim {
+    CPU_INT32U  SCGC5;
+    CPU_INT32U  SCGC6;
+} APP_FREQCNT_HOST_SIM;
+
+typedef  struct  app_freqcnt_host_osc {
+    CPU_INT08U  CR;
+} APP_FREQCNT_HOST_OSC;
+
+typedef  struct  app_freqcnt_host_port {
+    CPU_INT32U  PCR[32];
+} APP_FREQCNT_HOST_PORT;
+
+extern  APP_FREQCNT_HOST_LPTMR  App_FreqCnt_HostLPTMR;
+extern  APP_FREQCNT_HOST_PIT    App_FreqCnt_HostPIT;
+extern  APP_FREQCNT_HOST_SIM    App_FreqCnt_HostSIM;
+extern  APP_FREQCNT_HOST_OSC    App_FreqCnt_HostOSC;
+extern  APP_FREQCNT_HOST_PORT   App_FreqCnt_HostPORTC;
+
+#define  LPTMR0                                  (&App_FreqCnt_HostLPTMR)
+#define  PIT                                     (&App_FreqCnt_HostPIT)
+#define  SIM                                     (&App_FreqCnt_HostSIM)
+#define  OSC                                     (&App_FreqCnt_HostOSC)
+#define  PORTC                                   (&App_FreqCnt_HostPORTC)
+
+#define  LPTMR_CSR_TEN_MASK                      0x01u          /* Bit fields, as in MK64F12.h                          */
+#define  LPTMR_CSR_TMS_MASK                      0x02u
+#define  LPTMR_CSR_TFC_MASK                      0x04u
+#define  LPTMR_CSR_TPP_MASK                      0x08u
+#define  LPTMR_CSR_TPS(x)                       (((CPU_INT32U)(x) << 4u) & 0x30u)
+#define  LPTMR_CSR_TIE_MASK                      0x40u
+#define  LPTMR_CSR_TCF_MASK                      0x80u
+#define  LPTMR_PSR_PCS(x)                        ((CPU_INT32U)(x) & 0x03u)
+#define  LPTMR_PSR_PBYP_MASK                     0x04u
+#define  PIT_MCR_MDIS_MASK                       0x02u
+#define  PIT_TCTRL_TEN_MASK                      0x01u
+#define  PIT_TCTRL_TIE_MASK                      0x02u
+#define  PIT_TFLG_TIF_MASK                       0x01u
+#define  SIM_SCGC5_LPTMR_MASK                    0x01u
+#define  SIM_SCGC5_PORTC_MASK                    0x800u
+#define  SIM_SCGC6_PIT_MASK                      0x800000u
+#define  OSC_CR_ERCLKEN_MASK                     0x80u
+#define  PORT_PCR_MUX(x)                        (((CPU_INT32U)(x) << 8u) & 0x700u)
+
+#define  APP_FREQCNT_TCF_CLR()                   (LPTMR0->CSR &= ~LPTMR_CSR_TCF_MASK)
+#define  APP_FREQCNT_CNR_LATCH()
+
+
+/*
+*********************************************************************************************************
+*                                         KSDK/CMSIS STAND-INS
+*********************************************************************************************************
+*/
+
+#ifndef  APP_FREQCNT_HOST_BUS_HZ
+#define  APP_FREQCNT_HOST_BUS_HZ            60000000u
+#endif
+
+#define  CLOCK_SYS_GetBusClockFreq()             APP_FREQCNT_HOST_BUS_HZ
+#define  INT_SYS_InstallHandler(irq, isr)        (void)(isr)
+#define  INT_SYS_EnableIRQ(irq)
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  App_FreqCnt_HostEdges (CPU_INT32U  nbr);                  /* 'nbr' rising edges on the input.                     */
+
+void  App_FreqCnt_HostGate  (void);                             /* PIT2 expiry: end of the gate window.                 */
+
+#endif
@@ -0,0 +1,430 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Microsecond timer service.
+* The queue is a singly linked list sorted by deadline, the earliest first: the ISR only ever looks at the
+* head, insertion walks the list (a few timers in these apps). Deadlines are compared by signed difference, so
+* the cycle counter may wrap; delays and periods are limited to half a wrap (17 s at 120 MHz).
+*
+* The queue is changed in critical sections, by the tasks and by the ISR, which releases it around each
+* callback: a callback may start or stop any timer, including its own.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  "fsl_interrupt_manager.h"
+#include  "fsl_clock_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+
+#include  "app_hrtmr.h"
+#include  "app_intdis.h"
+#include  "app_lowpwr.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_HRTMR_PIT_CH                          0u
+#define  APP_HRTMR_PIT_IRQn                      PIT0_IRQn
+
+#define  APP_HRTMR_CNTS_MAX                      0x7FFFFFFFu    /* Half a cycle counter wrap.                           */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_HRTMR    *App_HRTmr_HeadPtr;                        /* Earliest deadline.                                   */
+static  CPU_BOOLEAN   App_HRTmr_Locked;                         /* Stop lock held (queue not empty).                    */
+
+static  CPU_INT32U    App_HRTmr_CntsPerUs;                      /* Cycle counter counts per us.                         */
+static  CPU_INT32U    App_HRTmr_SpinCnts;
+static  CPU_INT64U    App_HRTmr_BusQ16;                         /* PIT (bus) clocks per count, 16 fractional bits.      */
+
+static  CPU_INT32U    App_HRTmr_FireCtr;                        /* Since the previous report.                           */
+static  CPU_INT32U    App_HRTmr_LateMax;                        /* Counts from the deadline to the callback.            */
+static  CPU_INT32U    App_HRTmr_OverrunCtr;                     /* Periods skipped by late periodic timers.             */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  App_HRTmr_Insert  (APP_HRTMR  *p_tmr);
+
+static  void  App_HRTmr_Unlink  (APP_HRTMR  *p_tmr);
+
+static  void  App_HRTmr_Arm     (void);
+
+static  void  App_HRTmr_LockUpd (void);
+
+static  void  App_HRTmr_ISR     (void);
+
+
+/*
+*********************************************************************************************************
+*                                           App_HRTmr_Init()
+*
+* Description : Sets up PIT0 and its interrupt. Call after App_IRQ_Init() and CPU_Init(), before any timer is
+*               started.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_HRTmr_Init (void)
+{
+    App_TS_Init();
+
+    App_HRTmr_CntsPerUs = App_TS_Freq / 1000000u;
+    App_HRTmr_SpinCnts  = APP_CFG_HRTMR_SPIN_US * App_HRTmr_CntsPerUs;
+    App_HRTmr_BusQ16    = ((CPU_INT64U)CLOCK_SYS_GetBusClockFreq() << 16u) / App_TS_Freq;
+
+    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT->MCR   &= ~PIT_MCR_MDIS_MASK;                           /* Other PIT channels may already be in use             */
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TCTRL = 0u;
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TFLG  = PIT_TFLG_TIF_MASK;
+
+    INT_SYS_InstallHandler(APP_HRTMR_PIT_IRQn, App_HRTmr_ISR);
+    INT_SYS_EnableIRQ(APP_HRTMR_PIT_IRQn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_HRTmr_Start()
+*
+* Description : Starts (or restarts) a timer. From a task or a kernel-aware ISR, not from a fast ISR.
+*
+* Argument(s) : p_tmr       timer, owned by the service until it expires (one-shot) or is stopped.
+*               delay_us    delay to the first callback, 0 for as soon as possible.
+*               period_us   period of the next callbacks, at least APP_CFG_HRTMR_PERIOD_MIN_US, or 0 for a
+*                           one-shot timer.
+*               fnct        callback, called in the PIT0 ISR.
+*               p_arg       argument passed to the callback.
+*
+* Return(s)   : DEF_FALSE if an argument is out of range (the timer is then unchanged), DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_HRTmr_Start (APP_HRTMR       *p_tmr,
+                              CPU_INT32U       delay_us,
+                              CPU_INT32U       period_us,
+                              APP_HRTMR_FNCT   fnct,
+                              void            *p_arg)
+{
+    CPU_INT32U  max_us;
+    CPU_SR_ALLOC();
+
+
+    max_us = APP_HRTMR_CNTS_MAX / App_HRTmr_CntsPerUs;
+    if ((fnct      == (APP_HRTMR_FNCT)0) ||
+        (delay_us  >  max_us)            ||
+        (period_us >  max_us)            ||
+        ((period_us != 0u) && (period_us < APP_CFG_HRTMR_PERIOD_MIN_US))) {
+        return (DEF_FALSE);
+    }
+
+    APP_CRITICAL_ENTER();
+    if (p_tmr->Active == DEF_YES) {
+        App_HRTmr_Unlink(p_tmr);
+    }
+    p_tmr->Period   = period_us * App_HRTmr_CntsPerUs;
+    p_tmr->Fnct     = fnct;
+    p_tmr->ArgPtr   = p_arg;
+    p_tmr->Deadline = App_TS_Rd32() + (delay_us * App_HRTmr_CntsPerUs);
+    App_HRTmr_Insert(p_tmr);
+    if (App_HRTmr_HeadPtr == p_tmr) {                           /* New earliest deadline                                */
+        App_HRTmr_Arm();
+    }
+    App_HRTmr_LockUpd();
+    APP_CRITICAL_EXIT();
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_HRTmr_Stop()
+*
+* Description : Stops a timer: its callback is not called any more.
+*
+* Argument(s) : p_tmr       timer.
+*
+* Return(s)   : DEF_TRUE if the timer was active, DEF_FALSE if it had expired or was never started.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_HRTmr_Stop (APP_HRTMR  *p_tmr)
+{
+    CPU_BOOLEAN  active;
+    CPU_BOOLEAN  head;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    active = p_tmr->Active;
+    if (active == DEF_YES) {
+        head = (App_HRTmr_HeadPtr == p_tmr) ? DEF_YES : DEF_NO;
+        App_HRTmr_Unlink(p_tmr);
+        if (head == DEF_YES) {
+            App_HRTmr_Arm();
+        }
+        App_HRTmr_LockUpd();
+    }
+    APP_CRITICAL_EXIT();
+
+    return (active);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_HRTmr_IsActive()
+*
+* Description : Tells whether a timer is still queued.
+*
+* Argument(s) : p_tmr       timer.
+*
+* Return(s)   : DEF_YES until a one-shot timer has called back or any timer is stopped, DEF_NO otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_HRTmr_IsActive (APP_HRTMR  *p_tmr)
+{
+    return (p_tmr->Active);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_HRTmr_Report()
+*
+* Description : Prints the callbacks, the worst lateness and the skipped periods since the previous report,
+*               then restarts the counts.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_HRTmr_Report (void)
+{
+    CPU_INT32U  fire_ctr;
+    CPU_INT32U  late_max;
+    CPU_INT32U  overrun_ctr;
+    char        tmp[80];
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    fire_ctr             = App_HRTmr_FireCtr;
+    late_max             = App_HRTmr_LateMax;
+    overrun_ctr          = App_HRTmr_OverrunCtr;
+    App_HRTmr_FireCtr    = 0u;
+    App_HRTmr_LateMax    = 0u;
+    App_HRTmr_OverrunCtr = 0u;
+    APP_CRITICAL_EXIT();
+
+    sprintf(tmp, "HR timers: %u callbacks, max late %u ns, %u periods skipped\n\r",
+            (unsigned)fire_ctr,
+            (unsigned)App_TS_to_nS(late_max),
+            (unsigned)overrun_ctr);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*
+* Note(s) : (1) App_HRTmr_Insert(), _Unlink(), _Arm() and _LockUpd() are called in a critical section.
+*********************************************************************************************************
+*/
+
+static  void  App_HRTmr_Insert (APP_HRTMR  *p_tmr)
+{
+    APP_HRTMR  **pp_next;
+
+
+    pp_next = &App_HRTmr_HeadPtr;                               /* After the timers due at the same time or earlier     */
+    while ((*pp_next != (APP_HRTMR *)0) &&
+           ((CPU_INT32S)((*pp_next)->Deadline - p_tmr->Deadline) <= 0)) {
+        pp_next = &(*pp_next)->NextPtr;
+    }
+    p_tmr->NextPtr = *pp_next;
+    *pp_next       =  p_tmr;
+    p_tmr->Active  =  DEF_YES;
+}
+
+
+static  void  App_HRTmr_Unlink (APP_HRTMR  *p_tmr)
+{
+    APP_HRTMR  **pp_next;
+
+
+    pp_next = &App_HRTmr_HeadPtr;
+    while (*pp_next != (APP_HRTMR *)0) {
+        if (*pp_next == p_tmr) {
+            *pp_next = p_tmr->NextPtr;
+            break;
+        }
+        pp_next = &(*pp_next)->NextPtr;
+    }
+    p_tmr->NextPtr = (APP_HRTMR *)0;
+    p_tmr->Active  =  DEF_NO;
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_HRTmr_Arm()
+*
+* Description : Loads PIT0 with the delay to the head deadline, or stops it if the queue is empty. A deadline
+*               already passed gets the shortest load (one bus clock).
+*
+* Note(s)     : (1) The flag is cleared before the channel is enabled again, not after: an immediate expiry
+*                   is then never lost. A stale pending interrupt only costs an empty ISR run.
+*********************************************************************************************************
+*/
+
+static  void  App_HRTmr_Arm (void)
+{
+    CPU_INT32S  dt;
+    CPU_INT32U  ldval;
+
+
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TCTRL = 0u;
+    if (App_HRTmr_HeadPtr == (APP_HRTMR *)0) {
+        return;
+    }
+
+    dt    = (CPU_INT32S)(App_HRTmr_HeadPtr->Deadline - App_TS_Rd32());
+    ldval = 0u;
+    if (dt > 0) {
+        ldval = (CPU_INT32U)(((CPU_INT64U)dt * App_HRTmr_BusQ16) >> 16u);
+        if (ldval > 0u) {
+            ldval--;                                            /* The PIT counts LDVAL + 1 clocks                      */
+        }
+    }
+
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TFLG  = PIT_TFLG_TIF_MASK;   /* See Note #1                                          */
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].LDVAL = ldval;
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+}
+
+
+static  void  App_HRTmr_LockUpd (void)
+{
+    if ((App_HRTmr_HeadPtr != (APP_HRTMR *)0) && (App_HRTmr_Locked == DEF_NO)) {
+        App_HRTmr_Locked = DEF_YES;
+        App_LowPwr_StopLock();
+    } else if ((App_HRTmr_HeadPtr == (APP_HRTMR *)0) && (App_HRTmr_Locked == DEF_YES)) {
+        App_HRTmr_Locked = DEF_NO;
+        App_LowPwr_StopUnlock();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_HRTmr_ISR()
+*
+* Description : Calls back every timer due, waiting for the ones due within APP_CFG_HRTMR_SPIN_US, then loads
+*               PIT0 for the next deadline.
+*
+* Note(s)     : (1) A periodic timer more than one period late skips the missed periods: its next deadline
+*                   is one period from now.
+*********************************************************************************************************
+*/
+
+static  void  App_HRTmr_ISR (void)
+{
+    APP_HRTMR       *p_tmr;
+    APP_HRTMR_FNCT   fnct;
+    void            *p_arg;
+    CPU_INT32U       now;
+    CPU_INT32U       late;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    OSIntEnter();
+    APP_CRITICAL_EXIT();
+
+    PIT->CHANNEL[APP_HRTMR_PIT_CH].TFLG = PIT_TFLG_TIF_MASK;
+
+    APP_CRITICAL_ENTER();
+    p_tmr = App_HRTmr_HeadPtr;
+    while (p_tmr != (APP_HRTMR *)0) {
+        if ((CPU_INT32S)(p_tmr->Deadline - App_TS_Rd32()) > (CPU_INT32S)App_HRTmr_SpinCnts) {
+            break;
+        }
+        do {                                                    /* Close enough: wait rather than re-arm                */
+            now = App_TS_Rd32();
+        } while ((CPU_INT32S)(p_tmr->Deadline - now) > 0);
+
+        late = now - p_tmr->Deadline;
+        if (late > App_HRTmr_LateMax) {
+            App_HRTmr_LateMax = late;
+        }
+        App_HRTmr_FireCtr++;
+
+        App_HRTmr_HeadPtr = p_tmr->NextPtr;
+        if (p_tmr->Period != 0u) {
+            p_tmr->Deadline += p_tmr->Period;
+            if ((CPU_INT32S)(p_tmr->Deadline - now) < 0) {      /* See Note #1                                          */
+                p_tmr->Deadline = now + p_tmr->Period;
+                App_HRTmr_OverrunCtr++;
+            }
+            App_HRTmr_Insert(p_tmr);
+        } else {
+            p_tmr->NextPtr = (APP_HRTMR *)0;
+            p_tmr->Active  =  DEF_NO;
+        }
+
+        fnct  = p_tmr->Fnct;
+        p_arg = p_tmr->ArgPtr;
+        APP_CRITICAL_EXIT();
+        fnct(p_tmr, p_arg);
+        APP_CRITICAL_ENTER();
+
+        p_tmr = App_HRTmr_HeadPtr;
+    }
+    App_HRTmr_Arm();
+    App_HRTmr_LockUpd();
+    APP_CRITICAL_EXIT();
+
+    OSIntExit();
+}
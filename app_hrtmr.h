@@ -0,0 +1,96 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Microsecond timers: one-shot and periodic callbacks below the tick resolution, e.g. the 10 us trigger pulse
+* of the HC-SR04, without blocking the caller. All the timers share PIT0: they are kept in a queue sorted by
+* deadline and PIT0 is loaded, one shot at a time, with the delay to the earliest one. Deadlines are cycle
+* counter values (app_ts.h), so a periodic timer does not drift with the interrupt latency.
+*
+* The callbacks run in the PIT0 ISR (kernel-aware): they may post to kernel objects and must be short. A
+* deadline closer than APP_CFG_HRTMR_SPIN_US to the previous one is waited for in the ISR instead of being
+* re-armed, so that close deadlines are not delayed by a second interrupt entry.
+*
+* PIT0 stops in VLPS/LLS: an armed timer holds the app_lowpwr stop lock.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_HRTMR_H
+#define  APP_HRTMR_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_HRTMR_SPIN_US                                  /* About the cost of an interrupt entry and re-arm.     */
+#define  APP_CFG_HRTMR_SPIN_US                     2u
+#endif
+
+#ifndef  APP_CFG_HRTMR_PERIOD_MIN_US                            /* Shorter periods would keep the ISR running.          */
+#define  APP_CFG_HRTMR_PERIOD_MIN_US              20u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*
+* Note(s) : (1) Allocated by the caller, like an OS_TMR, and owned by the service while it is active.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_hrtmr  APP_HRTMR;
+
+typedef  void  (*APP_HRTMR_FNCT)(APP_HRTMR  *p_tmr,
+                                 void       *p_arg);
+
+struct  app_hrtmr {
+    APP_HRTMR       *NextPtr;                                   /* Next deadline in the queue.                          */
+    CPU_INT32U       Deadline;                                  /* Cycle counter value.                                 */
+    CPU_INT32U       Period;                                    /* Cycles, 0 for a one-shot timer.                      */
+    APP_HRTMR_FNCT   Fnct;
+    void            *ArgPtr;
+    CPU_BOOLEAN      Active;
+};
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_HRTmr_Init     (void);
+
+CPU_BOOLEAN  App_HRTmr_Start    (APP_HRTMR       *p_tmr,
+                                 CPU_INT32U       delay_us,
+                                 CPU_INT32U       period_us,
+                                 APP_HRTMR_FNCT   fnct,
+                                 void            *p_arg);
+
+CPU_BOOLEAN  App_HRTmr_Stop     (APP_HRTMR       *p_tmr);
+
+CPU_BOOLEAN  App_HRTmr_IsActive (APP_HRTMR       *p_tmr);
+
+void         App_HRTmr_Report   (void);
+
+#endif
@@ -0,0 +1,315 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Interrupts-disabled time report.
+* uC/CPU keeps the all-time maximum (CPU_IntDisMeasMax_cnts) and a restartable one (CPU_IntDisMeasMaxCur_cnts);
+* the report prints both with the site that set them, then restarts the second one. The sites are kept here
+* with their raw count: they are only printed if they still match the uC/CPU value, a longer kernel section
+* having replaced them otherwise.
+*
+* The site records are updated with CPU_INT_DIS()/CPU_INT_EN(), which uC/CPU does not measure, so that they do
+* not appear in the maxima themselves.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+#include  <string.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_intdis.h"
+
+#ifdef  CPU_CFG_INT_DIS_MEAS_EN
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_intdis_site {
+    const  CPU_CHAR  *FilePtr;                                  /* (CPU_CHAR *)0 when no wrapped section set the max.   */
+    CPU_INT16U        Line;
+    CPU_TS_TMR        Cnts;                                     /* Raw count, overhead included.                        */
+} APP_INTDIS_SITE;
+
+
+/*
+*********************************************************************************************************
+*                                           GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+CPU_TS_TMR  App_IntDis_Mark;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_INTDIS_SITE  App_IntDis_SiteMax;                    /* Site of the all-time maximum.                        */
+static  APP_INTDIS_SITE  App_IntDis_SiteCur;                    /* Site of the maximum since the last report or reset.  */
+
+static  CPU_INT16U       App_IntDis_ReportPeriod_s;
+
+static  OS_TCB           App_IntDis_TaskTCB;
+static  CPU_STK          App_IntDis_TaskStk[APP_CFG_INTDIS_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void               App_IntDis_Task     (void              *p_arg);
+
+static  const  CPU_CHAR   *App_IntDis_SiteName (APP_INTDIS_SITE   *p_site,
+                                                CPU_TS_TMR         cnts,
+                                                CPU_CHAR          *p_buf);
+
+static  CPU_INT32U         App_IntDis_TS_to_uS (CPU_TS_TMR         cnts);
+
+
+/*
+*********************************************************************************************************
+*                                          App_IntDis_Init()
+*
+* Description : Starts the report task. The measurement itself is started by CPU_Init().
+*
+* Argument(s) : report_period_s     interval between two reports, in seconds (0 = no report task, the app
+*                                   calls App_IntDis_Report() itself).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_IntDis_Init (CPU_INT16U  report_period_s)
+{
+    OS_ERR  os_err;
+
+
+    App_IntDis_ReportPeriod_s = report_period_s;
+    if (report_period_s == 0u) {
+        return;
+    }
+
+    OSTaskCreate(&App_IntDis_TaskTCB,
+                 "Int. disabled report",
+                  App_IntDis_Task,
+                  0u,
+                  APP_CFG_INTDIS_TASK_PRIO,
+                 &App_IntDis_TaskStk[0u],
+                 (APP_CFG_INTDIS_TASK_STK_SIZE / 10u),
+                  APP_CFG_INTDIS_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_IntDis_Report()
+*
+* Description : Prints the all-time maximum and the maximum since the previous report (or reset) with their
+*               sites, the number of measured sections and the measurement overhead, then restarts the
+*               period maximum.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_IntDis_Report (void)
+{
+    APP_INTDIS_SITE  site_max;
+    APP_INTDIS_SITE  site_cur;
+    CPU_TS_TMR       max_cnts;
+    CPU_TS_TMR       cur_cnts;
+    CPU_INT32U       ctr;
+    CPU_CHAR         name_max[32];
+    CPU_CHAR         name_cur[32];
+    char             tmp[128];
+    CPU_SR_ALLOC();
+
+
+    CPU_INT_DIS();                                              /* Snapshot, not measured                               */
+    site_max = App_IntDis_SiteMax;
+    site_cur = App_IntDis_SiteCur;
+    App_IntDis_SiteCur.FilePtr = (const CPU_CHAR *)0;
+    App_IntDis_SiteCur.Cnts    = 0u;
+    ctr      = CPU_IntDisMeasCtr;
+    CPU_INT_EN();
+
+    cur_cnts = CPU_IntDisMeasMaxCurReset();                     /* Both net of the measurement overhead                 */
+    max_cnts = CPU_IntDisMeasMaxGet();
+
+    sprintf(tmp, "Int. disabled: max %u us (%s), period max %u us (%s)\n\r",
+            (unsigned)App_IntDis_TS_to_uS(max_cnts),
+            App_IntDis_SiteName(&site_max, max_cnts, &name_max[0]),
+            (unsigned)App_IntDis_TS_to_uS(cur_cnts),
+            App_IntDis_SiteName(&site_cur, cur_cnts, &name_cur[0]));
+    APP_TRACE_DBG(( tmp ));
+
+    sprintf(tmp, "               %u sections, measurement overhead %u counts per section\n\r",
+            (unsigned)ctr,
+            (unsigned)CPU_IntDisMeasOvrhd_cnts);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_IntDis_Reset()
+*
+* Description : Restarts the period maximum and forgets its site, e.g. once start-up is over. The all-time
+*               maximum is kept.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_IntDis_Reset (void)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_INT_DIS();
+    App_IntDis_SiteCur.FilePtr = (const CPU_CHAR *)0;
+    App_IntDis_SiteCur.Cnts    = 0u;
+    CPU_INT_EN();
+
+    (void)CPU_IntDisMeasMaxCurReset();
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_IntDis_SiteSet()
+*
+* Description : Records the site of a section that has just set a new maximum. Called by APP_CRITICAL_EXIT().
+*
+* Argument(s) : p_file      source file of the section.
+*               line        line of APP_CRITICAL_EXIT().
+*               cnts        section maximum read by APP_CRITICAL_EXIT() before the interrupts were enabled.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_IntDis_SiteSet (const  CPU_CHAR  *p_file,
+                          CPU_INT16U        line,
+                          CPU_TS_TMR        cnts)
+{
+    CPU_SR_ALLOC();
+
+
+    CPU_INT_DIS();
+    if (cnts > App_IntDis_SiteCur.Cnts) {
+        App_IntDis_SiteCur.FilePtr = p_file;
+        App_IntDis_SiteCur.Line    = line;
+        App_IntDis_SiteCur.Cnts    = cnts;
+    }
+    if (cnts > App_IntDis_SiteMax.Cnts) {
+        App_IntDis_SiteMax         = App_IntDis_SiteCur;
+    }
+    CPU_INT_EN();
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_IntDis_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_IntDis_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_IntDis_Report();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_IntDis_SiteName()
+*
+* Description : Formats "file:line" (file name without its path) if the site still holds the maximum 'cnts'.
+*********************************************************************************************************
+*/
+
+static  const  CPU_CHAR  *App_IntDis_SiteName (APP_INTDIS_SITE  *p_site,
+                                               CPU_TS_TMR        cnts,
+                                               CPU_CHAR         *p_buf)
+{
+    const  CPU_CHAR  *p_name;
+
+
+    if ((p_site->FilePtr == (const CPU_CHAR *)0) ||
+        (p_site->Cnts - CPU_IntDisMeasOvrhd_cnts != cnts)) {
+        return ("kernel or unwrapped");
+    }
+
+    p_name = strrchr(p_site->FilePtr, '/');
+    if (p_name == (const CPU_CHAR *)0) {
+        p_name = strrchr(p_site->FilePtr, '\\');
+    }
+    p_name = (p_name == (const CPU_CHAR *)0) ? p_site->FilePtr : (p_name + 1);
+
+    sprintf(p_buf, "%.24s:%u", p_name, (unsigned)p_site->Line);
+    return (p_buf);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_IntDis_TS_to_uS()
+*
+* Description : Converts CPU timestamp timer counts to microseconds.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_IntDis_TS_to_uS (CPU_TS_TMR  cnts)
+{
+    CPU_TS_TMR_FREQ  freq;
+    CPU_ERR          cpu_err;
+
+
+    freq = CPU_TS_TmrFreqGet(&cpu_err);
+    if ((cpu_err != CPU_ERR_NONE) || (freq == 0u)) {
+        return (0u);
+    }
+    return ((CPU_INT32U)(((CPU_INT64U)cnts * 1000000u) / freq));
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Interrupts-disabled time: uC/CPU times every outermost critical section (kernel and apps alike) when
+* CPU_CFG_INT_DIS_MEAS_EN is defined in cpu_cfg.h. This module prints the all-time maximum and the maximum
+* of the last period on the serial port, and restarts the period maximum at each report or on demand.
+*
+* The app modules use APP_CRITICAL_ENTER()/APP_CRITICAL_EXIT() instead of CPU_CRITICAL_ENTER()/EXIT(): a
+* section that sets a new maximum records its file and line. A maximum without a site comes from the kernel
+* or from a section that is not wrapped.
+*
+* Cost: uC/CPU reads the timestamp timer twice per section, CPU_IntDisMeasOvrhd_cnts cycles that are measured
+* at start-up, printed in the report and already subtracted from the maxima. The wrapper adds one compare
+* after each section, and a call only when the maximum grew.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_INTDIS_H
+#define  APP_INTDIS_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_INTDIS_TASK_PRIO
+#define  APP_CFG_INTDIS_TASK_PRIO                (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_INTDIS_TASK_STK_SIZE
+#define  APP_CFG_INTDIS_TASK_STK_SIZE            256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                        CRITICAL SECTION WRAPPERS
+*
+* Note(s) : (1) Same use as CPU_CRITICAL_ENTER()/CPU_CRITICAL_EXIT(), CPU_SR_ALLOC() included.
+*
+*           (2) App_IntDis_Mark is the section maximum seen at the entry: no other critical section can start
+*               before the exit, so a different value at the exit was set by this section. The exit is
+*               CPU_CRITICAL_EXIT() unrolled: both values are read after the measurement stops but before the
+*               interrupts are enabled again, so that an ISR that sets a new maximum in between is not blamed
+*               on this site.
+*********************************************************************************************************
+*/
+
+#ifdef  CPU_CFG_INT_DIS_MEAS_EN
+extern  CPU_TS_TMR  App_IntDis_Mark;
+
+#define  APP_CRITICAL_ENTER()   do {                                                    \
+                                    CPU_CRITICAL_ENTER();                               \
+                                    App_IntDis_Mark = CPU_IntDisMeasMaxCur_cnts;        \
+                                } while (0)
+
+#define  APP_CRITICAL_EXIT()    do {                                                    \
+                                    CPU_TS_TMR  max_;                                   \
+                                    CPU_TS_TMR  mark_;                                  \
+                                                                                        \
+                                    CPU_IntDisMeasStop();                               \
+                                    max_  = CPU_IntDisMeasMaxCur_cnts;                  \
+                                    mark_ = App_IntDis_Mark;                            \
+                                    CPU_INT_EN();                                       \
+                                    if (max_ != mark_) {                                \
+                                        App_IntDis_SiteSet(__FILE__, __LINE__, max_);   \
+                                    }                                                   \
+                                } while (0)
+#else
+#define  APP_CRITICAL_ENTER()    CPU_CRITICAL_ENTER()
+#define  APP_CRITICAL_EXIT()     CPU_CRITICAL_EXIT()
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+#ifdef  CPU_CFG_INT_DIS_MEAS_EN
+void  App_IntDis_Init    (CPU_INT16U         report_period_s);
+
+void  App_IntDis_Report  (void);
+
+void  App_IntDis_Reset   (void);
+
+void  App_IntDis_SiteSet (const  CPU_CHAR  *p_file,
+                          CPU_INT16U        line,
+                          CPU_TS_TMR        cnts);
+#else
+#define  App_IntDis_Init(report_period_s)
+#define  App_IntDis_Report()
+#define  App_IntDis_Reset()
+#endif
+
+#endif
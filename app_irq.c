@@ -0,0 +1,177 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Interrupt priority plan and deferral of kernel calls from fast ISRs.
+* App_IRQ_Init() writes the NVIC priority of every vector used by the apps, whether it is installed yet or not.
+* The deferral queue is a ring written only by the fast ISRs (one priority, they never nest) and read only by
+* the SWI handler, which they cannot be preempted by: neither side needs to mask interrupts. App_IRQ_Defer() and
+* the queue are in SRAM with the fast ISRs that call them (app_ramfunc.h).
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "fsl_interrupt_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <system_MK64F12.h>
+
+#include  "app_intdis.h"
+#include  "app_irq.h"
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_irq_prio {
+    IRQn_Type   IRQn;
+    CPU_INT08U  Prio;
+} APP_IRQ_PRIO;
+
+typedef  struct  app_irq_defer {
+    APP_IRQ_FNCT   Fnct;
+    void          *ArgPtr;
+} APP_IRQ_DEFER;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  const  APP_IRQ_PRIO  App_IRQ_PrioTbl[] = {
+    { PIT0_IRQn,   APP_CFG_IRQ_PRIO_TMR  },
+    { PIT1_IRQn,   APP_CFG_IRQ_PRIO_TMR  },
+    { PIT2_IRQn,   APP_CFG_IRQ_PRIO_TMR  },
+    { PIT3_IRQn,   APP_CFG_IRQ_PRIO_TMR  },
+    { LPTMR0_IRQn, APP_CFG_IRQ_PRIO_TMR  },
+    { LLWU_IRQn,   APP_CFG_IRQ_PRIO_TMR  },
+    { PORTA_IRQn,  APP_CFG_IRQ_PRIO_PORT },                     /* App_PortISR_FastSet() raises a port to FAST          */
+    { PORTB_IRQn,  APP_CFG_IRQ_PRIO_PORT },
+    { PORTC_IRQn,  APP_CFG_IRQ_PRIO_PORT },
+    { PORTD_IRQn,  APP_CFG_IRQ_PRIO_PORT },
+    { PORTE_IRQn,  APP_CFG_IRQ_PRIO_PORT },
+    { SWI_IRQn,    APP_CFG_IRQ_PRIO_SWI  },
+};
+
+APP_RAMDATA  static  APP_IRQ_DEFER         App_IRQ_DeferQ[APP_CFG_IRQ_DEFER_Q_SIZE];
+APP_RAMDATA  static  volatile  CPU_INT08U  App_IRQ_DeferIn;     /* Written by the fast ISRs only                        */
+APP_RAMDATA  static  volatile  CPU_INT08U  App_IRQ_DeferOut;    /* Written by the SWI only                              */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  App_IRQ_SWI_ISR (void);
+
+
+/*
+*********************************************************************************************************
+*                                            App_IRQ_Init()
+*
+* Description : Applies the priority plan and installs the deferral handler. Call after OSA_Init() and before
+*               the first App_IRQ_Defer().
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_IRQ_Init (void)
+{
+    CPU_INT08U  i;
+
+
+    for (i = 0u; i < sizeof(App_IRQ_PrioTbl) / sizeof(App_IRQ_PrioTbl[0]); i++) {
+        NVIC_SetPriority(App_IRQ_PrioTbl[i].IRQn, App_IRQ_PrioTbl[i].Prio);
+    }
+
+    INT_SYS_InstallHandler(SWI_IRQn, App_IRQ_SWI_ISR);
+    INT_SYS_EnableIRQ(SWI_IRQn);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_IRQ_Defer()
+*
+* Description : Queues a call for the SWI and pends it. To be called from fast (kernel-unaware) ISRs only.
+*
+* Argument(s) : fnct        function to call.
+*               p_arg       argument passed to the function.
+*
+* Return(s)   : DEF_FALSE if the queue is full (the call is lost), DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  CPU_BOOLEAN  App_IRQ_Defer (APP_IRQ_FNCT   fnct,
+                                         void          *p_arg)
+{
+    CPU_INT08U  in;
+    CPU_INT08U  next;
+
+
+    in   = App_IRQ_DeferIn;
+    next = (CPU_INT08U)((in + 1u) % APP_CFG_IRQ_DEFER_Q_SIZE);
+    if (next == App_IRQ_DeferOut) {
+        return (DEF_FALSE);
+    }
+
+    App_IRQ_DeferQ[in].Fnct   = fnct;
+    App_IRQ_DeferQ[in].ArgPtr = p_arg;
+    App_IRQ_DeferIn           = next;                           /* Publish the entry after it is written                */
+
+    NVIC_SetPendingIRQ(SWI_IRQn);
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_IRQ_SWI_ISR (void)
+{
+    APP_IRQ_DEFER  *p_defer;
+    CPU_INT08U      out;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    OSIntEnter();                                               /* Tell the OS that we are starting an ISR              */
+    APP_CRITICAL_EXIT();
+
+    out = App_IRQ_DeferOut;
+    while (out != App_IRQ_DeferIn) {                            /* Also runs what was queued while draining             */
+        p_defer = &App_IRQ_DeferQ[out];
+        p_defer->Fnct(p_defer->ArgPtr);
+        out              = (CPU_INT08U)((out + 1u) % APP_CFG_IRQ_DEFER_Q_SIZE);
+        App_IRQ_DeferOut = out;
+    }
+
+    OSIntExit();
+}
@@ -0,0 +1,123 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Interrupt priority plan and deferral of kernel calls from fast ISRs.
+*
+* uC/CPU masks interrupts in critical sections by raising BASEPRI to the kernel-aware boundary: vectors with a
+* numerically lower NVIC priority (fast ISRs) are never delayed by the kernel or by the apps' critical sections,
+* but they must not call any kernel service. A fast ISR does its time-critical part (e.g. reading a timer at an
+* echo edge) and hands the rest to App_IRQ_Defer(): the function runs shortly after in the software interrupt
+* (SWI), a kernel-aware vector, where it may post to kernel objects.
+*
+* With a uC/CPU port that masks with PRIMASK instead, fast ISRs still preempt every other ISR but are delayed
+* by critical sections.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_IRQ_H
+#define  APP_IRQ_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*
+* Note(s) : (1) NVIC priorities, 0 (highest) to 15 on the K64 (4 priority bits). SysTick and PendSV keep the
+*               priorities given by the uC/OS-III port.
+*
+*           (2) Vectors below APP_CFG_IRQ_KA_BOUNDARY are kernel-unaware: they must not call OSIntEnter(),
+*               OSIntExit() or any kernel service. All fast ISRs share one priority so that they never nest
+*               (App_IRQ_Defer() relies on it).
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_IRQ_KA_BOUNDARY
+#ifdef   CPU_CFG_KA_IPL_BOUNDARY
+#define  APP_CFG_IRQ_KA_BOUNDARY                 CPU_CFG_KA_IPL_BOUNDARY
+#else
+#define  APP_CFG_IRQ_KA_BOUNDARY                   4u
+#endif
+#endif
+
+#ifndef  APP_CFG_IRQ_PRIO_FAST                                  /* Echo capture (kernel-unaware)                        */
+#define  APP_CFG_IRQ_PRIO_FAST                     0u
+#endif
+
+#ifndef  APP_CFG_IRQ_PRIO_TMR                                   /* PIT, LPTMR and LLWU                                  */
+#define  APP_CFG_IRQ_PRIO_TMR                    (APP_CFG_IRQ_KA_BOUNDARY)
+#endif
+
+#ifndef  APP_CFG_IRQ_PRIO_PORT                                  /* PORTA..PORTE (switches)                              */
+#define  APP_CFG_IRQ_PRIO_PORT                   (APP_CFG_IRQ_KA_BOUNDARY + 1u)
+#endif
+
+#ifndef  APP_CFG_IRQ_PRIO_SWI                                   /* Deferred work, below every other app ISR             */
+#define  APP_CFG_IRQ_PRIO_SWI                     13u
+#endif
+
+#ifndef  APP_CFG_IRQ_DEFER_Q_SIZE
+#define  APP_CFG_IRQ_DEFER_Q_SIZE                  8u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                     KERNEL-AWARE MASKING IN SRAM CODE
+*
+* Note(s) : (1) The masking of CPU_CRITICAL_ENTER()/EXIT() (BASEPRI at the kernel-aware boundary, fast ISRs
+*               still run) with the CMSIS intrinsics inline, for APP_RAMFUNC paths: no call to CPU_SR_Save()
+*               and CPU_SR_Restore() in flash. These sections are not measured by app_intdis.
+*********************************************************************************************************
+*/
+
+#define  APP_IRQ_KA_BASEPRI                     ((CPU_INT32U)APP_CFG_IRQ_KA_BOUNDARY << (8u - __NVIC_PRIO_BITS))
+
+#define  APP_IRQ_KA_MASK(basepri)       do {                                            \
+                                            (basepri) = __get_BASEPRI();                \
+                                            __set_BASEPRI_MAX(APP_IRQ_KA_BASEPRI);      \
+                                        } while (0)
+
+#define  APP_IRQ_KA_UNMASK(basepri)     __set_BASEPRI(basepri)
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  void  (*APP_IRQ_FNCT)(void  *p_arg);                   /* Runs in the SWI, may post to kernel objects.         */
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_IRQ_Init  (void);
+
+APP_RAMFUNC                                                     /* In SRAM with the fast ISRs, see app_ramfunc.h        */
+CPU_BOOLEAN  App_IRQ_Defer (APP_IRQ_FNCT   fnct,
+                            void          *p_arg);
+
+#endif
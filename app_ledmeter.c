@@ -0,0 +1,369 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Blink frequency and duty-cycle meter.
+* A period is measured between two consecutive off->on transitions of the same LED, the duty cycle is the
+* on-time accumulated over complete periods, and the jitter is the standard deviation of the periods. All
+* figures cover the interval since the previous report, so the meter can be used as a regression benchmark for
+* any change to the blinking/scheduling code.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+#include  <math.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_mem.h>
+
+#include  "app_intdis.h"
+#include  "app_ledmeter.h"
+
+#if (APP_CFG_LED_METER_EN == DEF_ENABLED)
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_ledmeter_ch {
+    CPU_INT32U   Pin;
+    CPU_CHAR    *NamePtr;
+    CPU_BOOLEAN  On;                                            /* Current LED state.                                   */
+    CPU_BOOLEAN  Started;                                       /* At least one off->on transition seen.                */
+    CPU_TS_TMR   RiseTS;                                        /* Timestamp of the last off->on transition.            */
+    CPU_INT32U   OnPend;                                        /* On-time of the current, incomplete period.           */
+    CPU_INT64U   OnSum;                                         /* On-time over complete periods, in ts counts.         */
+    CPU_INT64U   PeriodSum;
+    CPU_INT64U   PeriodSqSum;                                   /* In us^2, for the jitter.                             */
+    CPU_INT32U   PeriodMin;
+    CPU_INT32U   PeriodMax;
+    CPU_INT32U   PeriodCtr;
+    CPU_INT32U   EdgeCtr;
+} APP_LEDMETER_CH;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_LEDMETER_CH  App_LedMeter_Ch[APP_CFG_LED_METER_CH_MAX];
+static  CPU_INT08U       App_LedMeter_ChNbr;
+static  CPU_INT32U       App_LedMeter_TS_Freq;                  /* Timestamp counts per second.                         */
+static  CPU_INT16U       App_LedMeter_ReportPeriod_s;
+
+static  OS_TCB           App_LedMeter_TaskTCB;
+static  CPU_STK          App_LedMeter_TaskStk[APP_CFG_LED_METER_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void               App_LedMeter_Task   (void         *p_arg);
+
+static  APP_LEDMETER_CH   *App_LedMeter_ChFind (CPU_INT32U    pin);
+
+static  void               App_LedMeter_Edge   (CPU_INT32U    pin,
+                                                CPU_BOOLEAN   on);
+
+static  void               App_LedMeter_ChClr  (APP_LEDMETER_CH  *p_ch);
+
+static  CPU_INT32U         App_LedMeter_TS_to_uS (CPU_INT64U  ts);
+
+
+/*
+*********************************************************************************************************
+*                                        App_LedMeter_ChAdd()
+*
+* Description : Registers an LED to be measured. Must be called before App_LedMeter_Start().
+*
+* Argument(s) : pin         GPIO pin of the LED.
+*               p_name      name printed in the report.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LedMeter_ChAdd (CPU_INT32U   pin,
+                          CPU_CHAR    *p_name)
+{
+    APP_LEDMETER_CH  *p_ch;
+
+
+    if (App_LedMeter_ChNbr >= APP_CFG_LED_METER_CH_MAX) {
+        return;
+    }
+    p_ch          = &App_LedMeter_Ch[App_LedMeter_ChNbr];
+    p_ch->Pin     =  pin;
+    p_ch->NamePtr =  p_name;
+    p_ch->On      = (GPIO_DRV_ReadPinInput(pin) == 0u) ? DEF_TRUE : DEF_FALSE;
+    App_LedMeter_ChClr(p_ch);
+    App_LedMeter_ChNbr++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_LedMeter_Start()
+*
+* Description : Creates the report task. CPU_Init() must have been called (timestamps).
+*
+* Argument(s) : report_period_s     interval between two reports, in seconds.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LedMeter_Start (CPU_INT16U  report_period_s)
+{
+    CPU_ERR  cpu_err;
+    OS_ERR   os_err;
+
+
+    App_LedMeter_TS_Freq        = CPU_TS_TmrFreqGet(&cpu_err);
+    App_LedMeter_ReportPeriod_s = report_period_s;
+
+    OSTaskCreate(&App_LedMeter_TaskTCB,
+                 "LED meter",
+                  App_LedMeter_Task,
+                  0u,
+                  APP_CFG_LED_METER_TASK_PRIO,
+                 &App_LedMeter_TaskStk[0u],
+                 (APP_CFG_LED_METER_TASK_STK_SIZE / 10u),
+                  APP_CFG_LED_METER_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_LedMeter_Report()
+*
+* Description : Prints frequency, duty cycle and period statistics of every LED since the previous report,
+*               then restarts the measurement.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LedMeter_Report (void)
+{
+    APP_LEDMETER_CH   snap;
+    APP_LEDMETER_CH  *p_ch;
+    CPU_INT08U        i;
+    CPU_INT32U        span_us;
+    CPU_INT32U        freq_mHz;
+    CPU_INT32U        duty_permil;
+    CPU_INT32U        mean_us;
+    CPU_INT32U        jitter_us;
+    CPU_FP32          var;
+    char              tmp[128];
+    CPU_SR_ALLOC();
+
+
+    for (i = 0u; i < App_LedMeter_ChNbr; i++) {
+        p_ch = &App_LedMeter_Ch[i];
+
+        APP_CRITICAL_ENTER();                                   /* Take a consistent snapshot and restart.              */
+        snap = *p_ch;
+        App_LedMeter_ChClr(p_ch);
+        if (snap.Started == DEF_TRUE) {                         /* Keep the phase: the next period starts at last rise. */
+            p_ch->Started     = DEF_TRUE;
+            p_ch->RiseTS      = snap.RiseTS;
+            p_ch->OnPend      = snap.OnPend;
+        }
+        APP_CRITICAL_EXIT();
+
+        if (snap.PeriodCtr == 0u) {
+            sprintf(tmp, "LED %-6.6s: %u edges, no complete period\n\r",
+                    snap.NamePtr, (unsigned)snap.EdgeCtr);
+            APP_TRACE_DBG(( tmp ));
+            continue;
+        }
+
+        span_us     = App_LedMeter_TS_to_uS(snap.PeriodSum);
+        freq_mHz    = (CPU_INT32U)(((CPU_INT64U)snap.PeriodCtr * 1000000000u) / span_us);
+        duty_permil = (CPU_INT32U)((snap.OnSum * 1000u) / snap.PeriodSum);
+        mean_us     = span_us / snap.PeriodCtr;
+        var         = ((CPU_FP32)snap.PeriodSqSum / snap.PeriodCtr) - ((CPU_FP32)mean_us * mean_us);
+        jitter_us   = (var > 0.0f) ? (CPU_INT32U)sqrtf(var) : 0u;
+
+        sprintf(tmp, "LED %-6.6s: %u.%03u Hz, duty %u.%u%%, period %u us (min %u, max %u), jitter %u us rms\n\r",
+                snap.NamePtr,
+                (unsigned)(freq_mHz / 1000u),
+                (unsigned)(freq_mHz % 1000u),
+                (unsigned)(duty_permil / 10u),
+                (unsigned)(duty_permil % 10u),
+                (unsigned)mean_us,
+                (unsigned)App_LedMeter_TS_to_uS(snap.PeriodMin),
+                (unsigned)App_LedMeter_TS_to_uS(snap.PeriodMax),
+                (unsigned)jitter_us);
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                  App_LedMeter_Set/Clr/Toggle()
+*
+* Description : Drive an LED pin and timestamp the transition if the LED changes state.
+*               Use through APP_LED_SET(), APP_LED_CLR() and APP_LED_TOGGLE().
+*
+* Argument(s) : pin         GPIO pin of the LED.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LedMeter_Set (CPU_INT32U  pin)
+{
+    APP_PIN_SET(pin);
+    App_LedMeter_Edge(pin, DEF_FALSE);
+}
+
+
+void  App_LedMeter_Clr (CPU_INT32U  pin)
+{
+    APP_PIN_CLR(pin);
+    App_LedMeter_Edge(pin, DEF_TRUE);
+}
+
+
+void  App_LedMeter_Toggle (CPU_INT32U  pin)
+{
+    APP_LEDMETER_CH  *p_ch;
+
+
+    APP_PIN_TOGGLE(pin);
+    p_ch = App_LedMeter_ChFind(pin);
+    if (p_ch != (APP_LEDMETER_CH *)0) {
+        App_LedMeter_Edge(pin, (p_ch->On == DEF_TRUE) ? DEF_FALSE : DEF_TRUE);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_LedMeter_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_LedMeter_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_LedMeter_Report();
+    }
+}
+
+
+static  APP_LEDMETER_CH  *App_LedMeter_ChFind (CPU_INT32U  pin)
+{
+    CPU_INT08U  i;
+
+
+    for (i = 0u; i < App_LedMeter_ChNbr; i++) {
+        if (App_LedMeter_Ch[i].Pin == pin) {
+            return (&App_LedMeter_Ch[i]);
+        }
+    }
+    return ((APP_LEDMETER_CH *)0);
+}
+
+
+static  void  App_LedMeter_Edge (CPU_INT32U   pin,
+                                 CPU_BOOLEAN  on)
+{
+    APP_LEDMETER_CH  *p_ch;
+    CPU_TS_TMR        ts;
+    CPU_INT32U        period;
+    CPU_INT32U        period_us;
+    CPU_SR_ALLOC();
+
+
+    ts   = CPU_TS_TmrRd();
+    p_ch = App_LedMeter_ChFind(pin);
+    if ((p_ch == (APP_LEDMETER_CH *)0) || (p_ch->On == on)) {   /* Not measured, or no transition.                      */
+        return;
+    }
+
+    APP_CRITICAL_ENTER();
+    p_ch->On = on;
+    p_ch->EdgeCtr++;
+    if (on == DEF_TRUE) {                                       /* ------------------- OFF -> ON: PERIOD ---------------- */
+        if (p_ch->Started == DEF_TRUE) {
+            period           = (CPU_INT32U)(ts - p_ch->RiseTS);
+            period_us        = App_LedMeter_TS_to_uS(period);
+            p_ch->PeriodSum   += period;
+            p_ch->PeriodSqSum += (CPU_INT64U)period_us * period_us;
+            p_ch->OnSum       += p_ch->OnPend;
+            p_ch->PeriodMin    = DEF_MIN(p_ch->PeriodMin, period);
+            p_ch->PeriodMax    = DEF_MAX(p_ch->PeriodMax, period);
+            p_ch->PeriodCtr++;
+        } else {
+            p_ch->Started      = DEF_TRUE;
+        }
+        p_ch->RiseTS = ts;
+        p_ch->OnPend = 0u;
+    } else if (p_ch->Started == DEF_TRUE) {                     /* ------------------ ON -> OFF: ON-TIME ---------------- */
+        p_ch->OnPend = (CPU_INT32U)(ts - p_ch->RiseTS);
+    }
+    APP_CRITICAL_EXIT();
+}
+
+
+static  void  App_LedMeter_ChClr (APP_LEDMETER_CH  *p_ch)
+{
+    p_ch->Started     = DEF_FALSE;
+    p_ch->OnPend      = 0u;
+    p_ch->OnSum       = 0u;
+    p_ch->PeriodSum   = 0u;
+    p_ch->PeriodSqSum = 0u;
+    p_ch->PeriodMin   = DEF_INT_32U_MAX_VAL;
+    p_ch->PeriodMax   = 0u;
+    p_ch->PeriodCtr   = 0u;
+    p_ch->EdgeCtr     = 0u;
+}
+
+
+static  CPU_INT32U  App_LedMeter_TS_to_uS (CPU_INT64U  ts)
+{
+    if (App_LedMeter_TS_Freq == 0u) {
+        return (0u);
+    }
+    return ((CPU_INT32U)((ts * 1000000u) / App_LedMeter_TS_Freq));
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Blink frequency and duty-cycle meter: LED writes go through APP_LED_SET/CLR/TOGGLE(); with the meter enabled
+* every transition is timestamped and the achieved frequency, duty cycle and period jitter of each LED are
+* printed periodically on the serial port.
+*
+* Enable with:  #define  APP_CFG_LED_METER_EN  DEF_ENABLED  in app_cfg.h
+*********************************************************************************************************
+*/
+
+#ifndef  APP_LEDMETER_H
+#define  APP_LEDMETER_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <board.h>
+
+#include  "app_pin.h"
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_LED_METER_EN
+#define  APP_CFG_LED_METER_EN                    DEF_DISABLED
+#endif
+
+#ifndef  APP_CFG_LED_METER_CH_MAX
+#define  APP_CFG_LED_METER_CH_MAX                  4u
+#endif
+
+#ifndef  APP_CFG_LED_METER_TASK_PRIO
+#define  APP_CFG_LED_METER_TASK_PRIO             (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_LED_METER_TASK_STK_SIZE
+#define  APP_CFG_LED_METER_TASK_STK_SIZE         256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                         LED ACCESS WRAPPERS
+*
+* Note(s) : (1) LEDs on the FRDM-K64F are active low: setting the pin turns the LED off, clearing it turns it on.
+*
+*           (2) Without the meter, a write is a single store to PSOR/PCOR/PTOR (app_pin.h).
+*********************************************************************************************************
+*/
+
+#if (APP_CFG_LED_METER_EN == DEF_ENABLED)
+#define  APP_LED_SET(pin)                        App_LedMeter_Set(pin)
+#define  APP_LED_CLR(pin)                        App_LedMeter_Clr(pin)
+#define  APP_LED_TOGGLE(pin)                     App_LedMeter_Toggle(pin)
+#else
+#define  APP_LED_SET(pin)                        APP_PIN_SET(pin)
+#define  APP_LED_CLR(pin)                        APP_PIN_CLR(pin)
+#define  APP_LED_TOGGLE(pin)                     APP_PIN_TOGGLE(pin)
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+#if (APP_CFG_LED_METER_EN == DEF_ENABLED)
+void  App_LedMeter_ChAdd  (CPU_INT32U   pin,
+                           CPU_CHAR    *p_name);
+
+void  App_LedMeter_Start  (CPU_INT16U   report_period_s);
+
+void  App_LedMeter_Report (void);
+
+void  App_LedMeter_Set    (CPU_INT32U   pin);
+
+void  App_LedMeter_Clr    (CPU_INT32U   pin);
+
+void  App_LedMeter_Toggle (CPU_INT32U   pin);
+#else
+#define  App_LedMeter_ChAdd(pin, p_name)
+#define  App_LedMeter_Start(report_period_s)
+#define  App_LedMeter_Report()
+#endif
+
+#endif
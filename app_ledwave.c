@@ -0,0 +1,447 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* LED waveform playback.
+* FTM2 counts one slot per overflow; channel 0 (software output compare at count 0, DMA enabled) raises one
+* DMA request per slot through the DMAMUX. The first DMA channel writes the PSOR word of the slot of the first
+* port and links to the next channel (PCOR of the same port, then PSOR and PCOR of the next port, ...) on every
+* minor loop and on the major loop: one request writes the whole slot, the ports within a few bus clocks. Each
+* channel walks its word table and rewinds it after the hyperperiod (SLAST), so the pattern loops without an
+* interrupt.
+*
+* Hand-over at the end of the hyperperiod: the major loop interrupt of the last channel is enabled while a
+* pattern is pending, and its ISR reloads the channels from the other buffer. The next request is one slot
+* later, so the ISR only needs to run within a slot and makes no kernel call.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "fsl_clock_manager.h"
+#include  "fsl_interrupt_manager.h"
+#include  <fsl_gpio_common.h>
+#include  <system_MK64F12.h>
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+#include  <lib_mem.h>
+
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_ledwave.h"
+#include  "app_lowpwr.h"
+#include  "app_pin.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_LEDWAVE_DMAMUX_SRC_FTM2_CH0          30u           /* DMAMUX request source of FTM2 channel 0              */
+#define  APP_LEDWAVE_DMA_SIZE_32BIT                2u           /* DMA_ATTR[SSIZE/DSIZE] encoding                       */
+#define  APP_LEDWAVE_FTM_CLKS_SYS                  1u           /* FTM clock: system clock (bus clock on the K64)       */
+#define  APP_LEDWAVE_FTM_PS_MAX                    7u           /* Prescaler 128                                        */
+#define  APP_LEDWAVE_FTM_CNT_MAX               65536u
+#define  APP_LEDWAVE_WORD_SET                      0u
+#define  APP_LEDWAVE_WORD_CLR                      1u
+
+#define  APP_LEDWAVE_CH_NBR                     (2u * APP_CFG_LEDWAVE_PORT_MAX)
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_ledwave_buf {
+    CPU_INT32U   Word[APP_CFG_LEDWAVE_PORT_MAX][2u][APP_CFG_LEDWAVE_SLOT_MAX];   /* Read by the DMA: PSOR, PCOR.    */
+    GPIO_Type   *GPIO_Ptr[APP_CFG_LEDWAVE_PORT_MAX];
+    CPU_INT32U   PinMask[APP_CFG_LEDWAVE_PORT_MAX];             /* LED pins of each port.                               */
+    CPU_INT08U   PortNbr;
+    CPU_INT16U   SlotNbr;
+} APP_LEDWAVE_BUF;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_LEDWAVE_BUF        App_LedWave_Buf[2u];
+static  CPU_INT08U             App_LedWave_Front;               /* Buffer loaded in the DMA channels.                   */
+static  volatile  CPU_BOOLEAN  App_LedWave_Pending;             /* Other buffer handed over at the end of the loop.     */
+static  CPU_BOOLEAN            App_LedWave_Playing;             /* DMA running, stop lock held.                         */
+static  CPU_INT32U             App_LedWave_FTM_SC;              /* FTM2 clock and prescaler while playing.              */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_LedWave_Compile (APP_LEDWAVE_BUF        *p_buf,
+                                          const APP_LEDWAVE_PAT  *p_pat);
+
+static  void         App_LedWave_Load    (APP_LEDWAVE_BUF        *p_buf);
+
+static  void         App_LedWave_Halt    (void);
+
+static  void         App_LedWave_ISR     (void);
+
+
+/*
+*********************************************************************************************************
+*                                          App_LedWave_Init()
+*
+* Description : Clocks FTM2, the DMAMUX and the DMA, sets the slot length and routes FTM2 channel 0 to the
+*               first DMA channel. Nothing plays until App_LedWave_Play().
+*
+* Argument(s) : slot_ms     slot length, in ms.
+*
+* Return(s)   : DEF_FALSE if the slot is longer than FTM2 can count (about 139 ms at a 60 MHz bus clock),
+*               DEF_TRUE otherwise.
+*
+* Note(s)     : (1) The LED pins must already be configured as outputs by GPIO_DRV_Init().
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_LedWave_Init (CPU_INT16U  slot_ms)
+{
+    CPU_INT32U  cnt;
+    CPU_INT32U  ps;
+    CPU_INT32U  i;
+    IRQn_Type   irq;
+
+
+    cnt = (CLOCK_SYS_GetBusClockFreq() / 1000u) * slot_ms;
+    for (ps = 0u; ps < APP_LEDWAVE_FTM_PS_MAX; ps++) {
+        if ((cnt >> ps) <= APP_LEDWAVE_FTM_CNT_MAX) {
+            break;
+        }
+    }
+    cnt >>= ps;
+    if ((cnt == 0u) || (cnt > APP_LEDWAVE_FTM_CNT_MAX)) {
+        return (DEF_FALSE);
+    }
+
+    SIM->SCGC6 |= SIM_SCGC6_FTM2_MASK | SIM_SCGC6_DMAMUX_MASK;
+    SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+
+    App_LedWave_Halt();
+    FTM2->CNTIN                = 0u;
+    FTM2->MOD                  = cnt - 1u;
+    FTM2->CONTROLS[0u].CnV     = 0u;                            /* One match per overflow                               */
+    FTM2->CONTROLS[0u].CnSC    = FTM_CnSC_MSA_MASK              /* Software compare: the pin stays a GPIO               */
+                               | FTM_CnSC_CHIE_MASK
+                               | FTM_CnSC_DMA_MASK;             /* DMA request instead of interrupt, CHF cleared by it  */
+    App_LedWave_FTM_SC         = FTM_SC_CLKS(APP_LEDWAVE_FTM_CLKS_SYS) | FTM_SC_PS(ps);
+
+    DMAMUX->CHCFG[APP_CFG_LEDWAVE_DMA_CH] = 0u;
+    DMAMUX->CHCFG[APP_CFG_LEDWAVE_DMA_CH] = DMAMUX_CHCFG_ENBL_MASK
+                                          | DMAMUX_CHCFG_SOURCE(APP_LEDWAVE_DMAMUX_SRC_FTM2_CH0);
+
+    for (i = 1u; i < APP_CFG_LEDWAVE_PORT_MAX + 1u; i++) {      /* The PCOR channel of each port may end the chain      */
+        irq = (IRQn_Type)(DMA0_IRQn + APP_CFG_LEDWAVE_DMA_CH + (2u * i) - 1u);
+        NVIC_SetPriority(irq, APP_CFG_IRQ_PRIO_SWI);
+        INT_SYS_InstallHandler(irq, App_LedWave_ISR);
+        INT_SYS_EnableIRQ(irq);
+    }
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LedWave_Play()
+*
+* Description : Compiles a pattern into the free buffer and hands it over to the DMA.
+*
+* Argument(s) : p_pat       pattern, see app_ledwave.h Note #1.
+*               at_once     DEF_YES: the new pattern starts at slot 0 now.
+*                           DEF_NO : it starts when the pattern in progress completes its hyperperiod.
+*
+* Return(s)   : DEF_FALSE if the pattern is invalid, or, with 'at_once' DEF_NO, if the previous hand-over has
+*               not taken place yet (retry later); DEF_TRUE otherwise.
+*
+* Note(s)     : (1) Task level only. LEDs that are not in the new pattern keep their state.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_LedWave_Play (const APP_LEDWAVE_PAT  *p_pat,
+                               CPU_BOOLEAN             at_once)
+{
+    APP_LEDWAVE_BUF  *p_buf;
+    CPU_INT08U        back;
+    CPU_INT16U        s;
+    CPU_BOOLEAN       steady;
+    CPU_BOOLEAN       lock;
+    CPU_BOOLEAN       unlock;
+    CPU_INT08U        port;
+    CPU_INT08U        last;
+    CPU_SR_ALLOC();
+
+
+    if ((p_pat->PinNbr  == 0u) || (p_pat->PinNbr  > DEF_INT_08_NBR_BITS) ||
+        (p_pat->SlotNbr == 0u) || (p_pat->SlotNbr > APP_CFG_LEDWAVE_SLOT_MAX)) {
+        return (DEF_FALSE);
+    }
+
+    APP_CRITICAL_ENTER();
+    if (App_LedWave_Pending == DEF_YES) {
+        if (at_once == DEF_NO) {
+            APP_CRITICAL_EXIT();
+            return (DEF_FALSE);
+        }
+        App_LedWave_Pending = DEF_NO;                           /* Cancelled: the back buffer is free again             */
+        last = APP_CFG_LEDWAVE_DMA_CH + (2u * App_LedWave_Buf[App_LedWave_Front].PortNbr) - 1u;
+        DMA0->TCD[last].CSR &= ~DMA_CSR_INTMAJOR_MASK;
+    }
+    APP_CRITICAL_EXIT();
+
+    back  = 1u - App_LedWave_Front;
+    p_buf = &App_LedWave_Buf[back];
+    if (App_LedWave_Compile(p_buf, p_pat) != DEF_TRUE) {
+        return (DEF_FALSE);
+    }
+
+    steady = DEF_YES;
+    for (s = 1u; s < p_pat->SlotNbr; s++) {
+        if (p_pat->MaskTbl[s] != p_pat->MaskTbl[0u]) {
+            steady = DEF_NO;
+            break;
+        }
+    }
+
+    lock   = DEF_NO;
+    unlock = DEF_NO;
+    APP_CRITICAL_ENTER();
+    if (steady == DEF_YES) {                                    /* Written once, DMA stopped                            */
+        App_LedWave_Halt();
+        for (port = 0u; port < p_buf->PortNbr; port++) {
+            p_buf->GPIO_Ptr[port]->PSOR = p_buf->Word[port][APP_LEDWAVE_WORD_SET][0u];
+            p_buf->GPIO_Ptr[port]->PCOR = p_buf->Word[port][APP_LEDWAVE_WORD_CLR][0u];
+        }
+        App_LedWave_Front = back;
+        unlock = App_LedWave_Playing;
+        App_LedWave_Playing = DEF_NO;
+
+    } else if ((App_LedWave_Playing == DEF_NO) || (at_once == DEF_YES)) {
+        App_LedWave_Halt();
+        App_LedWave_Load(p_buf);
+        App_LedWave_Front = back;
+        FTM2->CNT = 0u;                                         /* Slot 0 at the next count 0                           */
+        DMA0->SERQ = APP_CFG_LEDWAVE_DMA_CH;
+        FTM2->SC   = App_LedWave_FTM_SC;
+        lock = (App_LedWave_Playing == DEF_NO) ? DEF_YES : DEF_NO;
+        App_LedWave_Playing = DEF_YES;
+
+    } else {                                                    /* Hand-over by App_LedWave_ISR()                       */
+        App_LedWave_Pending = DEF_YES;
+        last = APP_CFG_LEDWAVE_DMA_CH + (2u * App_LedWave_Buf[App_LedWave_Front].PortNbr) - 1u;
+        DMA0->TCD[last].CSR |= DMA_CSR_INTMAJOR_MASK;
+    }
+    APP_CRITICAL_EXIT();
+
+    if (lock == DEF_YES) {
+        App_LowPwr_StopLock();
+    }
+    if (unlock == DEF_YES) {
+        App_LowPwr_StopUnlock();
+    }
+
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LedWave_Stop()
+*
+* Description : Stops the playback and turns the LEDs of the current pattern off.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LedWave_Stop (void)
+{
+    APP_LEDWAVE_BUF  *p_buf;
+    CPU_INT08U        port;
+    CPU_BOOLEAN       unlock;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    App_LedWave_Halt();
+    App_LedWave_Pending = DEF_NO;
+    p_buf = &App_LedWave_Buf[App_LedWave_Front];
+    for (port = 0u; port < p_buf->PortNbr; port++) {
+        p_buf->GPIO_Ptr[port]->PSOR = p_buf->PinMask[port];     /* setting the pins turns the LEDs off                  */
+    }
+    unlock = App_LedWave_Playing;
+    App_LedWave_Playing = DEF_NO;
+    APP_CRITICAL_EXIT();
+
+    if (unlock == DEF_YES) {
+        App_LowPwr_StopUnlock();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/* one PSOR and one PCOR word per slot and per port: every LED pin is written in every slot */
+static  CPU_BOOLEAN  App_LedWave_Compile (APP_LEDWAVE_BUF        *p_buf,
+                                          const APP_LEDWAVE_PAT  *p_pat)
+{
+    CPU_INT08U  lane[DEF_INT_08_NBR_BITS];
+    CPU_INT08U  n;
+    CPU_INT08U  port;
+    CPU_INT16U  s;
+    GPIO_Type  *p_gpio;
+    CPU_INT32U  pin;
+
+
+    Mem_Clr(p_buf, sizeof(APP_LEDWAVE_BUF));
+    for (n = 0u; n < p_pat->PinNbr; n++) {
+        p_gpio = APP_PIN_GPIO(p_pat->PinTbl[n]);
+        for (port = 0u; port < p_buf->PortNbr; port++) {
+            if (p_buf->GPIO_Ptr[port] == p_gpio) {
+                break;
+            }
+        }
+        if (port == p_buf->PortNbr) {
+            if (port == APP_CFG_LEDWAVE_PORT_MAX) {
+                return (DEF_FALSE);
+            }
+            p_buf->GPIO_Ptr[port] = p_gpio;
+            p_buf->PortNbr++;
+        }
+        lane[n]               = port;
+        p_buf->PinMask[port] |= APP_PIN_MASK(p_pat->PinTbl[n]);
+    }
+
+    for (s = 0u; s < p_pat->SlotNbr; s++) {
+        for (n = 0u; n < p_pat->PinNbr; n++) {
+            pin = p_pat->PinTbl[n];
+            if ((p_pat->MaskTbl[s] & DEF_BIT(n)) != 0u) {       /* clearing the pin turns the LED on                    */
+                p_buf->Word[lane[n]][APP_LEDWAVE_WORD_CLR][s] |= APP_PIN_MASK(pin);
+            } else {
+                p_buf->Word[lane[n]][APP_LEDWAVE_WORD_SET][s] |= APP_PIN_MASK(pin);
+            }
+        }
+    }
+    p_buf->SlotNbr = p_pat->SlotNbr;
+
+    return (DEF_TRUE);
+}
+
+
+/* programs the chain of DMA channels for a buffer; the channels must be idle */
+static  void  App_LedWave_Load (APP_LEDWAVE_BUF  *p_buf)
+{
+    CPU_INT08U  port;
+    CPU_INT08U  w;
+    CPU_INT08U  ch;
+    CPU_INT08U  last;
+    CPU_INT16U  slot_nbr;
+
+
+    slot_nbr = p_buf->SlotNbr;
+    last     = APP_CFG_LEDWAVE_DMA_CH + (2u * p_buf->PortNbr) - 1u;
+    for (port = 0u; port < p_buf->PortNbr; port++) {
+        for (w = 0u; w < 2u; w++) {
+            ch = APP_CFG_LEDWAVE_DMA_CH + (2u * port) + w;
+            DMA0->TCD[ch].SADDR        = (CPU_INT32U)&p_buf->Word[port][w][0u];
+            DMA0->TCD[ch].SOFF         =  sizeof(CPU_INT32U);
+            DMA0->TCD[ch].ATTR         =  DMA_ATTR_SSIZE(APP_LEDWAVE_DMA_SIZE_32BIT)
+                                       |  DMA_ATTR_DSIZE(APP_LEDWAVE_DMA_SIZE_32BIT);
+            DMA0->TCD[ch].NBYTES_MLNO  =  sizeof(CPU_INT32U);   /* One word per slot                                    */
+            DMA0->TCD[ch].SLAST        = -(CPU_INT32S)(slot_nbr * sizeof(CPU_INT32U));
+            DMA0->TCD[ch].DADDR        = (w == APP_LEDWAVE_WORD_SET) ? (CPU_INT32U)&p_buf->GPIO_Ptr[port]->PSOR
+                                                                     : (CPU_INT32U)&p_buf->GPIO_Ptr[port]->PCOR;
+            DMA0->TCD[ch].DOFF         =  0u;
+            DMA0->TCD[ch].DLAST_SGA    =  0;
+            if (ch != last) {                                   /* Link on every minor loop, the last one included      */
+                DMA0->TCD[ch].CITER_ELINKYES = DMA_CITER_ELINKYES_ELINK_MASK
+                                             | DMA_CITER_ELINKYES_LINKCH(ch + 1u)
+                                             | DMA_CITER_ELINKYES_CITER(slot_nbr);
+                DMA0->TCD[ch].BITER_ELINKYES = DMA_BITER_ELINKYES_ELINK_MASK
+                                             | DMA_BITER_ELINKYES_LINKCH(ch + 1u)
+                                             | DMA_BITER_ELINKYES_BITER(slot_nbr);
+                DMA0->TCD[ch].CSR            = DMA_CSR_MAJORELINK_MASK
+                                             | DMA_CSR_MAJORLINKCH(ch + 1u);
+            } else {
+                DMA0->TCD[ch].CITER_ELINKNO  = slot_nbr;
+                DMA0->TCD[ch].BITER_ELINKNO  = slot_nbr;
+                DMA0->TCD[ch].CSR            = 0u;              /* No DREQ: the request stays enabled                   */
+            }
+        }
+    }
+}
+
+
+/* stops FTM2 and the DMA request, then waits for a chain in flight (a few bus clocks) */
+static  void  App_LedWave_Halt (void)
+{
+    CPU_INT08U  ch;
+
+
+    FTM2->SC   = 0u;
+    DMA0->CERQ = APP_CFG_LEDWAVE_DMA_CH;
+    for (ch = APP_CFG_LEDWAVE_DMA_CH; ch < APP_CFG_LEDWAVE_DMA_CH + APP_LEDWAVE_CH_NBR; ch++) {
+        while ((DMA0->TCD[ch].CSR & (DMA_CSR_ACTIVE_MASK | DMA_CSR_START_MASK)) != 0u) {
+            ;
+        }
+    }
+    FTM2->CONTROLS[0u].CnSC &= ~FTM_CnSC_CHF_MASK;              /* No request left over from the old pattern            */
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_LedWave_ISR()
+*
+* Description : End of the hyperperiod with a pattern pending: loads the other buffer before the next slot.
+*
+* Note(s)     : (1) Kernel-unaware: no kernel call. The vector is the one of the last channel of the chain.
+*********************************************************************************************************
+*/
+
+static  void  App_LedWave_ISR (void)
+{
+    CPU_INT08U  ch;
+
+
+    for (ch = APP_CFG_LEDWAVE_DMA_CH; ch < APP_CFG_LEDWAVE_DMA_CH + APP_LEDWAVE_CH_NBR; ch++) {
+        DMA0->CINT = ch;
+    }
+    if (App_LedWave_Pending == DEF_YES) {                       /* Not cancelled by App_LedWave_Play()                  */
+        App_LedWave_Front   = 1u - App_LedWave_Front;
+        App_LedWave_Load(&App_LedWave_Buf[App_LedWave_Front]);
+        App_LedWave_Pending = DEF_NO;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* LED waveform playback: a precomputed LED pattern, one on/off mask per time slot over the hyperperiod, is
+* played out by the DMA with no CPU involvement. The pattern is compiled into one PSOR and one PCOR word per
+* slot and per GPIO port; FTM2 paces the slots and its channel 0 requests a chain of DMA channels, which write
+* the words of the slot to the port registers and wrap back to slot 0 after the hyperperiod. Only the LED pins
+* are written, the other pins of the ports keep their state.
+*
+* A new pattern is compiled into the second buffer while the first one plays, then handed over either at once
+* (restarting at slot 0) or at the end of the current hyperperiod, so that the pattern in progress is never
+* cut. A steady pattern is written to the pins once and stops the DMA.
+*
+* FTM2 and DMA channels APP_CFG_LEDWAVE_DMA_CH to APP_CFG_LEDWAVE_DMA_CH + 2 * APP_CFG_LEDWAVE_PORT_MAX - 1 are
+* used exclusively. FTM2 stops in VLPS/LLS: a pattern that plays holds the app_lowpwr stop lock.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_LEDWAVE_H
+#define  APP_LEDWAVE_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_LEDWAVE_SLOT_MAX                               /* Slots per hyperperiod, at most 511 (linked CITER).   */
+#define  APP_CFG_LEDWAVE_SLOT_MAX                100u
+#endif
+
+#ifndef  APP_CFG_LEDWAVE_PORT_MAX                               /* GPIO ports per pattern (FRDM-K64F LEDs: PTB, PTE).   */
+#define  APP_CFG_LEDWAVE_PORT_MAX                  2u
+#endif
+
+#ifndef  APP_CFG_LEDWAVE_DMA_CH                                 /* First DMA channel, above the PIT-triggered 0..3.     */
+#define  APP_CFG_LEDWAVE_DMA_CH                    4u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*
+* Note(s) : (1) Bit n of a mask drives the LED on PinTbl[n] (active low): set, the LED is on for the slot.
+*               The caller's tables are compiled by App_LedWave_Play() and not used afterwards.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_ledwave_pat {
+    const  CPU_INT32U  *PinTbl;                                 /* GPIO pins of the LEDs.                               */
+    CPU_INT08U          PinNbr;                                 /* At most 8.                                           */
+    const  CPU_INT08U  *MaskTbl;                                /* One mask per slot, see Note #1.                      */
+    CPU_INT16U          SlotNbr;                                /* Hyperperiod, in slots.                               */
+} APP_LEDWAVE_PAT;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_LedWave_Init (CPU_INT16U              slot_ms);
+
+CPU_BOOLEAN  App_LedWave_Play (const APP_LEDWAVE_PAT  *p_pat,
+                               CPU_BOOLEAN             at_once);
+
+void         App_LedWave_Stop (void);
+
+#endif
@@ -0,0 +1,367 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Logic-analyzer capture.
+* The tap may run on a fast port and on a kernel-aware one that it preempts: the timestamp, the level read and
+* the append are done with PRIMASK set (every interrupt masked, fast ones included) for the few tens of cycles
+* they take, so the records are in time order and never interleaved. The levels are read from PDIR after the
+* timestamp: two edges closer than the interrupt latency leave the levels unchanged, which is counted as a
+* glitch instead of a record.
+*
+* The timestamp timer is 32 bits: a gap longer than one wrap (35 s at 120 MHz) between two edges is recorded
+* modulo the wrap. The capture stops by itself when the buffer cannot hold a longest record any more; the edges
+* refused then are counted as lost.
+*
+* The tap runs from SRAM (app_ramfunc.h) and stamps with the inline cycle counter read (app_ts.h): no flash
+* fetch and no call between the interrupt entry and the timestamp.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+#include  <board.h>
+#include  <fsl_gpio_common.h>
+
+#include  "app_logcap.h"
+#include  "app_portisr.h"
+#include  "app_ramfunc.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_LOGCAP_REC_MAX                        6u           /* Longest record: 32-bit delta + 8 level bits          */
+#define  APP_LOGCAP_IRQC_EITHER                  0xBu           /* PORT_PCR[IRQC] encoding                              */
+#define  APP_LOGCAP_DUMP_LINE                     32u           /* Bytes per LCD line                                   */
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_logcap_ch {
+    GPIO_Type   *GPIO_Ptr;
+    CPU_INT32U   PinMask;
+    CPU_CHAR    *NamePtr;
+} APP_LOGCAP_CH;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_LOGCAP_CH         App_LogCap_Ch[APP_CFG_LOGCAP_CH_MAX];
+static  CPU_INT08U            App_LogCap_ChNbr;
+
+static  CPU_INT08U            App_LogCap_Buf[APP_CFG_LOGCAP_BUF_SIZE];
+static  CPU_INT32U            App_LogCap_BufIx;                 /* Tap only while on.                                   */
+static  volatile  CPU_BOOLEAN App_LogCap_On;
+static  CPU_TS_TMR            App_LogCap_PrevTS;
+static  CPU_INT08U            App_LogCap_PrevLevels;
+static  CPU_INT08U            App_LogCap_InitLevels;
+static  CPU_INT32U            App_LogCap_GlitchCtr;
+static  CPU_INT32U            App_LogCap_LostCtr;
+static  CPU_INT32U            App_LogCap_TS_Freq;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void        App_LogCap_Tap    (CPU_INT08U  port,
+                                                    CPU_INT32U  pins);
+
+APP_RAMFUNC  static  CPU_INT08U  App_LogCap_Levels (void);
+
+
+/*
+*********************************************************************************************************
+*                                         App_LogCap_ChAdd()
+*
+* Description : Adds an input to the capture and sets its pin interrupt on either edge. Call after OSA_Init(),
+*               before App_LogCap_Start(); channel i is level bit i in the records.
+*
+* Argument(s) : pin         GPIO pin of the input.
+*               p_name      signal name in the waveform (no comma nor space).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LogCap_ChAdd (CPU_INT32U   pin,
+                        CPU_CHAR    *p_name)
+{
+    APP_LOGCAP_CH  *p_ch;
+    PORT_Type      *p_port;
+    CPU_INT32U      ix;
+    CPU_INT32U      pcr;
+
+
+    if (App_LogCap_ChNbr >= APP_CFG_LOGCAP_CH_MAX) {
+        return;
+    }
+    ix             =  GPIO_EXTRACT_PIN(pin);
+    p_ch           = &App_LogCap_Ch[App_LogCap_ChNbr];
+    p_ch->GPIO_Ptr = (GPIO_Type *)g_gpioBaseAddr[GPIO_EXTRACT_PORT(pin)];
+    p_ch->PinMask  =  DEF_BIT(ix);
+    p_ch->NamePtr  =  p_name;
+    App_LogCap_ChNbr++;
+
+    p_port          = (PORT_Type *)g_portBaseAddr[GPIO_EXTRACT_PORT(pin)];
+    pcr             =  p_port->PCR[ix] & ~(PORT_PCR_IRQC_MASK | PORT_PCR_ISF_MASK);
+    p_port->PCR[ix] =  pcr | PORT_PCR_IRQC(APP_LOGCAP_IRQC_EITHER) | PORT_PCR_ISF_MASK;
+
+    App_PortISR_TapSet(pin, App_LogCap_Tap);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_LogCap_Start()
+*
+* Description : Empties the buffer and starts recording from the current levels.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LogCap_Start (void)
+{
+    CPU_INT32U  primask;
+
+
+    App_TS_Init();
+    App_LogCap_TS_Freq = App_TS_Freq;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    App_LogCap_BufIx      = 0u;
+    App_LogCap_GlitchCtr  = 0u;
+    App_LogCap_LostCtr    = 0u;
+    App_LogCap_PrevTS     = App_TS_Rd32();
+    App_LogCap_InitLevels = App_LogCap_Levels();
+    App_LogCap_PrevLevels = App_LogCap_InitLevels;
+    App_LogCap_On         = DEF_ON;
+    __set_PRIMASK(primask);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LogCap_Stop()
+*
+* Description : Stops recording; the buffer is kept until the next App_LogCap_Start().
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LogCap_Stop (void)
+{
+    App_LogCap_On = DEF_OFF;                                    /* No tap can be half-way: it runs with PRIMASK set     */
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LogCap_IsOn()
+*
+* Description : Tells whether the capture is still recording (it stops by itself when the buffer is full).
+*
+* Argument(s) : none.
+*
+* Return(s)   : DEF_ON while recording, DEF_OFF otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_LogCap_IsOn (void)
+{
+    return (App_LogCap_On);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LogCap_Dump()
+*
+* Description : Streams the capture on the serial port in the format of app_logcap.h. Call after the capture
+*               stopped.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LogCap_Dump (void)
+{
+    CPU_INT32U  ix;
+    CPU_INT32U  n;
+    CPU_INT08U  i;
+    CPU_INT32U  len;
+    char        tmp[8u + APP_LOGCAP_DUMP_LINE * 2u];
+
+
+    sprintf(tmp, "LOGCAP %u %u %02x %u %u %u ",
+            (unsigned)App_LogCap_TS_Freq,
+            (unsigned)App_LogCap_ChNbr,
+            (unsigned)App_LogCap_InitLevels,
+            (unsigned)App_LogCap_BufIx,
+            (unsigned)App_LogCap_GlitchCtr,
+            (unsigned)App_LogCap_LostCtr);
+    APP_TRACE_DBG(( tmp ));
+    for (i = 0u; i < App_LogCap_ChNbr; i++) {
+        APP_TRACE_DBG(( (i == 0u) ? "" : "," ));
+        APP_TRACE_DBG(( App_LogCap_Ch[i].NamePtr ));
+    }
+    APP_TRACE_DBG(( "\n\r" ));
+
+    for (ix = 0u; ix < App_LogCap_BufIx; ix += n) {
+        n = App_LogCap_BufIx - ix;
+        if (n > APP_LOGCAP_DUMP_LINE) {
+            n = APP_LOGCAP_DUMP_LINE;
+        }
+        len = (CPU_INT32U)sprintf(tmp, "LCD ");
+        for (i = 0u; i < n; i++) {
+            len += (CPU_INT32U)sprintf(&tmp[len], "%02x", (unsigned)App_LogCap_Buf[ix + i]);
+        }
+        sprintf(&tmp[len], "\n\r");
+        APP_TRACE_DBG(( tmp ));
+    }
+    APP_TRACE_DBG(( "LOGCAP END\n\r" ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LogCap_Run()
+*
+* Description : Records for a given time or until the buffer is full, then streams the capture.
+*
+* Argument(s) : dur_ms      capture time, in ms.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_LogCap_Run (CPU_INT32U  dur_ms)
+{
+    OS_ERR  os_err;
+
+
+    App_LogCap_Start();
+    while ((dur_ms > 0u) && (App_LogCap_On == DEF_ON)) {        /* Poll for a full buffer every 100 ms                  */
+        if (dur_ms > 100u) {
+            OSTimeDlyHMSM(0u, 0u, 0u, 100u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+            dur_ms -= 100u;
+        } else {
+            OSTimeDlyHMSM(0u, 0u, 0u, dur_ms, OS_OPT_TIME_HMSM_STRICT, &os_err);
+            dur_ms  = 0u;
+        }
+    }
+    App_LogCap_Stop();
+    App_LogCap_Dump();
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          App_LogCap_Tap()
+*
+* Description : PORT tap: appends one record with the timestamp and levels of all channels. No kernel call.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void  App_LogCap_Tap (CPU_INT08U  port,
+                                           CPU_INT32U  pins)
+{
+    CPU_INT32U  primask;
+    CPU_TS_TMR  ts;
+    CPU_INT08U  levels;
+    CPU_INT64U  val;
+    CPU_INT32U  ix;
+
+
+    (void)port;
+    (void)pins;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ts = App_TS_Rd32();
+    if (App_LogCap_On == DEF_ON) {
+        levels = App_LogCap_Levels();
+        if (levels == App_LogCap_PrevLevels) {
+            App_LogCap_GlitchCtr++;                             /* Pulse shorter than the latency: no visible change    */
+        } else if (App_LogCap_BufIx + APP_LOGCAP_REC_MAX > APP_CFG_LOGCAP_BUF_SIZE) {
+            App_LogCap_LostCtr++;
+            App_LogCap_On = DEF_OFF;
+        } else {
+            val = ((CPU_INT64U)(CPU_TS_TMR)(ts - App_LogCap_PrevTS) << App_LogCap_ChNbr) | levels;
+            ix  =  App_LogCap_BufIx;
+            while (val >= 0x80u) {                              /* LEB128: 7 bits per byte, low bits first              */
+                App_LogCap_Buf[ix++] = (CPU_INT08U)(val | 0x80u);
+                val >>= 7u;
+            }
+            App_LogCap_Buf[ix++]  = (CPU_INT08U)val;
+            App_LogCap_BufIx      = ix;
+            App_LogCap_PrevTS     = ts;
+            App_LogCap_PrevLevels = levels;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+
+APP_RAMFUNC  static  CPU_INT08U  App_LogCap_Levels (void)
+{
+    CPU_INT08U  levels;
+    CPU_INT08U  i;
+
+
+    levels = 0u;
+    for (i = 0u; i < App_LogCap_ChNbr; i++) {
+        if ((App_LogCap_Ch[i].GPIO_Ptr->PDIR & App_LogCap_Ch[i].PinMask) != 0u) {
+            levels |= (CPU_INT08U)(1u << i);
+        }
+    }
+    return (levels);
+}
@@ -0,0 +1,78 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Logic-analyzer capture: every edge on up to APP_CFG_LOGCAP_CH_MAX GPIO inputs is recorded in RAM with a CPU
+* timestamp (one CPU clock), from the PORT interrupt tap of app_portisr.c, at the full edge rate. The records
+* are delta + varint encoded, 2 to 3 bytes for edges a few ms apart, so a 16 KB buffer holds thousands of
+* edges. After the capture the buffer is streamed as hex text on the serial port; tools/logcap2vcd.c turns
+* the serial log into a VCD waveform (GTKWave, PulseView, ...).
+*
+* Stream format (one line each, amid the other trace output):
+*   LOGCAP <ts_hz> <ch_nbr> <init_levels> <byte_nbr> <glitches> <lost> <name0>,<name1>,...
+*   LCD <hex bytes, up to 32 per line>
+*   LOGCAP END
+* Each record is one unsigned LEB128 varint (7 bits per byte, low bits first, bit 7 set if more bytes follow)
+* of (delta << ch_nbr) | levels: delta is the time since the previous record (the start for the first one) in
+* timestamp counts, bit i of levels is the level of channel i after the edge.
+*
+* Channel pins do not need to be fast ports and may have their own handler (app_debounce.c, a sonar ISR): the
+* tap runs before it. A debounced switch is masked while it settles, so its bounces are not recorded.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_LOGCAP_H
+#define  APP_LOGCAP_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_LOGCAP_CH_MAX                                  /* At most 8 (one level bit each).                      */
+#define  APP_CFG_LOGCAP_CH_MAX                     4u
+#endif
+
+#ifndef  APP_CFG_LOGCAP_BUF_SIZE                                /* Capture buffer, in bytes.                            */
+#define  APP_CFG_LOGCAP_BUF_SIZE               16384u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_LogCap_ChAdd (CPU_INT32U   pin,
+                               CPU_CHAR    *p_name);
+
+void         App_LogCap_Start (void);
+
+void         App_LogCap_Stop  (void);
+
+CPU_BOOLEAN  App_LogCap_IsOn  (void);
+
+void         App_LogCap_Dump  (void);
+
+void         App_LogCap_Run   (CPU_INT32U   dur_ms);
+
+#endif
@@ -0,0 +1,509 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Tickless idle.
+* The idle task hook looks up the nearest kernel timeout (first entry of every tick wheel spoke, and the next
+* timer task update), then, with interrupts disabled:
+*   - below APP_CFG_LOWPWR_STOP_MIN_TICKS it only sleeps (WAIT), the SysTick keeps running;
+*   - otherwise it stops the SysTick, starts LPTMR0 (1 kHz LPO) for the timeout and enters VLPS or LLS. On
+*     wake-up the elapsed LPTMR count is posted to the tick task as kernel ticks, between OSIntEnter() and
+*     OSIntExit() so that the posts only make the tick task ready: the hook keeps interrupts disabled and the
+*     context switch is pended. The tick counter and the delays only catch up when the tick task runs, after
+*     the ISR that woke the MCU: that ISR, and a task it readies at a higher priority than the tick task, may
+*     still see the tick of the stop.
+* The skipped ticks are rounded down to whole LPTMR counts: each stop loses less than one tick of phase.
+* While the stop lock is held (e.g. an input capture running on LPTMR0 or on a clock that stops) the hook
+* only uses WAIT.
+*
+* Note(s) : (1) The CPU usage of the statistic task no longer means much: the idle counter only increments once
+*               per wake-up.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  "fsl_interrupt_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+
+#if (APP_CFG_LOWPWR_EN == DEF_ENABLED)
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_LOWPWR_LPTMR_HZ                    1000u           /* LPO clock                                            */
+#define  APP_LOWPWR_LPTMR_MAX               0xFFFFu             /* 16-bit compare                                       */
+
+#define  APP_LOWPWR_STOPM_VLPS                     2u           /* SMC_PMCTRL[STOPM] encodings                          */
+#define  APP_LOWPWR_STOPM_LLS                      3u
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_INT08U   App_LowPwr_ModeMax;
+static  CPU_INT16U   App_LowPwr_ReportPeriod_s;
+
+static  CPU_INT32U   App_LowPwr_Res_ms[APP_LOWPWR_MODE_NBR];    /* Residency since the previous report, in ms.          */
+static  CPU_INT32U   App_LowPwr_WakeCtr[APP_LOWPWR_MODE_NBR];
+static  CPU_INT64U   App_LowPwr_WaitCyc;                        /* WAIT residency, in SysTick counts.                   */
+static  OS_TICK      App_LowPwr_ReportTick;                     /* Tick of the previous report.                         */
+static  CPU_INT08U   App_LowPwr_StopLockCtr;                    /* Stop modes are allowed when 0.                       */
+
+static  OS_TCB       App_LowPwr_TaskTCB;
+static  CPU_STK      App_LowPwr_TaskStk[APP_CFG_LOWPWR_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void     App_LowPwr_Task      (void  *p_arg);
+
+static  void     App_LowPwr_IdleHook  (void);
+
+static  OS_TICK  App_LowPwr_NextTimeout (void);
+
+static  void     App_LowPwr_Wait      (OS_TICK  next);
+
+static  void     App_LowPwr_Stop      (CPU_INT08U  mode,
+                                       OS_TICK     next);
+
+static  void     App_LowPwr_LPTMR_ISR (void);
+
+
+/*
+*********************************************************************************************************
+*                                          App_LowPwr_Init()
+*
+* Description : Sets up the stop modes and installs the tickless idle hook. Call after OSA_Init().
+*
+* Argument(s) : mode_max            deepest power mode allowed, APP_LOWPWR_MODE_WAIT to APP_LOWPWR_MODE_LLS.
+*               report_period_s     interval between two residency reports, in seconds (0 = no report task).
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) SMC_PMPROT is write-once after reset: if the startup code already wrote it without the
+*                   AVLP/ALLS bits, the stop request is ignored and the MCU only sleeps.
+*********************************************************************************************************
+*/
+
+void  App_LowPwr_Init (CPU_INT08U  mode_max,
+                       CPU_INT16U  report_period_s)
+{
+    OS_ERR  os_err;
+    CPU_SR_ALLOC();
+
+
+    App_LowPwr_ModeMax        = (mode_max < APP_LOWPWR_MODE_NBR) ? mode_max : APP_LOWPWR_MODE_LLS;
+    App_LowPwr_ReportPeriod_s = report_period_s;
+
+    SMC->PMPROT  = SMC_PMPROT_AVLP_MASK | SMC_PMPROT_ALLS_MASK; /* Allow VLPS and LLS, see Note #1.                     */
+
+    SIM->SCGC5  |= SIM_SCGC5_LPTMR_MASK;                        /* LPTMR0 is set up at each stop                        */
+    LLWU->ME     = LLWU_ME_WUME0_MASK;                          /* LPTMR0 is LLWU module 0: wakes up from LLS           */
+
+    INT_SYS_InstallHandler(LPTMR0_IRQn, App_LowPwr_LPTMR_ISR);
+    INT_SYS_InstallHandler(LLWU_IRQn,   App_LowPwr_LPTMR_ISR);  /* LLS wake-up only comes from LPTMR0 here              */
+    INT_SYS_EnableIRQ(LPTMR0_IRQn);
+    INT_SYS_EnableIRQ(LLWU_IRQn);
+
+    App_LowPwr_ReportTick = OSTimeGet(&os_err);
+
+    APP_CRITICAL_ENTER();
+    OS_AppIdleTaskHookPtr = App_LowPwr_IdleHook;
+    APP_CRITICAL_EXIT();
+
+    if (report_period_s == 0u) {
+        return;
+    }
+
+    OSTaskCreate(&App_LowPwr_TaskTCB,
+                 "Low power report",
+                  App_LowPwr_Task,
+                  0u,
+                  APP_CFG_LOWPWR_TASK_PRIO,
+                 &App_LowPwr_TaskStk[0u],
+                 (APP_CFG_LOWPWR_TASK_STK_SIZE / 10u),
+                  APP_CFG_LOWPWR_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_LowPwr_Report()
+*
+* Description : Prints the share of time spent in each power state since the previous report, then restarts
+*               the measurement. RUN is what is left of the elapsed ticks.
+*
+* Argument(s) : none.
+*
+* Return(s)   : time spent in RUN since the previous report, in ms.
+*********************************************************************************************************
+*/
+
+CPU_INT32U  App_LowPwr_Report (void)
+{
+    static  const  CPU_CHAR  *mode_name[APP_LOWPWR_MODE_NBR] = { "run", "wait", "vlps", "lls" };
+    CPU_INT32U   res_ms[APP_LOWPWR_MODE_NBR];
+    CPU_INT32U   wake_ctr[APP_LOWPWR_MODE_NBR];
+    CPU_INT32U   span_ms;
+    CPU_INT32U   low_ms;
+    CPU_INT32U   permil;
+    OS_TICK      now;
+    OS_ERR       os_err;
+    CPU_INT08U   i;
+    char         tmp[96];
+    CPU_SR_ALLOC();
+
+
+    now = OSTimeGet(&os_err);
+    APP_CRITICAL_ENTER();                                       /* Take a consistent snapshot and restart.              */
+    for (i = 0u; i < APP_LOWPWR_MODE_NBR; i++) {
+        res_ms[i]                = App_LowPwr_Res_ms[i];
+        wake_ctr[i]              = App_LowPwr_WakeCtr[i];
+        App_LowPwr_Res_ms[i]     = 0u;
+        App_LowPwr_WakeCtr[i]    = 0u;
+    }
+    res_ms[APP_LOWPWR_MODE_WAIT] = (CPU_INT32U)((App_LowPwr_WaitCyc * 1000u) /
+                                                ((CPU_INT64U)OSCfg_TickRate_Hz * (SysTick->LOAD + 1u)));
+    App_LowPwr_WaitCyc    = 0u;
+    span_ms               = (CPU_INT32U)(((CPU_INT64U)(now - App_LowPwr_ReportTick) * 1000u) / OSCfg_TickRate_Hz);
+    App_LowPwr_ReportTick = now;
+    APP_CRITICAL_EXIT();
+
+    if (span_ms == 0u) {
+        return (0u);
+    }
+    low_ms = res_ms[APP_LOWPWR_MODE_WAIT] + res_ms[APP_LOWPWR_MODE_VLPS] + res_ms[APP_LOWPWR_MODE_LLS];
+    res_ms[APP_LOWPWR_MODE_RUN] = (low_ms < span_ms) ? (span_ms - low_ms) : 0u;
+
+    for (i = 0u; i < APP_LOWPWR_MODE_NBR; i++) {
+        permil = (CPU_INT32U)(((CPU_INT64U)res_ms[i] * 1000u) / span_ms);
+        sprintf(tmp, "%-4.4s: %3u.%u%% (%u ms, %u entries)\n\r",
+                mode_name[i],
+                (unsigned)(permil / 10u),
+                (unsigned)(permil % 10u),
+                (unsigned)res_ms[i],
+                (unsigned)wake_ctr[i]);
+        APP_TRACE_DBG(( tmp ));
+    }
+    return (res_ms[APP_LOWPWR_MODE_RUN]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                App_LowPwr_StopLock() / App_LowPwr_StopUnlock()
+*
+* Description : Forbid / allow again the stop modes, e.g. while a measurement needs the bus clock or LPTMR0.
+*               Calls nest; both may be called from an ISR. App_LowPwr_StopLock() runs from SRAM, for the
+*               APP_RAMFUNC switch path of app_debounce.c.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  void  App_LowPwr_StopLock (void)
+{
+    CPU_INT32U  basepri;
+
+
+    APP_IRQ_KA_MASK(basepri);                                   /* No flash call, see app_irq.h                         */
+    App_LowPwr_StopLockCtr++;
+    APP_IRQ_KA_UNMASK(basepri);
+}
+
+
+void  App_LowPwr_StopUnlock (void)
+{
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    if (App_LowPwr_StopLockCtr > 0u) {
+        App_LowPwr_StopLockCtr--;
+    }
+    APP_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_LowPwr_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_LowPwr_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_LowPwr_Report();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_LowPwr_IdleHook()
+*
+* Description : Idle task hook: chooses the power mode for the time left until the next kernel timeout.
+*               Runs with interrupts disabled so that no event can slip in between the look-up and the WFI; a
+*               pending interrupt still ends the WFI and is serviced once the hook returns.
+*
+* Note(s)     : (1) CPU_INT_DIS()/CPU_INT_EN() are not measured by uC/CPU: the masked time here is mostly sleep,
+*                   it would hide every other section in the interrupts-disabled maximum (app_intdis.h).
+*********************************************************************************************************
+*/
+
+static  void  App_LowPwr_IdleHook (void)
+{
+    OS_TICK  next;
+    CPU_SR_ALLOC();
+
+
+    CPU_INT_DIS();                                              /* See Note #1                                          */
+    next = App_LowPwr_NextTimeout();
+    if ((next < APP_CFG_LOWPWR_STOP_MIN_TICKS) ||
+        (App_LowPwr_ModeMax == APP_LOWPWR_MODE_WAIT) ||
+        (App_LowPwr_StopLockCtr > 0u)) {
+        App_LowPwr_Wait(next);
+    } else {
+        App_LowPwr_Stop(App_LowPwr_ModeMax, next);
+    }
+    CPU_INT_EN();
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_LowPwr_NextTimeout()
+*
+* Description : Returns the number of ticks until the kernel has something to do on its own. Each tick wheel
+*               spoke is sorted by remaining ticks, so only its first entry is looked at. The timer task is
+*               released by the tick every OSTmrUpdateCtr ticks.
+*
+* Note(s)     : (1) Must be called with interrupts disabled.
+*********************************************************************************************************
+*/
+
+static  OS_TICK  App_LowPwr_NextTimeout (void)
+{
+    OS_TCB      *p_tcb;
+    OS_TICK      next;
+    OS_TICK      remain;
+    OS_OBJ_QTY   i;
+
+
+    next = (OS_TICK)DEF_INT_32U_MAX_VAL;
+    for (i = 0u; i < OSCfg_TickWheelSize; i++) {
+        p_tcb = OSCfg_TickWheel[i].FirstPtr;
+        if (p_tcb != (OS_TCB *)0) {
+            remain = p_tcb->TickCtrMatch - OSTickCtr;
+            if (remain < next) {
+                next = remain;
+            }
+        }
+    }
+#if (OS_CFG_TMR_EN > 0u)
+    if ((OS_TICK)OSTmrUpdateCtr < next) {
+        next = (OS_TICK)OSTmrUpdateCtr;
+    }
+#endif
+    return (next);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LowPwr_Wait()
+*
+* Description : Sleeps until the next interrupt (SysTick included). The residency is measured in SysTick
+*               counts, the core clock being the SysTick clock.
+*********************************************************************************************************
+*/
+
+static  void  App_LowPwr_Wait (OS_TICK  next)
+{
+    CPU_INT32U  reload;
+    CPU_INT32U  before;
+    CPU_INT32U  after;
+
+
+    (void)next;
+
+    reload = SysTick->LOAD + 1u;
+    (void)SysTick->CTRL;                                        /* Clear COUNTFLAG                                      */
+    before = SysTick->VAL;
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    __DSB();
+    __WFI();
+    after  = SysTick->VAL;
+                                                                /* The down-counter wrapped at most once: a SysTick     */
+    if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0u) {   /* interrupt ends the WFI.                              */
+        App_LowPwr_WaitCyc += before + (reload - after);
+    } else {
+        App_LowPwr_WaitCyc += before - after;
+    }
+    App_LowPwr_WakeCtr[APP_LOWPWR_MODE_WAIT]++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_LowPwr_Stop()
+*
+* Description : Stops the SysTick, sleeps in VLPS or LLS for at most 'next' ticks and replays the elapsed ticks.
+*
+* Note(s)     : (1) The LPTMR compare matches when CNR equals CMR and increments, hence CMR = count - 1.
+*
+*               (2) CNR is latched by writing it before the read.
+*
+*               (3) A stop entered from PEE exits in PBE: the PLL relocks but the MCG stays on the external
+*                   reference until MCG_C1[CLKS] selects the PLL again. Wait for LOCK0, give back the clock
+*                   source of the stop and wait for MCG_S[CLKST] before touching the peripherals clocked from it.
+*
+*               (4) The app configuration of LPTMR0 (clock source, mode, compare) is put back, stopped.
+*
+*               (5) At task level OSTimeTick() posts to the tick task and calls OSSched(), which would switch
+*                   context and enable interrupts inside the hook. Inside OSIntEnter()/OSIntExit() the posts only
+*                   make the tick task ready; OSIntExit() pends the switch and gives back the masking of the
+*                   hook, so the tick task runs once the hook enables interrupts again.
+*********************************************************************************************************
+*/
+
+static  void  App_LowPwr_Stop (CPU_INT08U  mode,
+                               OS_TICK     next)
+{
+    CPU_INT32U  sleep_ms;
+    CPU_INT32U  elapsed_ms;
+    CPU_INT32U  ticks;
+    CPU_INT08U  clks;
+    CPU_INT08U  clkst;
+    CPU_INT32U  app_csr;
+    CPU_INT32U  app_psr;
+    CPU_INT32U  app_cmr;
+
+
+    sleep_ms = (CPU_INT32U)(((CPU_INT64U)next * APP_LOWPWR_LPTMR_HZ) / OSCfg_TickRate_Hz);
+    if (sleep_ms > APP_LOWPWR_LPTMR_MAX) {
+        sleep_ms = APP_LOWPWR_LPTMR_MAX;
+    }
+
+    SysTick->CTRL &= ~(SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
+
+    app_csr     = LPTMR0->CSR & ~(LPTMR_CSR_TCF_MASK | LPTMR_CSR_TEN_MASK);
+    app_psr     = LPTMR0->PSR;
+    app_cmr     = LPTMR0->CMR;
+
+    LPTMR0->CSR = 0u;                                           /* Reset CNR                                            */
+    LPTMR0->PSR = LPTMR_PSR_PCS(1u) | LPTMR_PSR_PBYP_MASK;      /* 1 kHz LPO, runs in VLPS/LLS                          */
+    LPTMR0->CMR = sleep_ms - 1u;                                /* See Note #1.                                         */
+    LPTMR0->CSR = LPTMR_CSR_TIE_MASK | LPTMR_CSR_TEN_MASK;
+
+    clks         = MCG->C1 & MCG_C1_CLKS_MASK;
+    clkst        = MCG->S  & MCG_S_CLKST_MASK;
+    SMC->PMCTRL  = (SMC->PMCTRL & ~SMC_PMCTRL_STOPM_MASK)
+                 | SMC_PMCTRL_STOPM((mode == APP_LOWPWR_MODE_LLS) ? APP_LOWPWR_STOPM_LLS : APP_LOWPWR_STOPM_VLPS);
+    (void)SMC->PMCTRL;                                          /* Make sure the write is done before the WFI           */
+    SCB->SCR    |= SCB_SCR_SLEEPDEEP_Msk;
+    __DSB();
+    __WFI();
+    SCB->SCR    &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+    if (clkst == MCG_S_CLKST(3u)) {                             /* PEE, see Note #3.                                    */
+        while ((MCG->S & MCG_S_LOCK0_MASK) == 0u) {
+            ;
+        }
+    }
+    MCG->C1 = (MCG->C1 & ~MCG_C1_CLKS_MASK) | clks;
+    while ((MCG->S & MCG_S_CLKST_MASK) != clkst) {
+        ;
+    }
+
+    if ((LPTMR0->CSR & LPTMR_CSR_TCF_MASK) != 0u) {             /* Full sleep                                           */
+        elapsed_ms = sleep_ms;
+    } else {                                                    /* Woken up early by another interrupt                  */
+        LPTMR0->CNR = 0u;                                       /* See Note #2.                                         */
+        elapsed_ms  = LPTMR0->CNR & APP_LOWPWR_LPTMR_MAX;
+    }
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;                           /* Stop, clear the flag                                 */
+    LPTMR0->PSR = app_psr;                                      /* See Note #4.                                         */
+    LPTMR0->CMR = app_cmr;
+    LPTMR0->CSR = app_csr;
+    NVIC_ClearPendingIRQ(LPTMR0_IRQn);
+    NVIC_ClearPendingIRQ(LLWU_IRQn);
+
+    ticks = (CPU_INT32U)(((CPU_INT64U)elapsed_ms * OSCfg_TickRate_Hz) / APP_LOWPWR_LPTMR_HZ);
+    OSIntEnter();                                               /* Posts without scheduling, see Note #5.               */
+    while (ticks > 0u) {                                        /* Replay the skipped ticks                             */
+        OSTimeTick();
+        ticks--;
+    }
+    OSIntExit();                                                /* Interrupts stay disabled: the switch is pended       */
+
+    SysTick->VAL   = 0u;                                        /* Restart a full tick period                           */
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    App_LowPwr_Res_ms[mode]  += elapsed_ms;
+    App_LowPwr_WakeCtr[mode]++;
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_LowPwr_LPTMR_ISR()
+*
+* Description : LPTMR0 and LLWU handler: only clears the compare flag (no kernel service is called). Normally
+*               the flag is already handled by App_LowPwr_Stop(), which runs with interrupts disabled from the
+*               look-up to the end of the tick replay.
+*********************************************************************************************************
+*/
+
+static  void  App_LowPwr_LPTMR_ISR (void)
+{
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;
+}
+
+#endif
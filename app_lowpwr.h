@@ -0,0 +1,105 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Tickless idle: when every task is blocked the idle task programs LPTMR0 for the next kernel timeout, stops
+* the SysTick and enters WAIT, VLPS or LLS depending on how long it may sleep. On wake-up (LPTMR or any enabled
+* interrupt, e.g. the PORTA/PORTC switches) the ticks that were skipped are replayed to the kernel. The time
+* spent in each power state is printed periodically on the serial port.
+*
+* LPTMR0 is shared: an app may use it while it holds the stop lock (App_LowPwr_StopLock()), its configuration
+* is restored after every stop.
+* Disable with:  #define  APP_CFG_LOWPWR_EN  DEF_DISABLED  in app_cfg.h (e.g. while debugging, stop modes
+* drop the debugger connection)
+*********************************************************************************************************
+*/
+
+#ifndef  APP_LOWPWR_H
+#define  APP_LOWPWR_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_LOWPWR_EN
+#define  APP_CFG_LOWPWR_EN                       DEF_ENABLED
+#endif
+
+#ifndef  APP_CFG_LOWPWR_STOP_MIN_TICKS                          /* Shorter idle periods only use WAIT (SysTick kept).   */
+#define  APP_CFG_LOWPWR_STOP_MIN_TICKS             3u
+#endif
+
+#ifndef  APP_CFG_LOWPWR_TASK_PRIO
+#define  APP_CFG_LOWPWR_TASK_PRIO                (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_LOWPWR_TASK_STK_SIZE
+#define  APP_CFG_LOWPWR_TASK_STK_SIZE            256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              POWER MODES
+*
+* Note(s) : (1) VLPS and LLS stop the core and bus clocks; LPTMR0 keeps counting on the 1 kHz LPO.
+*
+*           (2) VLPS wakes up on any enabled interrupt, including the PORT pin interrupts.
+*
+*           (3) LLS only wakes up through the LLWU. LPTMR0 is enabled as LLWU module source; PORT pin interrupt
+*               flags are not set in LLS, so apps that rely on switch ISRs must stop at VLPS.
+*********************************************************************************************************
+*/
+
+#define  APP_LOWPWR_MODE_RUN                       0u
+#define  APP_LOWPWR_MODE_WAIT                      1u
+#define  APP_LOWPWR_MODE_VLPS                      2u
+#define  APP_LOWPWR_MODE_LLS                       3u
+#define  APP_LOWPWR_MODE_NBR                       4u
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+#if (APP_CFG_LOWPWR_EN == DEF_ENABLED)
+void        App_LowPwr_Init       (CPU_INT08U  mode_max,
+                                   CPU_INT16U  report_period_s);
+
+CPU_INT32U  App_LowPwr_Report     (void);
+
+APP_RAMFUNC                                                     /* In SRAM for the switch path, see app_ramfunc.h       */
+void        App_LowPwr_StopLock   (void);
+
+void        App_LowPwr_StopUnlock (void);
+#else
+#define  App_LowPwr_Init(mode_max, report_period_s)
+#define  App_LowPwr_Report()                     (0u)
+#define  App_LowPwr_StopLock()
+#define  App_LowPwr_StopUnlock()
+#endif
+
+#endif
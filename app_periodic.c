@@ -0,0 +1,143 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Drift-free periodic loops.
+* OSTimeDly(period, OS_OPT_TIME_PERIODIC) makes the kernel keep the release grid of the calling task (the
+* next match is the previous match plus the period). When the task is already past its next release, the
+* kernel returns no error and restarts the grid one period after the call: the task then wakes at least one
+* period after its release on the old grid. That is counted as an overrun, the slip is added to the phase
+* error and the new grid is taken as reference.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_periodic.h"
+
+
+/*
+*********************************************************************************************************
+*                                         App_Periodic_Init()
+*
+* Description : Initializes a periodic loop. The grid is aligned with the kernel at the first
+*               App_Periodic_Wait(), which may therefore return early once. Call again to change the period.
+*
+* Argument(s) : p_per       periodic loop descriptor.
+*               period_ms   period, in ms (rounded to ticks, at least one tick).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Periodic_Init (APP_PERIODIC  *p_per,
+                         CPU_INT32U     period_ms)
+{
+    p_per->Period     = (OS_TICK)((period_ms * OSCfg_TickRate_Hz + 500u) / 1000u);
+    if (p_per->Period == 0u) {
+        p_per->Period = 1u;
+    }
+    p_per->Release    = 0u;
+    p_per->Synced     = DEF_FALSE;
+    p_per->ReleaseCtr = 0u;
+    p_per->OverrunCtr = 0u;
+    p_per->LateMax    = 0u;
+    p_per->PhaseErr   = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Periodic_Wait()
+*
+* Description : Waits for the next release of a periodic loop. Call once per iteration, in place of the
+*               relative OSTimeDlyHMSM() at the end of the loop body.
+*
+* Argument(s) : p_per       periodic loop descriptor.
+*
+* Return(s)   : DEF_TRUE if the iteration overran its period (the loop restarts at once, one phase slip),
+*               DEF_FALSE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_Periodic_Wait (APP_PERIODIC  *p_per)
+{
+    OS_ERR   os_err;
+    OS_TICK  now;
+    OS_TICK  late;
+
+
+    OSTimeDly(p_per->Period, OS_OPT_TIME_PERIODIC, &os_err);
+    now = OSTimeGet(&os_err);
+
+    if (p_per->Synced == DEF_FALSE) {                           /* First release: take the kernel grid as reference.    */
+        p_per->Synced  = DEF_TRUE;
+        p_per->Release = now;
+        return (DEF_FALSE);
+    }
+
+    p_per->Release += p_per->Period;
+    late = now - p_per->Release;
+    if (late > (DEF_INT_32U_MAX_VAL / 2u)) {                    /* Woken early by OSTimeDlyResume(): resync next time.  */
+        p_per->Synced = DEF_FALSE;
+        return (DEF_FALSE);
+    }
+    p_per->ReleaseCtr++;
+
+    if (late >= p_per->Period) {                                /* Overrun: the kernel restarted the grid, see header.  */
+        p_per->OverrunCtr++;
+        p_per->PhaseErr += late;
+        p_per->Release   = now;
+        return (DEF_TRUE);
+    }
+
+    if (late > p_per->LateMax) {                                /* Released on time but run late (preempted).           */
+        p_per->LateMax = late;
+    }
+    return (DEF_FALSE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_Periodic_Report()
+*
+* Description : Prints the statistics of a periodic loop on the serial port.
+*
+* Argument(s) : p_per       periodic loop descriptor.
+*               p_name      name of the loop.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Periodic_Report (APP_PERIODIC  *p_per,
+                           CPU_CHAR      *p_name)
+{
+    char  tmp[128];
+
+
+    sprintf(tmp, "%s: period %u ticks, %u releases, %u overruns, phase error %u ticks, max lateness %u ticks\n\r",
+            p_name,
+            (unsigned)p_per->Period,
+            (unsigned)p_per->ReleaseCtr,
+            (unsigned)p_per->OverrunCtr,
+            (unsigned)p_per->PhaseErr,
+            (unsigned)p_per->LateMax);
+    APP_TRACE_DBG(( tmp ));
+}
@@ -0,0 +1,62 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Drift-free periodic loops: each iteration is released on an absolute tick grid (kernel periodic delay mode)
+* instead of sleeping a relative delay after the work, so execution time and preemption do not add up into
+* the period. Overruns and the accumulated phase error are counted.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_PERIODIC_H
+#define  APP_PERIODIC_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_periodic {
+    OS_TICK      Period;                                        /* Period, in ticks.                                    */
+    OS_TICK      Release;                                       /* Release tick of the current iteration.               */
+    CPU_BOOLEAN  Synced;                                        /* Grid aligned with the kernel.                        */
+    CPU_INT32U   ReleaseCtr;
+    CPU_INT32U   OverrunCtr;                                    /* Iterations that ran past their next release.         */
+    OS_TICK      LateMax;                                       /* Worst wake-up lateness, in ticks.                    */
+    CPU_INT32U   PhaseErr;                                      /* Phase lost to overruns since init, in ticks.         */
+} APP_PERIODIC;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_Periodic_Init   (APP_PERIODIC  *p_per,
+                                  CPU_INT32U     period_ms);
+
+CPU_BOOLEAN  App_Periodic_Wait   (APP_PERIODIC  *p_per);
+
+void         App_Periodic_Report (APP_PERIODIC  *p_per,
+                                  CPU_CHAR      *p_name);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Pin access benchmark.
+* The APP_PIN_*() side is measured twice: with the pin in a variable ("var" rows, the address is computed
+* inline) and with a literal pin ("const" rows, BOARD_GPIO_LED_BLUE and inPTB9: the single store or load).
+* The outputs end in their set state, the toggles are an even number.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+
+#include  <board.h>
+
+#include  "app_pin.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                           App_Pin_Bench()
+*
+* Description : Measures and prints the cost of set, clear, toggle and read through the KSDK GPIO driver and
+*               through app_pin.h, in CPU cycles per call. The "const" rows always drive the blue LED and read
+*               PTB9.
+*
+* Argument(s) : out_pin     output to drive (an LED: it ends off, set).
+*               in_pin      input to read.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Pin_Bench (CPU_INT32U  out_pin,
+                     CPU_INT32U  in_pin)
+{
+    CPU_INT32U  base10;
+    CPU_INT32U  rd_base10;
+    CPU_INT32U  cyc10;
+    char        tmp[80];
+
+
+    App_TS_Init();
+
+    APP_TS_BENCH(;, base10);
+    APP_TS_BENCH(App_TS_BenchSink += 1u, rd_base10);
+
+    sprintf(tmp, "Pin access cost (CPU cycles per call, %u MHz):\n\r", (unsigned)(App_TS_Freq / 1000000u));
+    APP_TRACE_DBG(( tmp ));
+
+    APP_TS_BENCH(GPIO_DRV_ClearPinOutput(out_pin), cyc10);
+    App_TS_BenchPrint("GPIO_DRV_ClearPin",  cyc10, base10);
+    APP_TS_BENCH(APP_PIN_CLR(out_pin), cyc10);
+    App_TS_BenchPrint("APP_PIN_CLR var",      cyc10, base10);
+    APP_TS_BENCH(APP_PIN_CLR(BOARD_GPIO_LED_BLUE), cyc10);
+    App_TS_BenchPrint("APP_PIN_CLR const",    cyc10, base10);
+    APP_TS_BENCH(GPIO_DRV_SetPinOutput(out_pin), cyc10);
+    App_TS_BenchPrint("GPIO_DRV_SetPin",      cyc10, base10);
+    APP_TS_BENCH(APP_PIN_SET(out_pin), cyc10);
+    App_TS_BenchPrint("APP_PIN_SET var",      cyc10, base10);
+    APP_TS_BENCH(APP_PIN_SET(BOARD_GPIO_LED_BLUE), cyc10);
+    App_TS_BenchPrint("APP_PIN_SET const",    cyc10, base10);
+    APP_TS_BENCH(GPIO_DRV_TogglePinOutput(out_pin), cyc10);
+    App_TS_BenchPrint("GPIO_DRV_TogglePin",   cyc10, base10);
+    APP_TS_BENCH(APP_PIN_TOGGLE(out_pin), cyc10);
+    App_TS_BenchPrint("APP_PIN_TOGGLE var",   cyc10, base10);
+    APP_TS_BENCH(APP_PIN_TOGGLE(BOARD_GPIO_LED_BLUE), cyc10);
+    App_TS_BenchPrint("APP_PIN_TOGGLE const", cyc10, base10);
+
+    APP_TS_BENCH(App_TS_BenchSink += GPIO_DRV_ReadPinInput(in_pin), cyc10);
+    App_TS_BenchPrint("GPIO_DRV_ReadPin",     cyc10, rd_base10);
+    APP_TS_BENCH(App_TS_BenchSink += APP_PIN_RD(in_pin), cyc10);
+    App_TS_BenchPrint("APP_PIN_RD var",       cyc10, rd_base10);
+    APP_TS_BENCH(App_TS_BenchSink += APP_PIN_RD(inPTB9), cyc10);
+    App_TS_BenchPrint("APP_PIN_RD const",     cyc10, rd_base10);
+}
@@ -0,0 +1,74 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Direct GPIO access for hot paths: the GPIO and PORT registers of a pin are computed from the pin value
+* itself (the port register blocks are evenly spaced), not looked up in g_gpioBaseAddr[]/g_portBaseAddr[].
+* With a constant pin (kGpioLED1, inPTB9, ...) the address and mask are compile-time constants, and set, clear
+* and toggle compile to one store, a read to one load and a bit extract, where GPIO_DRV_*() make a call, a
+* table look-up and a shift each time. A pin held in a variable still works, with the address computed
+* inline.
+*
+* Header only. App_Pin_Bench() (app_pin.c) prints both costs.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_PIN_H
+#define  APP_PIN_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+
+#include  <system_MK64F12.h>
+#include  <fsl_gpio_common.h>
+
+
+/*
+*********************************************************************************************************
+*                                           PIN DESCRIPTORS
+*
+* Note(s) : (1) 'pin' is a GPIO_MAKE_PIN() value; the macros evaluate it more than once.
+*********************************************************************************************************
+*/
+
+#define  APP_PIN_GPIO(pin)                      ((GPIO_Type *)(PTA_BASE   + ((CPU_INT32U)GPIO_EXTRACT_PORT(pin) * (PTB_BASE   - PTA_BASE))))
+#define  APP_PIN_PORT(pin)                      ((PORT_Type *)(PORTA_BASE + ((CPU_INT32U)GPIO_EXTRACT_PORT(pin) * (PORTB_BASE - PORTA_BASE))))
+#define  APP_PIN_IX(pin)                         ((CPU_INT32U)GPIO_EXTRACT_PIN(pin))
+#define  APP_PIN_MASK(pin)                       (1uL << APP_PIN_IX(pin))
+
+
+/*
+*********************************************************************************************************
+*                                           PIN OPERATIONS
+*********************************************************************************************************
+*/
+
+#define  APP_PIN_SET(pin)                        (APP_PIN_GPIO(pin)->PSOR = APP_PIN_MASK(pin))
+#define  APP_PIN_CLR(pin)                        (APP_PIN_GPIO(pin)->PCOR = APP_PIN_MASK(pin))
+#define  APP_PIN_TOGGLE(pin)                     (APP_PIN_GPIO(pin)->PTOR = APP_PIN_MASK(pin))
+#define  APP_PIN_RD(pin)                        ((APP_PIN_GPIO(pin)->PDIR >> APP_PIN_IX(pin)) & 1u)   /* 0 or 1, as GPIO_DRV_ReadPinInput()  */
+
+#define  APP_PIN_INT_CLR(pin)                    (APP_PIN_PORT(pin)->ISFR = APP_PIN_MASK(pin))
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  App_Pin_Bench (CPU_INT32U  out_pin,
+                     CPU_INT32U  in_pin);
+
+#endif
@@ -0,0 +1,263 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Polling pulse capture.
+* Each sample is one PDIR load and one CYCCNT load: the timestamp of an edge is the cycle counter read just
+* after the first sample that sees the new level, so an edge is known to within one sample period. Nothing
+* else is done per sample but the timeout and the gap compares.
+*
+* Without masking, an interrupt between two samples widens that window to its duration: the gap maximum shows
+* it. With masking (CPU_INT_DIS(), kernel-aware interrupts only, fast ISRs still run) the kernel tick is held
+* for up to both timeouts; only one pending tick is kept, the others are lost, which delays every timeout
+* and delay of the kernel. The masked time is not measured by uC/CPU (app_intdis.h): it would hide every
+* other section.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+#include  <board.h>
+#include  <fsl_gpio_common.h>
+
+#include  "app_intdis.h"
+#include  "app_pollcap.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_PollCap_Wait (APP_POLLCAP  *p_cap,
+                                       CPU_INT32U    level,
+                                       CPU_INT32U    t_start,
+                                       CPU_INT32U    timeout_cnts,
+                                       CPU_INT32U   *p_ts,
+                                       CPU_INT32U   *p_samples);
+
+
+/*
+*********************************************************************************************************
+*                                         App_PollCap_Init()
+*
+* Description : Resolves the PDIR register and mask of the input. Call after CPU_Init().
+*
+* Argument(s) : p_cap       capture to initialize.
+*               pin         GPIO pin of the input.
+*               int_dis     DEF_YES to mask the kernel-aware interrupts while capturing, see the file header.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PollCap_Init (APP_POLLCAP  *p_cap,
+                        CPU_INT32U    pin,
+                        CPU_BOOLEAN   int_dis)
+{
+    GPIO_Type  *p_gpio;
+
+
+    App_TS_Init();
+
+    p_gpio            = (GPIO_Type *)g_gpioBaseAddr[GPIO_EXTRACT_PORT(pin)];
+    p_cap->PDIR_Ptr   = &p_gpio->PDIR;
+    p_cap->Mask       =  DEF_BIT(GPIO_EXTRACT_PIN(pin));
+    p_cap->IntDis     =  int_dis;
+    p_cap->PulseCtr   =  0u;
+    p_cap->TimeoutCtr =  0u;
+    p_cap->SampleCtr  =  0u;
+    p_cap->SampleCnts =  0u;
+    p_cap->GapMax     =  0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_PollCap_Pulse()
+*
+* Description : Waits for the next rising edge, then for the falling edge, and returns the pulse width.
+*
+* Argument(s) : p_cap               capture.
+*               rise_timeout_us     longest wait for the rising edge, from the call.
+*               width_timeout_us    longest pulse.
+*               p_width_cnts        where to store the width, in cycle counter counts (app_ts.h conversions).
+*
+* Return(s)   : DEF_TRUE if a complete pulse was captured, DEF_FALSE on a timeout.
+*
+* Note(s)     : (1) A pin already high at the call is a pulse that started earlier: its end is waited for first,
+*                   within the rise timeout.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_PollCap_Pulse (APP_POLLCAP  *p_cap,
+                                CPU_INT32U    rise_timeout_us,
+                                CPU_INT32U    width_timeout_us,
+                                CPU_INT32U   *p_width_cnts)
+{
+    CPU_INT32U   cnts_per_us;
+    CPU_INT32U   t_start;
+    CPU_INT32U   t_rise;
+    CPU_INT32U   t_fall;
+    CPU_INT32U   samples;
+    CPU_BOOLEAN  ok;
+    CPU_SR_ALLOC();
+
+
+    cnts_per_us = App_TS_Freq / 1000000u;
+    if (p_cap->IntDis == DEF_YES) {
+        CPU_INT_DIS();                                          /* See the file header                                  */
+    }
+
+    t_start = App_TS_Rd32();                                    /* Low first, see Note #1                               */
+    ok      = App_PollCap_Wait(p_cap, 0u, t_start, rise_timeout_us * cnts_per_us, &t_rise, &samples);
+    if (ok == DEF_TRUE) {
+        ok  = App_PollCap_Wait(p_cap, p_cap->Mask, t_start, rise_timeout_us * cnts_per_us, &t_rise, &samples);
+    }
+    if (ok == DEF_TRUE) {
+        ok  = App_PollCap_Wait(p_cap, 0u, t_rise, width_timeout_us * cnts_per_us, &t_fall, &samples);
+    }
+
+    if (p_cap->IntDis == DEF_YES) {
+        CPU_INT_EN();
+    }
+
+    if (ok == DEF_FALSE) {
+        p_cap->TimeoutCtr++;
+        return (DEF_FALSE);
+    }
+    p_cap->PulseCtr++;
+    p_cap->SampleCtr  += samples;
+    p_cap->SampleCnts += t_fall - t_rise;
+    *p_width_cnts      = t_fall - t_rise;
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PollCap_Report()
+*
+* Description : Prints the sample period (edge resolution) and rate achieved while the pin was high, the
+*               longest gap between two samples and the timeouts since the previous report, then restarts
+*               the statistics.
+*
+* Argument(s) : p_cap       capture.
+*               p_name      name printed in the report.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PollCap_Report (APP_POLLCAP      *p_cap,
+                          const  CPU_CHAR  *p_name)
+{
+    CPU_INT32U  per10;                                          /* Sample period, in tenths of a cycle                  */
+    CPU_INT32U  per_ns;
+    CPU_INT32U  rate_kHz;
+    char        tmp[128];
+
+
+    per10    = (p_cap->SampleCtr == 0u) ? 0u : (CPU_INT32U)((p_cap->SampleCnts * 10u) / p_cap->SampleCtr);
+    per_ns   = (CPU_INT32U)(App_TS_to_nS(per10) / 10u);
+    rate_kHz = (per10 == 0u) ? 0u : (CPU_INT32U)(((CPU_INT64U)App_TS_Freq * 10u) / per10 / 1000u);
+
+    sprintf(tmp, "%s: %u pulses, sample every %u.%u cycles (%u ns, %u kS/s), max gap %u ns, %u timeouts\n\r",
+            p_name,
+            (unsigned)p_cap->PulseCtr,
+            (unsigned)(per10 / 10u), (unsigned)(per10 % 10u),
+            (unsigned)per_ns,
+            (unsigned)rate_kHz,
+            (unsigned)App_TS_to_nS(p_cap->GapMax),
+            (unsigned)p_cap->TimeoutCtr);
+    APP_TRACE_DBG(( tmp ));
+
+    p_cap->PulseCtr   = 0u;
+    p_cap->TimeoutCtr = 0u;
+    p_cap->SampleCtr  = 0u;
+    p_cap->SampleCnts = 0u;
+    p_cap->GapMax     = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                         App_PollCap_Wait()
+*
+* Description : Samples the pin until it is at 'level' (0 or the mask).
+*
+* Argument(s) : t_start         start of the timeout.
+*               timeout_cnts    timeout, in cycles from 't_start'.
+*               p_ts            where to store the timestamp of the first sample at 'level'.
+*               p_samples       where to store the number of samples taken.
+*
+* Return(s)   : DEF_TRUE if the level was seen, DEF_FALSE on timeout.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_PollCap_Wait (APP_POLLCAP  *p_cap,
+                                       CPU_INT32U    level,
+                                       CPU_INT32U    t_start,
+                                       CPU_INT32U    timeout_cnts,
+                                       CPU_INT32U   *p_ts,
+                                       CPU_INT32U   *p_samples)
+{
+    volatile  const  CPU_INT32U  *p_pdir;
+    CPU_INT32U                    mask;
+    CPU_INT32U                    in;
+    CPU_INT32U                    t;
+    CPU_INT32U                    t_prev;
+    CPU_INT32U                    gap_max;
+    CPU_INT32U                    n;
+
+
+    p_pdir  = p_cap->PDIR_Ptr;                                  /* Locals: kept in registers in the loop                */
+    mask    = p_cap->Mask;
+    gap_max = p_cap->GapMax;
+    t_prev  = App_TS_Rd32();
+    n       = 0u;
+    do {
+        in = *p_pdir;
+        t  = App_TS_Rd32();
+        n++;
+        if (t - t_prev > gap_max) {
+            gap_max = t - t_prev;
+        }
+        t_prev = t;
+        if (t - t_start > timeout_cnts) {
+            p_cap->GapMax = gap_max;
+            return (DEF_FALSE);
+        }
+    } while ((in & mask) != level);
+
+    p_cap->GapMax = gap_max;
+    *p_ts         = t;
+    *p_samples    = n;
+    return (DEF_TRUE);
+}
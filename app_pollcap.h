@@ -0,0 +1,69 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Polling pulse capture: waits for a pulse on a GPIO input by reading the port's PDIR register directly with
+* a precomputed mask and timestamping each sample with the cycle counter (app_ts.h), a few CPU cycles per
+* sample instead of a driver call and a pin table look-up. Both waits are bounded by a cycle-count timeout,
+* and kernel-aware interrupts can be masked for the whole capture. The achieved sample period (the edge
+* resolution), the longest gap between two samples and the timeouts are printed by App_PollCap_Report().
+*********************************************************************************************************
+*/
+
+#ifndef  APP_POLLCAP_H
+#define  APP_POLLCAP_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_pollcap {
+    volatile  const  CPU_INT32U  *PDIR_Ptr;                     /* Port data input register of the pin.                 */
+    CPU_INT32U                    Mask;
+    CPU_BOOLEAN                   IntDis;                       /* Kernel-aware interrupts masked while capturing.      */
+
+    CPU_INT32U                    PulseCtr;                     /* Statistics since the previous report.                */
+    CPU_INT32U                    TimeoutCtr;
+    CPU_INT64U                    SampleCtr;                    /* Samples while the pin was high ...                   */
+    CPU_INT64U                    SampleCnts;                   /* ... over that many cycles.                           */
+    CPU_INT32U                    GapMax;                       /* Longest time between two samples, in cycles.         */
+} APP_POLLCAP;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_PollCap_Init   (APP_POLLCAP       *p_cap,
+                                 CPU_INT32U         pin,
+                                 CPU_BOOLEAN        int_dis);
+
+CPU_BOOLEAN  App_PollCap_Pulse  (APP_POLLCAP       *p_cap,
+                                 CPU_INT32U         rise_timeout_us,
+                                 CPU_INT32U         width_timeout_us,
+                                 CPU_INT32U        *p_width_cnts);
+
+void         App_PollCap_Report (APP_POLLCAP       *p_cap,
+                                 const  CPU_CHAR   *p_name);
+
+#endif
@@ -0,0 +1,312 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* PORT interrupt dispatcher.
+* The per-port handler reads PORTx_ISFR once and writes the same value back (write-1-to-clear) before calling
+* anything, so an edge that occurs while the handlers run raises the flag again instead of being cleared by a
+* late write. Flags of pins without a handler are cleared as well, they would otherwise retrigger the vector
+* forever. The pending pins are then walked from the highest one down with count-leading-zeros (CLZ on the
+* Cortex-M4): one iteration per pending pin, whatever the number of registered pins.
+*
+* A fast port (App_PortISR_FastSet()) runs above the kernel-aware boundary: the dispatcher then skips
+* OSIntEnter()/OSIntExit() and its handlers defer their kernel calls with App_IRQ_Defer().
+*
+* The tap is called once per interrupt with all its pending pins, before any handler: a recorder (app_logcap.c)
+* then timestamps the edges first and does not take the pin from the module that owns its handler.
+*
+* The dispatcher and its tables are in SRAM (app_ramfunc.h), and it makes no call to flash on a fast port: the
+* PORT block is computed from the port number and CLZ is the intrinsic.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "fsl_interrupt_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <system_MK64F12.h>
+#include  <board.h>
+#include  <fsl_gpio_common.h>
+
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_pin.h"
+#include  "app_portisr.h"
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_PORTISR_PORT_NBR                      5u           /* PORTA..PORTE                                         */
+#define  APP_PORTISR_PIN_NBR                      32u
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_portisr_entry {
+    APP_PORTISR_FNCT   Fnct;
+    void              *ArgPtr;
+} APP_PORTISR_ENTRY;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+APP_RAMDATA  static  APP_PORTISR_ENTRY  App_PortISR_Tbl[APP_PORTISR_PORT_NBR][APP_PORTISR_PIN_NBR];
+APP_RAMDATA  static  CPU_INT32U         App_PortISR_Mask[APP_PORTISR_PORT_NBR];  /* Pins with a handler, per port.  */
+APP_RAMDATA  static  CPU_INT08U         App_PortISR_Fast;       /* Kernel-unaware ports, one bit per port.              */
+APP_RAMDATA  static  CPU_INT32U         App_PortISR_TapMask[APP_PORTISR_PORT_NBR];   /* Tapped pins, per port.      */
+APP_RAMDATA  static  APP_PORTISR_TAP_FNCT  App_PortISR_TapFnct;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void  App_PortISR_Dispatch (CPU_INT08U  port);
+
+APP_RAMFUNC  static  void  App_PortISR_PortA    (void);
+APP_RAMFUNC  static  void  App_PortISR_PortB    (void);
+APP_RAMFUNC  static  void  App_PortISR_PortC    (void);
+APP_RAMFUNC  static  void  App_PortISR_PortD    (void);
+APP_RAMFUNC  static  void  App_PortISR_PortE    (void);
+
+static  const  IRQn_Type  App_PortISR_IRQn[APP_PORTISR_PORT_NBR] = {
+    PORTA_IRQn, PORTB_IRQn, PORTC_IRQn, PORTD_IRQn, PORTE_IRQn
+};
+
+static  void  (* const  App_PortISR_Vect[APP_PORTISR_PORT_NBR])(void) = {
+    App_PortISR_PortA, App_PortISR_PortB, App_PortISR_PortC, App_PortISR_PortD, App_PortISR_PortE
+};
+
+
+/*
+*********************************************************************************************************
+*                                          App_PortISR_Set()
+*
+* Description : Registers the handler of a pin. The first handler of a port installs the dispatcher on the
+*               port vector. Call after OSA_Init(); the pin interrupt itself (edge or level) is configured as
+*               usual, in "gpio_pins.c" or by the app.
+*
+* Argument(s) : pin         GPIO pin.
+*               fnct        handler, (APP_PORTISR_FNCT)0 to remove it (the flag is then just cleared).
+*               p_arg       argument passed to the handler.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PortISR_Set (CPU_INT32U         pin,
+                       APP_PORTISR_FNCT   fnct,
+                       void              *p_arg)
+{
+    CPU_INT08U  port;
+    CPU_INT08U  ix;
+    CPU_SR_ALLOC();
+
+
+    port = (CPU_INT08U)GPIO_EXTRACT_PORT(pin);
+    ix   = (CPU_INT08U)GPIO_EXTRACT_PIN(pin);
+    if ((port >= APP_PORTISR_PORT_NBR) ||
+        (ix   >= APP_PORTISR_PIN_NBR)) {
+        return;
+    }
+
+    APP_CRITICAL_ENTER();
+    if ((App_PortISR_Mask[port] | App_PortISR_TapMask[port]) == 0u) {  /* First pin of the port: take the vector    */
+        INT_SYS_InstallHandler(App_PortISR_IRQn[port], App_PortISR_Vect[port]);
+    }
+    App_PortISR_Tbl[port][ix].Fnct   = fnct;
+    App_PortISR_Tbl[port][ix].ArgPtr = p_arg;
+    if (fnct != (APP_PORTISR_FNCT)0) {
+        App_PortISR_Mask[port] |=  (1u << ix);
+    } else {
+        App_PortISR_Mask[port] &= ~(1u << ix);
+    }
+    APP_CRITICAL_EXIT();
+
+    INT_SYS_EnableIRQ(App_PortISR_IRQn[port]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PortISR_FastSet()
+*
+* Description : Makes the port of a pin a fast port: its vector gets APP_CFG_IRQ_PRIO_FAST and is no longer
+*               masked by critical sections. Every handler of that port then runs kernel-unaware and must not
+*               call any kernel service, see app_irq.h. Call after App_IRQ_Init().
+*
+* Argument(s) : pin         any GPIO pin of the port.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PortISR_FastSet (CPU_INT32U  pin)
+{
+    CPU_INT08U  port;
+    CPU_SR_ALLOC();
+
+
+    port = (CPU_INT08U)GPIO_EXTRACT_PORT(pin);
+    if (port >= APP_PORTISR_PORT_NBR) {
+        return;
+    }
+
+    APP_CRITICAL_ENTER();
+    App_PortISR_Fast |= (CPU_INT08U)(1u << port);
+    APP_CRITICAL_EXIT();
+
+    NVIC_SetPriority(App_PortISR_IRQn[port], APP_CFG_IRQ_PRIO_FAST);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PortISR_TapSet()
+*
+* Description : Adds a pin to the tap: at each interrupt of its port, the tap function is called with the pending
+*               tapped pins before the pin handlers. There is a single tap function for every port.
+*
+* Argument(s) : pin         GPIO pin, with or without a handler.
+*               fnct        tap function, (APP_PORTISR_TAP_FNCT)0 to remove the pin from the tap.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The tap runs in the context of the port: kernel-unaware if it is a fast port.
+*********************************************************************************************************
+*/
+
+void  App_PortISR_TapSet (CPU_INT32U             pin,
+                          APP_PORTISR_TAP_FNCT   fnct)
+{
+    CPU_INT08U  port;
+    CPU_INT08U  ix;
+    CPU_SR_ALLOC();
+
+
+    port = (CPU_INT08U)GPIO_EXTRACT_PORT(pin);
+    ix   = (CPU_INT08U)GPIO_EXTRACT_PIN(pin);
+    if ((port >= APP_PORTISR_PORT_NBR) ||
+        (ix   >= APP_PORTISR_PIN_NBR)) {
+        return;
+    }
+
+    APP_CRITICAL_ENTER();
+    if ((App_PortISR_Mask[port] | App_PortISR_TapMask[port]) == 0u) {
+        INT_SYS_InstallHandler(App_PortISR_IRQn[port], App_PortISR_Vect[port]);
+    }
+    if (fnct != (APP_PORTISR_TAP_FNCT)0) {
+        App_PortISR_TapFnct        = fnct;
+        App_PortISR_TapMask[port] |=  (1u << ix);
+    } else {
+        App_PortISR_TapMask[port] &= ~(1u << ix);
+    }
+    APP_CRITICAL_EXIT();
+
+    INT_SYS_EnableIRQ(App_PortISR_IRQn[port]);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  void  App_PortISR_Dispatch (CPU_INT08U  port)
+{
+    PORT_Type          *p_port;
+    APP_PORTISR_ENTRY  *p_entry;
+    CPU_INT32U          isfr;
+    CPU_INT32U          pend;
+    CPU_INT08U          ix;
+    CPU_BOOLEAN         fast;
+    CPU_SR_ALLOC();
+
+
+    fast = ((App_PortISR_Fast & DEF_BIT(port)) != 0u) ? DEF_YES : DEF_NO;
+    if (fast == DEF_NO) {
+        APP_CRITICAL_ENTER();
+        OSIntEnter();                                           /* Tell the OS that we are starting an ISR              */
+        APP_CRITICAL_EXIT();
+    }
+
+    p_port       = APP_PIN_PORT(GPIO_MAKE_PIN(port, 0u));        /* No look-up in the flash table g_portBaseAddr[]       */
+    isfr         = p_port->ISFR;
+    p_port->ISFR = isfr;                                        /* Clear every flag read, in one write                  */
+
+    pend = isfr & App_PortISR_TapMask[port];
+    if (pend != 0u) {
+        App_PortISR_TapFnct(port, pend);
+    }
+
+    pend = isfr & App_PortISR_Mask[port];
+    while (pend != 0u) {
+        ix       = (CPU_INT08U)(31u - __CLZ(pend));             /* Highest pending pin                                  */
+        pend    &= ~(1u << ix);
+        p_entry  = &App_PortISR_Tbl[port][ix];
+        p_entry->Fnct(GPIO_MAKE_PIN(port, ix), p_entry->ArgPtr);
+    }
+
+    if (fast == DEF_NO) {
+        OSIntExit();
+    }
+}
+
+
+APP_RAMFUNC  static  void  App_PortISR_PortA (void)
+{
+    App_PortISR_Dispatch(0u);
+}
+
+
+APP_RAMFUNC  static  void  App_PortISR_PortB (void)
+{
+    App_PortISR_Dispatch(1u);
+}
+
+
+APP_RAMFUNC  static  void  App_PortISR_PortC (void)
+{
+    App_PortISR_Dispatch(2u);
+}
+
+
+APP_RAMFUNC  static  void  App_PortISR_PortD (void)
+{
+    App_PortISR_Dispatch(3u);
+}
+
+
+APP_RAMFUNC  static  void  App_PortISR_PortE (void)
+{
+    App_PortISR_Dispatch(4u);
+}
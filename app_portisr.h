@@ -0,0 +1,63 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* PORTA..PORTE interrupt dispatcher: one handler per port vector reads the interrupt status flags once, clears
+* them in a single write and calls the handler registered for each pending pin, so several pins of a port share
+* the vector without ad-hoc flag checks in every app ISR.
+*
+* Handlers run in ISR context, between OSIntEnter() and OSIntExit(): they may post to kernel objects. The
+* handlers of a fast port (App_PortISR_FastSet()) are kernel-unaware and defer with App_IRQ_Defer() instead.
+* A tap (App_PortISR_TapSet()) sees the edges of its pins before their handlers, whether they have one or not.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_PORTISR_H
+#define  APP_PORTISR_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  void  (*APP_PORTISR_FNCT)(CPU_INT32U   pin,          /* GPIO pin (port and pin number) that interrupted.     */
+                                   void        *p_arg);
+
+typedef  void  (*APP_PORTISR_TAP_FNCT)(CPU_INT08U   port,       /* Port index (0 = PORTA).                              */
+                                       CPU_INT32U   pins);      /* Tapped pins pending in this interrupt.               */
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  App_PortISR_Set     (CPU_INT32U         pin,
+                           APP_PORTISR_FNCT   fnct,
+                           void              *p_arg);
+
+void  App_PortISR_FastSet (CPU_INT32U         pin);
+
+void  App_PortISR_TapSet  (CPU_INT32U             pin,
+                           APP_PORTISR_TAP_FNCT   fnct);
+
+#endif
@@ -0,0 +1,412 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Pulse meter.
+* The input's port is made fast (App_PortISR_FastSet()): its edges are timestamped at the highest priority,
+* never delayed by a critical section, so the error is the interrupt entry jitter (tens of ns), not the
+* scheduling of a task. PTB9 is not an FTM channel; a timer input capture would also need another pin.
+*
+* The statistics of a channel are kept in two windows: the ISR fills the current one, the report switches the
+* ISR to the other one (a single byte write) and then owns the previous window, which no ISR can be writing
+* since the ISR preempts the report and never the other way round. No interrupt masking is needed, which
+* would not stop a fast ISR anyway.
+*
+* The edge direction is the level read in the ISR: if it equals the previous one, a pulse shorter than the
+* interrupt latency went by (both edges seen as one), the edge is counted as lost and the next period is not
+* measured.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <board.h>
+
+#include  "app_pin.h"
+#include  "app_portisr.h"
+#include  "app_pulsemeter.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_pulsemeter_stat {
+    CPU_INT32U   Ctr;
+    CPU_TS_TMR   Min;                                           /* In ts counts.                                        */
+    CPU_TS_TMR   Max;
+    CPU_INT64U   Sum;
+} APP_PULSEMETER_STAT;
+
+typedef  struct  app_pulsemeter_win {
+    APP_PULSEMETER_STAT  Width;
+    APP_PULSEMETER_STAT  Period;
+    CPU_INT32U           LostCtr;
+} APP_PULSEMETER_WIN;
+
+typedef  struct  app_pulsemeter_ch {
+    CPU_INT32U            Pin;
+    CPU_CHAR             *NamePtr;
+    CPU_BOOLEAN           Level;                                /* ISR only: level after the last edge.                 */
+    CPU_BOOLEAN           RiseValid;                            /* ISR only: RiseTS is the rise of the current pulse.   */
+    CPU_TS_TMR            RiseTS;
+    volatile  CPU_INT08U  WinIx;                                /* Window written by the ISR.                           */
+    APP_PULSEMETER_WIN    Win[2];
+} APP_PULSEMETER_CH;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  APP_PULSEMETER_CH  App_PulseMeter_Ch[APP_CFG_PULSE_METER_CH_MAX];
+static  CPU_INT08U         App_PulseMeter_ChNbr;
+static  CPU_INT16U         App_PulseMeter_ReportPeriod_s;
+
+static  OS_TCB             App_PulseMeter_TaskTCB;
+static  CPU_STK            App_PulseMeter_TaskStk[APP_CFG_PULSE_METER_TASK_STK_SIZE];
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void        App_PulseMeter_Task    (void                 *p_arg);
+
+static  void        App_PulseMeter_ChRd    (APP_PULSEMETER_CH    *p_ch,
+                                            APP_PULSEMETER_RES   *p_res);
+
+static  void        App_PulseMeter_Edge    (CPU_INT32U            pin,
+                                            void                 *p_arg);
+
+static  void        App_PulseMeter_StatAdd (APP_PULSEMETER_STAT  *p_stat,
+                                            CPU_TS_TMR            cnts);
+
+static  void        App_PulseMeter_WinClr  (APP_PULSEMETER_WIN   *p_win);
+
+
+/*
+*********************************************************************************************************
+*                                       App_PulseMeter_ChAdd()
+*
+* Description : Registers an input to be measured and makes its port fast. Call after App_IRQ_Init() and
+*               CPU_Init() (timestamps).
+*
+* Argument(s) : pin         GPIO pin of the input, configured for either-edge interrupts.
+*               p_name      name printed in the report.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Every handler on the same port then runs kernel-unaware, see App_PortISR_FastSet().
+*********************************************************************************************************
+*/
+
+void  App_PulseMeter_ChAdd (CPU_INT32U   pin,
+                            CPU_CHAR    *p_name)
+{
+    APP_PULSEMETER_CH  *p_ch;
+
+
+    if (App_PulseMeter_ChNbr >= APP_CFG_PULSE_METER_CH_MAX) {
+        return;
+    }
+    p_ch            = &App_PulseMeter_Ch[App_PulseMeter_ChNbr];
+    p_ch->Pin       =  pin;
+    p_ch->NamePtr   =  p_name;
+    p_ch->Level     = (GPIO_DRV_ReadPinInput(pin) != 0u) ? DEF_YES : DEF_NO;
+    p_ch->RiseValid =  DEF_NO;
+    p_ch->WinIx     =  0u;
+    App_PulseMeter_WinClr(&p_ch->Win[0u]);
+    App_PulseMeter_WinClr(&p_ch->Win[1u]);
+    App_PulseMeter_ChNbr++;
+
+    App_PortISR_Set(pin, App_PulseMeter_Edge, (void *)p_ch);
+    App_PortISR_FastSet(pin);
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_PulseMeter_Start()
+*
+* Description : Creates the report task.
+*
+* Argument(s) : report_period_s     interval between two reports, in seconds (0 = no report task, the app
+*                                   calls App_PulseMeter_Report() itself).
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PulseMeter_Start (CPU_INT16U  report_period_s)
+{
+    OS_ERR  os_err;
+
+
+    App_TS_Init();
+    App_PulseMeter_ReportPeriod_s = report_period_s;
+    if (report_period_s == 0u) {
+        return;
+    }
+
+    OSTaskCreate(&App_PulseMeter_TaskTCB,
+                 "Pulse meter",
+                  App_PulseMeter_Task,
+                  0u,
+                  APP_CFG_PULSE_METER_TASK_PRIO,
+                 &App_PulseMeter_TaskStk[0u],
+                 (APP_CFG_PULSE_METER_TASK_STK_SIZE / 10u),
+                  APP_CFG_PULSE_METER_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PulseMeter_Rd()
+*
+* Description : Returns the statistics of an input since the previous call (or report), then restarts them.
+*
+* Argument(s) : pin         GPIO pin of the input.
+*               p_res       where to store the statistics, times in ns (mean, min and max are 0 when no pulse,
+*                           respectively no period, was complete).
+*
+* Return(s)   : DEF_FALSE if the pin is not measured, DEF_TRUE otherwise.
+*
+* Note(s)     : (1) Restarts the window seen by App_PulseMeter_Report(): an app that reads the results itself
+*                   starts the meter with no report task.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_PulseMeter_Rd (CPU_INT32U           pin,
+                                APP_PULSEMETER_RES  *p_res)
+{
+    APP_PULSEMETER_CH  *p_ch;
+    CPU_INT08U          i;
+
+
+    for (i = 0u; i < App_PulseMeter_ChNbr; i++) {
+        p_ch = &App_PulseMeter_Ch[i];
+        if (p_ch->Pin == pin) {
+            App_PulseMeter_ChRd(p_ch, p_res);
+            return (DEF_TRUE);
+        }
+    }
+    return (DEF_FALSE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                      App_PulseMeter_Report()
+*
+* Description : Prints width, period, frequency and duty cycle of every input since the previous report, then
+*               restarts the measurement.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_PulseMeter_Report (void)
+{
+    APP_PULSEMETER_CH   *p_ch;
+    APP_PULSEMETER_RES   res;
+    CPU_INT08U           i;
+    CPU_INT32U           freq_mHz;
+    CPU_INT32U           duty_permil;
+    char                 tmp[128];
+
+
+    for (i = 0u; i < App_PulseMeter_ChNbr; i++) {
+        p_ch = &App_PulseMeter_Ch[i];
+        App_PulseMeter_ChRd(p_ch, &res);
+
+        if ((res.PulseCtr == 0u) || (res.PeriodCtr == 0u)) {
+            sprintf(tmp, "%-6.6s: %u pulses, %u periods, %u lost edges\n\r",
+                    p_ch->NamePtr,
+                    (unsigned)res.PulseCtr,
+                    (unsigned)res.PeriodCtr,
+                    (unsigned)res.LostCtr);
+            APP_TRACE_DBG(( tmp ));
+            continue;
+        }
+
+        freq_mHz    = (CPU_INT32U)(1000000000000u / res.PeriodMean_ns);
+        duty_permil = (CPU_INT32U)(((CPU_INT64U)res.WidthMean_ns * 1000u) / res.PeriodMean_ns);
+
+        sprintf(tmp, "%-6.6s: width %u.%03u us (min %u.%03u, max %u.%03u), %u pulses, %u lost edges\n\r",
+                p_ch->NamePtr,
+                (unsigned)(res.WidthMean_ns / 1000u), (unsigned)(res.WidthMean_ns % 1000u),
+                (unsigned)(res.WidthMin_ns  / 1000u), (unsigned)(res.WidthMin_ns  % 1000u),
+                (unsigned)(res.WidthMax_ns  / 1000u), (unsigned)(res.WidthMax_ns  % 1000u),
+                (unsigned)res.PulseCtr,
+                (unsigned)res.LostCtr);
+        APP_TRACE_DBG(( tmp ));
+
+        sprintf(tmp, "        period %u.%03u us (min %u.%03u, max %u.%03u), %u.%03u Hz, duty %u.%u%%\n\r",
+                (unsigned)(res.PeriodMean_ns / 1000u), (unsigned)(res.PeriodMean_ns % 1000u),
+                (unsigned)(res.PeriodMin_ns  / 1000u), (unsigned)(res.PeriodMin_ns  % 1000u),
+                (unsigned)(res.PeriodMax_ns  / 1000u), (unsigned)(res.PeriodMax_ns  % 1000u),
+                (unsigned)(freq_mHz / 1000u),          (unsigned)(freq_mHz % 1000u),
+                (unsigned)(duty_permil / 10u),         (unsigned)(duty_permil % 10u));
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_PulseMeter_Task (void  *p_arg)
+{
+    OS_ERR  os_err;
+
+
+    (void)p_arg;
+
+    while (DEF_ON) {
+        OSTimeDlyHMSM(0u, 0u, App_PulseMeter_ReportPeriod_s, 0u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+        App_PulseMeter_Report();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PulseMeter_ChRd()
+*
+* Description : Switches the ISR to the other window, converts the previous one and clears it.
+*********************************************************************************************************
+*/
+
+static  void  App_PulseMeter_ChRd (APP_PULSEMETER_CH   *p_ch,
+                                   APP_PULSEMETER_RES  *p_res)
+{
+    APP_PULSEMETER_WIN   snap;
+    APP_PULSEMETER_WIN  *p_win;
+    CPU_INT08U           ix;
+
+
+    ix          =  p_ch->WinIx;
+    p_ch->WinIx = (CPU_INT08U)(ix ^ 1u);                        /* The ISR now fills the other (clear) window           */
+    p_win       = &p_ch->Win[ix];
+    snap        = *(volatile APP_PULSEMETER_WIN *)p_win;
+    App_PulseMeter_WinClr(p_win);
+
+    p_res->PulseCtr      = snap.Width.Ctr;
+    p_res->PeriodCtr     = snap.Period.Ctr;
+    p_res->LostCtr       = snap.LostCtr;
+    p_res->WidthMean_ns  = 0u;
+    p_res->WidthMin_ns   = 0u;
+    p_res->WidthMax_ns   = 0u;
+    p_res->PeriodMean_ns = 0u;
+    p_res->PeriodMin_ns  = 0u;
+    p_res->PeriodMax_ns  = 0u;
+    if (snap.Width.Ctr != 0u) {
+        p_res->WidthMean_ns  = (CPU_INT32U)App_TS_to_nS(snap.Width.Sum / snap.Width.Ctr);
+        p_res->WidthMin_ns   = (CPU_INT32U)App_TS_to_nS(snap.Width.Min);
+        p_res->WidthMax_ns   = (CPU_INT32U)App_TS_to_nS(snap.Width.Max);
+    }
+    if (snap.Period.Ctr != 0u) {
+        p_res->PeriodMean_ns = (CPU_INT32U)App_TS_to_nS(snap.Period.Sum / snap.Period.Ctr);
+        p_res->PeriodMin_ns  = (CPU_INT32U)App_TS_to_nS(snap.Period.Min);
+        p_res->PeriodMax_ns  = (CPU_INT32U)App_TS_to_nS(snap.Period.Max);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_PulseMeter_Edge()
+*
+* Description : Either edge of a measured input, called by the (fast) port dispatcher. No kernel calls.
+*********************************************************************************************************
+*/
+
+static  void  App_PulseMeter_Edge (CPU_INT32U   pin,
+                                   void        *p_arg)
+{
+    APP_PULSEMETER_CH   *p_ch;
+    APP_PULSEMETER_WIN  *p_win;
+    CPU_TS_TMR           ts;
+    CPU_BOOLEAN          level;
+
+
+    ts    = App_TS_Rd32();                                      /* First: everything below is after the edge            */
+    p_ch  = (APP_PULSEMETER_CH *)p_arg;
+    p_win = &p_ch->Win[p_ch->WinIx];
+    level = (APP_PIN_RD(pin) != 0u) ? DEF_YES : DEF_NO;      /* No driver call or table look-up           */
+
+    if (level == p_ch->Level) {                                 /* Two edges for one interrupt                          */
+        p_win->LostCtr++;
+        p_ch->RiseValid = DEF_NO;
+        return;
+    }
+    p_ch->Level = level;
+
+    if (level == DEF_YES) {                                     /* ------------------- RISING: PERIOD ------------------ */
+        if (p_ch->RiseValid == DEF_YES) {
+            App_PulseMeter_StatAdd(&p_win->Period, ts - p_ch->RiseTS);
+        }
+        p_ch->RiseTS    = ts;
+        p_ch->RiseValid = DEF_YES;
+    } else if (p_ch->RiseValid == DEF_YES) {                    /* ------------------- FALLING: WIDTH ------------------ */
+        App_PulseMeter_StatAdd(&p_win->Width, ts - p_ch->RiseTS);
+    }
+}
+
+
+static  void  App_PulseMeter_StatAdd (APP_PULSEMETER_STAT  *p_stat,
+                                      CPU_TS_TMR            cnts)
+{
+    p_stat->Ctr++;
+    p_stat->Sum += cnts;
+    p_stat->Min  = DEF_MIN(p_stat->Min, cnts);
+    p_stat->Max  = DEF_MAX(p_stat->Max, cnts);
+}
+
+
+static  void  App_PulseMeter_WinClr (APP_PULSEMETER_WIN  *p_win)
+{
+    p_win->Width.Ctr  = 0u;
+    p_win->Width.Min  = DEF_INT_32U_MAX_VAL;
+    p_win->Width.Max  = 0u;
+    p_win->Width.Sum  = 0u;
+    p_win->Period     = p_win->Width;
+    p_win->LostCtr    = 0u;
+}
+
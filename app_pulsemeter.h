@@ -0,0 +1,86 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Pulse meter: both edges of a digital input are timestamped by its PORT interrupt with the DWT cycle
+* counter (app_ts.h, one CPU clock, 8.3 ns at 120 MHz). Pulse width (rising to falling edge), period (rising to rising),
+* frequency and duty cycle, with min/max/mean over the interval since the previous report, are printed
+* periodically on the serial port, as well as the edges lost to pulses shorter than the interrupt latency.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_PULSEMETER_H
+#define  APP_PULSEMETER_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_PULSE_METER_CH_MAX
+#define  APP_CFG_PULSE_METER_CH_MAX                2u
+#endif
+
+#ifndef  APP_CFG_PULSE_METER_TASK_PRIO
+#define  APP_CFG_PULSE_METER_TASK_PRIO           (OS_CFG_PRIO_MAX - 3u)   /* Just above the statistic task.          */
+#endif
+
+#ifndef  APP_CFG_PULSE_METER_TASK_STK_SIZE
+#define  APP_CFG_PULSE_METER_TASK_STK_SIZE       256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_pulsemeter_res {
+    CPU_INT32U  PulseCtr;                                       /* Complete pulses (rising then falling edge).          */
+    CPU_INT32U  PeriodCtr;                                      /* Complete periods (two rising edges).                 */
+    CPU_INT32U  LostCtr;                                        /* Edges lost to pulses shorter than the ISR latency.   */
+    CPU_INT32U  WidthMean_ns;
+    CPU_INT32U  WidthMin_ns;
+    CPU_INT32U  WidthMax_ns;
+    CPU_INT32U  PeriodMean_ns;
+    CPU_INT32U  PeriodMin_ns;
+    CPU_INT32U  PeriodMax_ns;
+} APP_PULSEMETER_RES;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_PulseMeter_ChAdd  (CPU_INT32U           pin,
+                                    CPU_CHAR            *p_name);
+
+void         App_PulseMeter_Start  (CPU_INT16U           report_period_s);
+
+CPU_BOOLEAN  App_PulseMeter_Rd     (CPU_INT32U           pin,
+                                    APP_PULSEMETER_RES  *p_res);
+
+void         App_PulseMeter_Report (void);
+
+#endif
@@ -0,0 +1,318 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* SRAM code and data: start-up copy and entry latency benchmark.
+* The benchmark pends a spare vector APP_CFG_RAMFUNC_BENCH_NBR times for an ISR in flash, then for the same ISR
+* in SRAM, with the flash cache and prefetch buffer invalidated before every other interrupt. The ISR stamps
+* its first instruction and the end of a short body (the dispatcher's pending-pin walk); the pend itself runs
+* from SRAM, so the cache state only changes the fetches of the ISR.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  "fsl_interrupt_manager.h"
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+
+#include  "app_irq.h"
+#include  "app_ramfunc.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_ramfunc_stat {
+    CPU_INT32U  EntryMin;                                       /* Cycles from the pend to the first ISR instruction.   */
+    CPU_INT32U  EntryMax;
+    CPU_INT32U  EntrySum;
+    CPU_INT32U  BodyMin;                                        /* Cycles of the ISR body.                              */
+    CPU_INT32U  BodyMax;
+} APP_RAMFUNC_STAT;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+#if (APP_RAMFUNC_PLACED == DEF_YES) && defined(__GNUC__)
+extern  CPU_INT32U  __app_ramfunc_load__[];                     /* Defined by linker/app_ramfunc_gcc.ld                 */
+extern  CPU_INT32U  __app_ramfunc_start__[];
+extern  CPU_INT32U  __app_ramfunc_end__[];
+extern  CPU_INT32U  __app_ramdata_load__[];
+extern  CPU_INT32U  __app_ramdata_start__[];
+extern  CPU_INT32U  __app_ramdata_end__[];
+#endif
+
+static  CPU_BOOLEAN           App_RamFunc_Done;                 /* Not tagged: tested before the copy.                  */
+
+static  volatile  CPU_INT32U  App_RamFunc_BenchEntry;
+static  volatile  CPU_INT32U  App_RamFunc_BenchExit;
+static  volatile  CPU_INT32U  App_RamFunc_BenchMask = 0x00800A00u;  /* Three pending pins.                          */
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL MACROS
+*
+* Note(s) : (1) The same body for both placements of the benchmark ISR.
+*********************************************************************************************************
+*/
+
+#define  APP_RAMFUNC_BENCH_ISR_BODY()                                                           \
+    do {                                                                                        \
+        CPU_INT32U  pend_;                                                                      \
+        CPU_INT32U  ix_;                                                                        \
+                                                                                                \
+        App_RamFunc_BenchEntry = App_TS_Rd32();                                                 \
+        pend_ = App_RamFunc_BenchMask;                                                          \
+        while (pend_ != 0u) {                                                                   \
+            ix_    = 31u - __CLZ(pend_);                                                        \
+            pend_ &= ~(1uL << ix_);                                                             \
+            App_TS_BenchSink += ix_;                                                            \
+        }                                                                                       \
+        App_RamFunc_BenchExit  = App_TS_Rd32();                                                 \
+    } while (0)
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void        App_RamFunc_Copy          (CPU_INT32U        *p_dst,
+                                               CPU_INT32U  const *p_src,
+                                               CPU_INT32U  const *p_end);
+
+static  void        App_RamFunc_BenchRun      (void             (*isr)(void),
+                                               APP_RAMFUNC_STAT  *p_stat);
+
+static  void        App_RamFunc_BenchPrint    (const  CPU_CHAR   *p_name,
+                                               APP_RAMFUNC_STAT  *p_stat);
+
+static  void        App_RamFunc_BenchFlashISR (void);
+
+APP_RAMFUNC  static  void        App_RamFunc_BenchRamISR   (void);
+
+APP_RAMFUNC  static  CPU_INT32U  App_RamFunc_BenchPend     (void);
+
+
+/*
+*********************************************************************************************************
+*                                          App_RamFunc_Init()
+*
+* Description : Copies the SRAM code and data from their load image in flash. Call once, first thing in main(),
+*               before OSA_Init() and before any tagged code or data is used (a task-level call to a tagged
+*               function such as App_LowPwr_StopLock() included); later calls do nothing.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) With IAR, the start-up has already copied them with the initialized data.
+*********************************************************************************************************
+*/
+
+void  App_RamFunc_Init (void)
+{
+    if (App_RamFunc_Done == DEF_YES) {
+        return;
+    }
+
+#if (APP_RAMFUNC_PLACED == DEF_YES) && defined(__GNUC__)
+    App_RamFunc_Copy(__app_ramfunc_start__, __app_ramfunc_load__, __app_ramfunc_end__);
+    App_RamFunc_Copy(__app_ramdata_start__, __app_ramdata_load__, __app_ramdata_end__);
+    __DSB();                                                    /* Copied code visible to the instruction fetch         */
+    __ISB();
+#endif
+
+    App_RamFunc_Done = DEF_YES;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_RamFunc_Bench()
+*
+* Description : Measures and prints the entry latency (min/mean/max and jitter) and the body time of the same
+*               ISR in flash and in SRAM, in CPU cycles. Call after App_IRQ_Init().
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_RamFunc_Bench (void)
+{
+    APP_RAMFUNC_STAT  flash;
+    APP_RAMFUNC_STAT  sram;
+    char              tmp[96];
+
+
+    App_TS_Init();
+
+    NVIC_SetPriority(APP_CFG_RAMFUNC_BENCH_IRQn, APP_CFG_IRQ_PRIO_FAST);
+    App_RamFunc_BenchRun(App_RamFunc_BenchFlashISR, &flash);
+    App_RamFunc_BenchRun(App_RamFunc_BenchRamISR,   &sram);
+
+    sprintf(tmp, "ISR entry latency (CPU cycles, %u MHz, %u interrupts, half with a cold flash cache):\n\r",
+            (unsigned)(App_TS_Freq / 1000000u), (unsigned)APP_CFG_RAMFUNC_BENCH_NBR);
+    APP_TRACE_DBG(( tmp ));
+    App_RamFunc_BenchPrint("flash", &flash);
+    App_RamFunc_BenchPrint("SRAM",  &sram);
+    if (APP_RAMFUNC_PLACED == DEF_NO) {
+        APP_TRACE_DBG(( "  (APP_CFG_RAMFUNC_EN disabled or compiler not supported: both ISRs in flash)\n\r" ));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_RamFunc_Copy (CPU_INT32U        *p_dst,
+                                CPU_INT32U  const *p_src,
+                                CPU_INT32U  const *p_end)
+{
+    while (p_dst < p_end) {
+        *p_dst++ = *p_src++;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_RamFunc_BenchRun()
+*
+* Description : Pends the benchmark vector with 'isr' installed and collects the entry and body times.
+*
+* Note(s)     : (1) Kernel-aware interrupts are masked around each pend; the benchmark vector is fast.
+*********************************************************************************************************
+*/
+
+static  void  App_RamFunc_BenchRun (void             (*isr)(void),
+                                    APP_RAMFUNC_STAT  *p_stat)
+{
+    CPU_INT32U  i;
+    CPU_INT32U  t0;
+    CPU_INT32U  entry;
+    CPU_INT32U  body;
+    CPU_SR_ALLOC();
+
+
+    p_stat->EntryMin = DEF_INT_32U_MAX_VAL;
+    p_stat->EntryMax = 0u;
+    p_stat->EntrySum = 0u;
+    p_stat->BodyMin  = DEF_INT_32U_MAX_VAL;
+    p_stat->BodyMax  = 0u;
+
+    INT_SYS_InstallHandler(APP_CFG_RAMFUNC_BENCH_IRQn, isr);
+    INT_SYS_EnableIRQ(APP_CFG_RAMFUNC_BENCH_IRQn);
+
+    for (i = 0u; i < APP_CFG_RAMFUNC_BENCH_NBR; i++) {
+        CPU_INT_DIS();
+        if ((i & 1u) == 0u) {                                   /* Cold: flash cache and prefetch buffer invalidated    */
+            FMC->PFB0CR |= FMC_PFB0CR_CINV_WAY(0xFu) | FMC_PFB0CR_S_B_INV_MASK;
+        }
+        t0    = App_RamFunc_BenchPend();
+        entry = App_RamFunc_BenchEntry - t0;
+        body  = App_RamFunc_BenchExit  - App_RamFunc_BenchEntry;
+        CPU_INT_EN();
+
+        p_stat->EntrySum += entry;
+        if (entry < p_stat->EntryMin) {
+            p_stat->EntryMin = entry;
+        }
+        if (entry > p_stat->EntryMax) {
+            p_stat->EntryMax = entry;
+        }
+        if (body < p_stat->BodyMin) {
+            p_stat->BodyMin = body;
+        }
+        if (body > p_stat->BodyMax) {
+            p_stat->BodyMax = body;
+        }
+    }
+
+    INT_SYS_DisableIRQ(APP_CFG_RAMFUNC_BENCH_IRQn);
+}
+
+
+static  void  App_RamFunc_BenchPrint (const  CPU_CHAR   *p_name,
+                                      APP_RAMFUNC_STAT  *p_stat)
+{
+    char  tmp[96];
+
+
+    sprintf(tmp, "  %-6s entry min %3u mean %3u max %3u jitter %3u   body min %3u max %3u\n\r",
+            p_name,
+            (unsigned)p_stat->EntryMin,
+            (unsigned)(p_stat->EntrySum / APP_CFG_RAMFUNC_BENCH_NBR),
+            (unsigned)p_stat->EntryMax,
+            (unsigned)(p_stat->EntryMax - p_stat->EntryMin),
+            (unsigned)p_stat->BodyMin,
+            (unsigned)p_stat->BodyMax);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+static  void  App_RamFunc_BenchFlashISR (void)
+{
+    APP_RAMFUNC_BENCH_ISR_BODY();
+}
+
+
+APP_RAMFUNC  static  void  App_RamFunc_BenchRamISR (void)
+{
+    APP_RAMFUNC_BENCH_ISR_BODY();
+}
+
+
+/*
+*********************************************************************************************************
+*                                       App_RamFunc_BenchPend()
+*
+* Description : Stamps and pends the benchmark vector; the ISR has run when the barriers complete.
+*
+* Return(s)   : Timestamp of the pend.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC  static  CPU_INT32U  App_RamFunc_BenchPend (void)
+{
+    CPU_INT32U  t0;
+
+
+    t0 = App_TS_Rd32();
+    NVIC_SetPendingIRQ(APP_CFG_RAMFUNC_BENCH_IRQn);
+    __DSB();
+    __ISB();
+
+    return (t0);
+}
@@ -0,0 +1,100 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Latency-critical ISRs in SRAM: code from flash runs through the flash cache and prefetch buffer, and a miss
+* costs the flash wait states (5 at 120 MHz), so the entry time of an ISR depends on what ran before it. Code
+* tagged APP_RAMFUNC is linked in SRAM_L (code bus, no wait state) and data tagged APP_RAMDATA in SRAM_U
+* (system bus), so the fetches of the ISR and its data accesses do not share a bus either.
+*
+* Both sections are loaded in flash and copied by App_RamFunc_Init(), which every app linking tagged code or data
+* calls first thing in main(), before OSA_Init(): the modules do not copy on their own. The linker script must
+* place them, see linker/app_ramfunc_gcc.ld (KSDK GCC) or linker/app_ramfunc_iar.icf (IAR). Without the
+* fragment, disable with:  #define  APP_CFG_RAMFUNC_EN  DEF_DISABLED  in app_cfg.h: all stays in flash.
+*
+* Calls from SRAM to flash (kernel services, uC/CPU) go through a linker veneer and run from flash: tag the
+* fast ISRs, which make none on their hot path. App_RamFunc_Bench() prints the entry latency and its jitter
+* of the same ISR in flash and in SRAM.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_RAMFUNC_H
+#define  APP_RAMFUNC_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_RAMFUNC_EN
+#define  APP_CFG_RAMFUNC_EN                      DEF_ENABLED
+#endif
+
+#ifndef  APP_CFG_RAMFUNC_BENCH_IRQn                             /* Any vector with no handler in the apps.              */
+#define  APP_CFG_RAMFUNC_BENCH_IRQn              FTM3_IRQn
+#endif
+
+#ifndef  APP_CFG_RAMFUNC_BENCH_NBR                              /* Interrupts per placement, half with a cold cache.    */
+#define  APP_CFG_RAMFUNC_BENCH_NBR               256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                            PLACEMENT TAGS
+*
+* Note(s) : (1) Put the tag first, on the prototype and on the definition:
+*
+*                   APP_RAMFUNC  static  void  App_X_ISR (void);
+*                   APP_RAMDATA  static  CPU_INT32U  App_X_Ctr;
+*
+*           (2) GCC: 'long_call' lets flash code call the function without a veneer, 'noinline' keeps a static
+*               function from being inlined back into a flash caller. IAR: __ramfunc code is copied by the
+*               IAR start-up with the initialized data.
+*********************************************************************************************************
+*/
+
+#if     (APP_CFG_RAMFUNC_EN == DEF_ENABLED) && defined(__GNUC__)
+#define  APP_RAMFUNC                             __attribute__((section(".app_ramfunc"), long_call, noinline))
+#define  APP_RAMDATA                             __attribute__((section(".app_ramdata")))
+#define  APP_RAMFUNC_PLACED                      DEF_YES
+#elif   (APP_CFG_RAMFUNC_EN == DEF_ENABLED) && defined(__ICCARM__)
+#define  APP_RAMFUNC                             __ramfunc
+#define  APP_RAMDATA                             _Pragma("location=\".app_ramdata\"")
+#define  APP_RAMFUNC_PLACED                      DEF_YES
+#else
+#define  APP_RAMFUNC
+#define  APP_RAMDATA
+#define  APP_RAMFUNC_PLACED                      DEF_NO
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  App_RamFunc_Init  (void);
+
+void  App_RamFunc_Bench (void);
+
+#endif
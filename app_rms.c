@@ -0,0 +1,243 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Rate-monotonic priority assignment and response-time analysis for app task tables.
+* Shorter period gets the higher priority (lower number in uC/OS-III); ties are broken by the shorter deadline,
+* then by table order. The response time of task i is the fixed point of
+*     R = C_i + sum over higher priority tasks j of ceil(R / T_j) * C_j
+* and the set is schedulable when R <= D_i for every task.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  "app_rms.h"
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U   App_RMS_DeadlineGet (APP_RMS_TASK  *p_task);
+
+static  CPU_BOOLEAN  App_RMS_Before      (APP_RMS_TASK  *p_a,
+                                          APP_RMS_TASK  *p_b);
+
+
+/*
+*********************************************************************************************************
+*                                          App_RMS_Analyze()
+*
+* Description : Assigns rate-monotonic priorities to the tasks of a table, starting at 'prio_base' for the
+*               shortest period, and runs the response-time analysis. Results are stored in 'Prio' and
+*               'Resp_us' of each entry and printed on the serial port.
+*
+* Argument(s) : p_tbl       task table.
+*               nbr         number of entries in the table (at most APP_CFG_RMS_TASK_MAX).
+*               prio_base   priority given to the highest-priority task of the table.
+*
+* Return(s)   : DEF_TRUE if every task meets its deadline, DEF_FALSE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_RMS_Analyze (APP_RMS_TASK  *p_tbl,
+                              CPU_SIZE_T     nbr,
+                              OS_PRIO        prio_base)
+{
+    CPU_SIZE_T     order[APP_CFG_RMS_TASK_MAX];
+    CPU_SIZE_T     i;
+    CPU_SIZE_T     j;
+    CPU_SIZE_T     tmp_ix;
+    APP_RMS_TASK  *p_task;
+    APP_RMS_TASK  *p_hp;
+    CPU_INT64U     resp;
+    CPU_INT64U     resp_prev;
+    CPU_INT32U     deadline;
+    CPU_INT32U     util_permil;
+    CPU_BOOLEAN    ok;
+    char           tmp[128];
+
+
+    if (nbr > APP_CFG_RMS_TASK_MAX) {
+        APP_TRACE_DBG(("RMS: task table too large.\n\r"));
+        return (DEF_FALSE);
+    }
+    for (i = 0u; i < nbr; i++) {
+        if (p_tbl[i].Period_us == 0u) {
+            APP_TRACE_DBG(("RMS: task with zero period.\n\r"));
+            return (DEF_FALSE);
+        }
+    }
+                                                                /* ------------- SORT BY PERIOD, THEN DEADLINE ------------ */
+    for (i = 0u; i < nbr; i++) {
+        order[i] = i;
+        for (j = i; j > 0u; j--) {
+            if (App_RMS_Before(&p_tbl[order[j]], &p_tbl[order[j - 1u]]) == DEF_FALSE) {
+                break;
+            }
+            tmp_ix       = order[j];
+            order[j]     = order[j - 1u];
+            order[j - 1u] = tmp_ix;
+        }
+    }
+
+    for (i = 0u; i < nbr; i++) {
+        p_tbl[order[i]].Prio = (OS_PRIO)(prio_base + i);
+    }
+                                                                /* ---------------- RESPONSE-TIME ANALYSIS ---------------- */
+    ok          = DEF_TRUE;
+    util_permil = 0u;
+    for (i = 0u; i < nbr; i++) {
+        p_task   = &p_tbl[order[i]];
+        deadline = App_RMS_DeadlineGet(p_task);
+        resp     = p_task->WCET_us;
+        do {
+            resp_prev = resp;
+            resp      = p_task->WCET_us;
+            for (j = 0u; j < i; j++) {
+                p_hp  = &p_tbl[order[j]];
+                resp += ((resp_prev + p_hp->Period_us - 1u) / p_hp->Period_us) * p_hp->WCET_us;
+            }
+        } while ((resp != resp_prev) && (resp <= deadline));
+
+        p_task->Resp_us = (resp > DEF_INT_32U_MAX_VAL) ? DEF_INT_32U_MAX_VAL : (CPU_INT32U)resp;
+        util_permil    += (CPU_INT32U)(((CPU_INT64U)p_task->WCET_us * 1000u) / p_task->Period_us);
+
+        sprintf(tmp, "RMS: %-16.16s prio %2u  T %7u us  D %7u us  C %6u us  R %7u us %s\n\r",
+                p_task->NamePtr,
+                (unsigned)p_task->Prio,
+                (unsigned)p_task->Period_us,
+                (unsigned)deadline,
+                (unsigned)p_task->WCET_us,
+                (unsigned)p_task->Resp_us,
+                (resp <= deadline) ? "ok" : "MISSES DEADLINE");
+        APP_TRACE_DBG(( tmp ));
+
+        if (resp > deadline) {
+            ok = DEF_FALSE;
+        }
+    }
+
+    sprintf(tmp, "RMS: utilization %u.%u%%, task set %s\n\r",
+            (unsigned)(util_permil / 10u),
+            (unsigned)(util_permil % 10u),
+            (ok == DEF_TRUE) ? "schedulable" : "NOT SCHEDULABLE");
+    APP_TRACE_DBG(( tmp ));
+
+    return (ok);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_RMS_Start()
+*
+* Description : Analyzes a task table (see App_RMS_Analyze()) and creates its tasks at the assigned
+*               priorities. Tasks are created even if the set is not schedulable, so that the app still runs
+*               and the report can be read on the serial port.
+*
+* Argument(s) : p_tbl       task table.
+*               nbr         number of entries in the table.
+*               prio_base   priority given to the highest-priority task of the table.
+*               p_err       error returned by the first failing OSTaskCreate(), or OS_ERR_NONE.
+*
+* Return(s)   : DEF_TRUE if the task set is schedulable, DEF_FALSE otherwise.
+*
+* Note(s)     : (1) Priorities must stay below the idle task priority (OS_CFG_PRIO_MAX - 1u).
+*
+*               (2) No task is created if the table is too large or declares a zero period, since no priority
+*                   could be assigned.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_RMS_Start (APP_RMS_TASK  *p_tbl,
+                            CPU_SIZE_T     nbr,
+                            OS_PRIO        prio_base,
+                            OS_ERR        *p_err)
+{
+    CPU_SIZE_T     i;
+    APP_RMS_TASK  *p_task;
+    CPU_BOOLEAN    ok;
+    OS_ERR         os_err;
+
+
+   *p_err = OS_ERR_NONE;
+    ok    = App_RMS_Analyze(p_tbl, nbr, prio_base);
+    if (nbr > APP_CFG_RMS_TASK_MAX) {                           /* See Note #2.                                         */
+       *p_err = OS_ERR_PRIO_INVALID;
+        return (DEF_FALSE);
+    }
+    for (i = 0u; i < nbr; i++) {
+        if (p_tbl[i].Period_us == 0u) {
+           *p_err = OS_ERR_PRIO_INVALID;
+            return (DEF_FALSE);
+        }
+    }
+
+    for (i = 0u; i < nbr; i++) {
+        p_task = &p_tbl[i];
+        if (p_task->Prio >= (OS_CFG_PRIO_MAX - 1u)) {           /* See Note #1.                                         */
+            p_task->Prio = (OS_PRIO)(OS_CFG_PRIO_MAX - 2u);
+            ok           = DEF_FALSE;
+        }
+
+        OSTaskCreate( p_task->TCB_Ptr,
+                      p_task->NamePtr,
+                      p_task->TaskPtr,
+                      p_task->ArgPtr,
+                      p_task->Prio,
+                     &p_task->StkBasePtr[0u],
+                     (p_task->StkSize / 10u),
+                      p_task->StkSize,
+                      0u,
+                      0u,
+                      0u,
+                     (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                     &os_err);
+        if ((os_err != OS_ERR_NONE) && (*p_err == OS_ERR_NONE)) {
+           *p_err = os_err;
+        }
+    }
+
+    return (ok);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_RMS_DeadlineGet (APP_RMS_TASK  *p_task)
+{
+    return ((p_task->Deadline_us == 0u) ? p_task->Period_us : p_task->Deadline_us);
+}
+
+
+static  CPU_BOOLEAN  App_RMS_Before (APP_RMS_TASK  *p_a,
+                                     APP_RMS_TASK  *p_b)
+{
+    if (p_a->Period_us != p_b->Period_us) {
+        return ((p_a->Period_us < p_b->Period_us) ? DEF_TRUE : DEF_FALSE);
+    }
+    return ((App_RMS_DeadlineGet(p_a) < App_RMS_DeadlineGet(p_b)) ? DEF_TRUE : DEF_FALSE);
+}
@@ -0,0 +1,82 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Rate-monotonic task table: each app task declares its period, deadline and WCET; priorities are assigned
+* rate-monotonically at startup and a response-time analysis flags task sets that cannot be scheduled.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_RMS_H
+#define  APP_RMS_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_RMS_TASK_MAX
+#define  APP_CFG_RMS_TASK_MAX                      8u           /* Max nbr of tasks in one table.                       */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*
+* Note(s) : (1) One entry per task of the app table: times are in us, Prio and Resp_us are left 0 and filled in
+*               by App_RMS_Start(), which assigns the priorities from prio_base up by increasing period.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_rms_task {
+    OS_TCB        *TCB_Ptr;
+    CPU_CHAR      *NamePtr;
+    OS_TASK_PTR    TaskPtr;
+    void          *ArgPtr;
+    CPU_STK       *StkBasePtr;
+    CPU_STK_SIZE   StkSize;
+
+    CPU_INT32U     Period_us;                                   /* Period, or min inter-arrival time if sporadic.       */
+    CPU_INT32U     Deadline_us;                                 /* Relative deadline, 0 means equal to the period.      */
+    CPU_INT32U     WCET_us;                                     /* Worst-case execution time.                           */
+
+    OS_PRIO        Prio;                                        /* Assigned by App_RMS_Start().                         */
+    CPU_INT32U     Resp_us;                                     /* Worst-case response time, set by App_RMS_Start().    */
+} APP_RMS_TASK;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_RMS_Analyze (APP_RMS_TASK  *p_tbl,
+                              CPU_SIZE_T     nbr,
+                              OS_PRIO        prio_base);
+
+CPU_BOOLEAN  App_RMS_Start   (APP_RMS_TASK  *p_tbl,
+                              CPU_SIZE_T     nbr,
+                              OS_PRIO        prio_base,
+                              OS_ERR        *p_err);
+
+#endif
@@ -0,0 +1,215 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Pulse generator.
+* PTB23 is not an FTM channel, so the wave cannot come from a timer output. Instead a period is cut into N
+* slots of one PIT3 tick; the DMAMUX routes the PIT3 trigger to DMA channel 3 (periodic trigger mode, always-
+* enabled source), which copies one word of App_SigGen_Pattern[] to the port's PTOR on each tick. The pattern
+* holds the pin mask in slot 0 (rising edge) and slot H (falling edge), 0 (no change) everywhere else; the
+* source address wraps back after N words (SLAST) and the channel stays enabled, so the wave runs forever
+* without an interrupt.
+*
+* N is as large as APP_CFG_SIGGEN_SLOT_MAX allows while the tick stays above APP_CFG_SIGGEN_TICK_MIN_CNT bus
+* clocks: the duty cycle resolution is 1/N and degrades at high frequencies. Edge jitter is the DMA request
+* latency (a few bus clocks), whatever the CPU load.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  "fsl_clock_manager.h"
+#include  <fsl_gpio_common.h>
+#include  <system_MK64F12.h>
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+
+#include  "app_siggen.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SIGGEN_CH                             3u           /* PIT3 triggers DMAMUX/DMA channel 3                   */
+#define  APP_SIGGEN_DMAMUX_SRC_ALWAYS             60u           /* DMAMUX always-enabled request source                 */
+#define  APP_SIGGEN_DMA_SIZE_32BIT                 2u           /* DMA_ATTR[SSIZE/DSIZE] encoding                       */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U   App_SigGen_Pattern[APP_CFG_SIGGEN_SLOT_MAX];   /* Read by the DMA: words written to PTOR.      */
+static  GPIO_Type   *App_SigGen_GPIO_Ptr;
+static  CPU_INT32U   App_SigGen_PinMask;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_SigGen_Cnt_to_nS (CPU_INT64U  cnts);
+
+
+/*
+*********************************************************************************************************
+*                                          App_SigGen_Init()
+*
+* Description : Selects the output and clocks PIT, DMAMUX and DMA. The output stays low until App_SigGen_Set().
+*
+* Argument(s) : pin         GPIO pin of the output, already configured as an output by GPIO_DRV_Init().
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_SigGen_Init (CPU_INT32U  pin)
+{
+    App_SigGen_GPIO_Ptr = (GPIO_Type *)g_gpioBaseAddr[GPIO_EXTRACT_PORT(pin)];
+    App_SigGen_PinMask  =  DEF_BIT(GPIO_EXTRACT_PIN(pin));
+
+    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK | SIM_SCGC6_DMAMUX_MASK;
+    SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+    PIT->MCR   &= ~PIT_MCR_MDIS_MASK;                           /* Other PIT channels may already be in use             */
+
+    App_SigGen_Stop();
+    DMAMUX->CHCFG[APP_SIGGEN_CH] = 0u;
+    DMAMUX->CHCFG[APP_SIGGEN_CH] = DMAMUX_CHCFG_ENBL_MASK
+                                 | DMAMUX_CHCFG_TRIG_MASK
+                                 | DMAMUX_CHCFG_SOURCE(APP_SIGGEN_DMAMUX_SRC_ALWAYS);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_SigGen_Set()
+*
+* Description : (Re)starts the output with a new frequency and duty cycle, beginning with a rising edge.
+*
+* Argument(s) : freq_Hz         requested frequency.
+*               duty_permil     requested high time, in 1/1000 of the period (rounded to the nearest slot, and
+*                               to at least one slot high and one slot low).
+*               p_period_ns     where to store the period actually generated, in ns (can be DEF_NULL).
+*               p_high_ns       where to store the high time actually generated, in ns (can be DEF_NULL).
+*
+* Return(s)   : DEF_FALSE if the frequency is 0 or too high for two slots per period (output then stopped),
+*               DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_SigGen_Set (CPU_INT32U   freq_Hz,
+                             CPU_INT16U   duty_permil,
+                             CPU_INT32U  *p_period_ns,
+                             CPU_INT32U  *p_high_ns)
+{
+    CPU_INT32U  bus_hz;
+    CPU_INT32U  slot_nbr;
+    CPU_INT32U  high_nbr;
+    CPU_INT32U  tick_cnt;
+    CPU_INT32U  i;
+
+
+    App_SigGen_Stop();
+    if (freq_Hz == 0u) {
+        return (DEF_FALSE);
+    }
+
+    bus_hz   = CLOCK_SYS_GetBusClockFreq();
+    slot_nbr = bus_hz / freq_Hz / APP_CFG_SIGGEN_TICK_MIN_CNT;
+    if (slot_nbr > APP_CFG_SIGGEN_SLOT_MAX) {
+        slot_nbr = APP_CFG_SIGGEN_SLOT_MAX;
+    }
+    if (slot_nbr < 2u) {
+        return (DEF_FALSE);
+    }
+                                                                /* Nearest tick, then nearest slot for the duty cycle   */
+    tick_cnt = (CPU_INT32U)(((CPU_INT64U)bus_hz + ((CPU_INT64U)freq_Hz * slot_nbr) / 2u)
+                          /  ((CPU_INT64U)freq_Hz * slot_nbr));
+    high_nbr = ((CPU_INT32U)duty_permil * slot_nbr + 500u) / 1000u;
+    if (high_nbr < 1u) {
+        high_nbr = 1u;
+    } else if (high_nbr > slot_nbr - 1u) {
+        high_nbr = slot_nbr - 1u;
+    }
+
+    for (i = 0u; i < slot_nbr; i++) {
+        App_SigGen_Pattern[i] = 0u;
+    }
+    App_SigGen_Pattern[0u]       = App_SigGen_PinMask;
+    App_SigGen_Pattern[high_nbr] = App_SigGen_PinMask;
+
+    DMA0->TCD[APP_SIGGEN_CH].SADDR         = (CPU_INT32U)&App_SigGen_Pattern[0u];
+    DMA0->TCD[APP_SIGGEN_CH].SOFF          =  sizeof(CPU_INT32U);
+    DMA0->TCD[APP_SIGGEN_CH].ATTR          =  DMA_ATTR_SSIZE(APP_SIGGEN_DMA_SIZE_32BIT)
+                                           |  DMA_ATTR_DSIZE(APP_SIGGEN_DMA_SIZE_32BIT);
+    DMA0->TCD[APP_SIGGEN_CH].NBYTES_MLNO   =  sizeof(CPU_INT32U);   /* One word per request                         */
+    DMA0->TCD[APP_SIGGEN_CH].SLAST         = -(CPU_INT32S)(slot_nbr * sizeof(CPU_INT32U));
+    DMA0->TCD[APP_SIGGEN_CH].DADDR         = (CPU_INT32U)&App_SigGen_GPIO_Ptr->PTOR;
+    DMA0->TCD[APP_SIGGEN_CH].DOFF          =  0u;
+    DMA0->TCD[APP_SIGGEN_CH].CITER_ELINKNO = (CPU_INT16U)slot_nbr;
+    DMA0->TCD[APP_SIGGEN_CH].BITER_ELINKNO = (CPU_INT16U)slot_nbr;
+    DMA0->TCD[APP_SIGGEN_CH].DLAST_SGA     =  0;
+    DMA0->TCD[APP_SIGGEN_CH].CSR           =  0u;                   /* No DREQ: the request stays enabled           */
+    DMA0->SERQ = APP_SIGGEN_CH;
+
+    PIT->CHANNEL[APP_SIGGEN_CH].LDVAL = tick_cnt - 1u;
+    PIT->CHANNEL[APP_SIGGEN_CH].TCTRL = PIT_TCTRL_TEN_MASK;         /* First edge one tick from now                 */
+
+    if (p_period_ns != DEF_NULL) {
+        *p_period_ns = App_SigGen_Cnt_to_nS((CPU_INT64U)tick_cnt * slot_nbr);
+    }
+    if (p_high_ns != DEF_NULL) {
+        *p_high_ns   = App_SigGen_Cnt_to_nS((CPU_INT64U)tick_cnt * high_nbr);
+    }
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_SigGen_Stop()
+*
+* Description : Stops the output, low.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_SigGen_Stop (void)
+{
+    PIT->CHANNEL[APP_SIGGEN_CH].TCTRL = 0u;
+    DMA0->CERQ = APP_SIGGEN_CH;
+    App_SigGen_GPIO_Ptr->PCOR = App_SigGen_PinMask;
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  App_SigGen_Cnt_to_nS (CPU_INT64U  cnts)
+{
+    return ((CPU_INT32U)((cnts * 1000000000u) / CLOCK_SYS_GetBusClockFreq()));
+}
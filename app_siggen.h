@@ -0,0 +1,63 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Pulse generator: a square wave of given frequency and duty cycle on any GPIO output, timed in hardware.
+* PIT3 paces DMA channel 3, which writes one word of a pattern buffer to the port's toggle register on every
+* tick: the edges do not depend on the CPU, its interrupts or its critical sections. Used as a reference
+* signal to check the input meters (loopback_bench_lab6.c).
+*
+* PIT3 and DMA channel 3 are used exclusively.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_SIGGEN_H
+#define  APP_SIGGEN_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_SIGGEN_SLOT_MAX                                /* Pattern words per period: duty cycle resolution.     */
+#define  APP_CFG_SIGGEN_SLOT_MAX                 100u
+#endif
+
+#ifndef  APP_CFG_SIGGEN_TICK_MIN_CNT                            /* Shortest tick, in bus clocks: the DMA must complete  */
+#define  APP_CFG_SIGGEN_TICK_MIN_CNT              30u           /* a transfer before the next request (0.5 us @ 60 MHz) */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_SigGen_Init (CPU_INT32U   pin);
+
+CPU_BOOLEAN  App_SigGen_Set  (CPU_INT32U   freq_Hz,
+                              CPU_INT16U   duty_permil,
+                              CPU_INT32U  *p_period_ns,
+                              CPU_INT32U  *p_high_ns);
+
+void         App_SigGen_Stop (void);
+
+#endif
@@ -0,0 +1,580 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Asynchronous HC-SR04 driver.
+* A ping goes through: trigger raised by the caller (or the driver task), trigger lowered and time-out armed by
+* the same app_hrtmr timer, LPTMR0 started on the rising edge of the echo and stopped on the falling edge by
+* the fast ISR, which defers the result to the SWI. The result is taken by the SWI or by the time-out,
+* whichever comes first, in a critical section: the fast ISR never changes the state of the driver, it only
+* leaves the count and the number of its ping for the SWI.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+
+#include  "app_hrtmr.h"
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_periodic.h"
+#include  "app_pin.h"
+#include  "app_portisr.h"
+#include  "app_ramfunc.h"
+#include  "app_sonar.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SONAR_LPTMR_CNT_MASK             0xFFFFu           /* 16-bit counter: 65 ms at 1 MHz                       */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB           App_Sonar_TaskTCB;
+static  CPU_STK          App_Sonar_TaskStk[APP_CFG_SONAR_TASK_STK_SIZE];
+
+static  CPU_INT32U       App_Sonar_TrigPin;
+static  CPU_BOOLEAN      App_Sonar_TrigInv;                     /* Trigger active low (inverting level shifter).        */
+static  APP_HRTMR        App_Sonar_Tmr;                         /* End of the trigger pulse, then time-out.             */
+
+static  APP_SONAR_PING  *App_Sonar_PingPtr;                     /* Owner of the driver, 0 when free.                    */
+static  CPU_INT16U       App_Sonar_Period_ms;                   /* Continuous mode, 0 to stop.                          */
+static  CPU_BOOLEAN      App_Sonar_Running;                     /* Driver task in its trigger loop.                     */
+static  CPU_BOOLEAN      App_Sonar_InFlight;                    /* Ping not delivered yet.                              */
+static  CPU_INT32U       App_Sonar_PingNbr;                     /* Number of the latest ping.                           */
+
+APP_RAMDATA  static  volatile  CPU_BOOLEAN  App_Sonar_EchoArmed;   /* Fast ISR: echo edges expected.               */
+APP_RAMDATA  static  volatile  CPU_BOOLEAN  App_Sonar_EchoHigh;    /* Fast ISR: LPTMR0 counting.                   */
+APP_RAMDATA  static  volatile  CPU_INT32U   App_Sonar_EchoPingNbr; /* Fast ISR: ping of the edges.                 */
+APP_RAMDATA  static  volatile  CPU_INT32U   App_Sonar_EchoCnt;     /* Fast ISR: echo time, in us.                  */
+
+static  CPU_INT32U       App_Sonar_PingCtr;                     /* Since the previous report.                           */
+static  CPU_INT32U       App_Sonar_EchoCtr;
+static  CPU_INT32U       App_Sonar_TmoCtr;
+static  CPU_INT32U       App_Sonar_BusyCtr;                     /* Triggers skipped, previous ping still in flight.     */
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         App_Sonar_Task    (void            *p_arg);
+
+static  CPU_BOOLEAN  App_Sonar_Trig    (void);
+
+static  void         App_Sonar_TrigEnd (APP_HRTMR       *p_tmr,
+                                        void            *p_arg);
+
+static  void         App_Sonar_Tmo     (APP_HRTMR       *p_tmr,
+                                        void            *p_arg);
+
+static  void         App_Sonar_EchoDone (void           *p_arg);
+
+static  void         App_Sonar_Deliver (CPU_INT32U       ping_nbr,
+                                        CPU_INT32U       echo_us);
+
+APP_RAMFUNC                                                     /* In SRAM with the dispatcher, see app_ramfunc.h       */
+static  void         App_Sonar_EchoISR (CPU_INT32U       pin,
+                                        void            *p_arg);
+
+
+/*
+*********************************************************************************************************
+*                                           App_Sonar_Init()
+*
+* Description : Sets up LPTMR0 on the 1 MHz internal reference clock, the echo pin handler (fast port) and the
+*               driver task. Call after App_IRQ_Init() and App_HRTmr_Init(), from a task.
+*
+* Argument(s) : trig_pin    GPIO output to the trigger of the sensor.
+*               echo_pin    GPIO input from the echo of the sensor, interrupt on either edge.
+*               trig_inv    DEF_YES if the trigger is active low (inverting level shifter), DEF_NO otherwise.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Sonar_Init (CPU_INT32U   trig_pin,
+                      CPU_INT32U   echo_pin,
+                      CPU_BOOLEAN  trig_inv)
+{
+    OS_ERR  os_err;
+
+
+    App_Sonar_TrigPin = trig_pin;
+    App_Sonar_TrigInv = trig_inv;
+    if (trig_inv == DEF_YES) {                                  /* Trigger idle                                         */
+        APP_PIN_SET(trig_pin);
+    } else {
+        APP_PIN_CLR(trig_pin);
+    }
+
+    MCG->C2    |= MCG_C2_IRCS_MASK;                             /* Fast IRC (4 MHz) ...                                 */
+    MCG->SC     = (MCG->SC & ~(MCG_SC_FCRDIV_MASK |             /* ... divided by 4: MCGIRCLK at 1 MHz. The field is    */
+                               MCG_SC_LOCS0_MASK  |             /* written whole (reset value 1), LOCS0 and ATMF are    */
+                               MCG_SC_ATMF_MASK))               /* write-1-to-clear: written back 0.                    */
+                | MCG_SC_FCRDIV(2u);
+    SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+    LPTMR0->CSR = 0u;
+    LPTMR0->PSR = LPTMR_PSR_PCS(0u) | LPTMR_PSR_PBYP_MASK;      /* MCGIRCLK, no prescaler: one count per us             */
+    LPTMR0->CSR = LPTMR_CSR_TFC_MASK;                           /* Free running, counter reset when disabled            */
+
+    App_PortISR_Set(echo_pin, App_Sonar_EchoISR, 0);
+    App_PortISR_FastSet(echo_pin);                              /* LPTMR0 started/stopped above the kernel              */
+
+    OSTaskCreate(&App_Sonar_TaskTCB,
+                 "Sonar",
+                  App_Sonar_Task,
+                  0u,
+                  APP_CFG_SONAR_TASK_PRIO,
+                 &App_Sonar_TaskStk[0u],
+                 (APP_CFG_SONAR_TASK_STK_SIZE / 10u),
+                  APP_CFG_SONAR_TASK_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Sonar_PingInit()
+*
+* Description : Sets up a ping object: where its results are delivered. A ping without callback nor task is
+*               polled with App_Sonar_IsDone() / App_Sonar_Rd() only.
+*
+* Argument(s) : p_ping      ping, not owned by the driver.
+*               fnct        callback, called in a kernel-aware ISR with each result, or 0.
+*               p_arg       argument of the callback, in p_ping->ArgPtr.
+*               p_tcb       task whose message queue receives each result, or 0.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Sonar_PingInit (APP_SONAR_PING  *p_ping,
+                          APP_SONAR_FNCT   fnct,
+                          void            *p_arg,
+                          OS_TCB          *p_tcb)
+{
+    p_ping->Fnct      = fnct;
+    p_ping->ArgPtr    = p_arg;
+    p_ping->TCBPtr    = p_tcb;
+    p_ping->Done      = DEF_NO;
+    p_ping->Echo_us   = APP_SONAR_NO_ECHO;
+    p_ping->ResultCtr = 0u;
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_Sonar_Start()
+*
+* Description : Starts one measurement, or continuous mode, and returns at once. From a task.
+*
+* Argument(s) : p_ping      ping that receives the result(s).
+*               period_ms   0 for one measurement, triggered here; otherwise the trigger period of continuous
+*                           mode, at least APP_CFG_SONAR_PERIOD_MIN_MS, the first trigger is sent by the task.
+*
+* Return(s)   : DEF_FALSE if the driver is busy (ping in flight or continuous mode) or the period is too
+*               short, DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_Sonar_Start (APP_SONAR_PING  *p_ping,
+                              CPU_INT16U       period_ms)
+{
+    OS_ERR  os_err;
+    CPU_SR_ALLOC();
+
+
+    if ((period_ms != 0u) &&
+        (period_ms <  APP_CFG_SONAR_PERIOD_MIN_MS)) {
+        return (DEF_FALSE);
+    }
+
+    APP_CRITICAL_ENTER();
+    if (App_Sonar_PingPtr != (APP_SONAR_PING *)0) {
+        APP_CRITICAL_EXIT();
+        return (DEF_FALSE);
+    }
+    App_Sonar_PingPtr   = p_ping;
+    App_Sonar_Period_ms = period_ms;
+    App_Sonar_Running   = (period_ms != 0u) ? DEF_YES : DEF_NO;
+    APP_CRITICAL_EXIT();
+
+    if (period_ms != 0u) {
+        (void)OSTaskSemPost(&App_Sonar_TaskTCB,
+                             OS_OPT_POST_NONE,
+                            &os_err);
+    } else {
+        (void)App_Sonar_Trig();
+    }
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_Sonar_Stop()
+*
+* Description : Ends continuous mode. The ping in flight, if any, is still delivered; the driver is free
+*               again after it and the next release of the task.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Sonar_Stop (void)
+{
+    App_Sonar_Period_ms = 0u;                                   /* Seen by the task at its next release                 */
+}
+
+
+/*
+*********************************************************************************************************
+*                                   App_Sonar_IsDone() / App_Sonar_Rd()
+*
+* Description : Polls a ping: a result was delivered since the previous App_Sonar_Rd() / reads the latest
+*               result and clears the flag.
+*
+* Argument(s) : p_ping      ping.
+*
+* Return(s)   : App_Sonar_IsDone(): DEF_YES or DEF_NO.
+*               App_Sonar_Rd()    : echo time in us (APP_SONAR_US_PER_CM per cm), or APP_SONAR_NO_ECHO.
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_Sonar_IsDone (APP_SONAR_PING  *p_ping)
+{
+    return (p_ping->Done);
+}
+
+
+CPU_INT32U  App_Sonar_Rd (APP_SONAR_PING  *p_ping)
+{
+    CPU_INT32U  echo_us;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    echo_us      = p_ping->Echo_us;
+    p_ping->Done = DEF_NO;
+    APP_CRITICAL_EXIT();
+
+    return (echo_us);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_Sonar_Report()
+*
+* Description : Prints the pings, echoes, time-outs and skipped triggers since the previous report, then
+*               restarts the counts.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_Sonar_Report (void)
+{
+    CPU_INT32U  ping_ctr;
+    CPU_INT32U  echo_ctr;
+    CPU_INT32U  tmo_ctr;
+    CPU_INT32U  busy_ctr;
+    char        tmp[80];
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    ping_ctr          = App_Sonar_PingCtr;
+    echo_ctr          = App_Sonar_EchoCtr;
+    tmo_ctr           = App_Sonar_TmoCtr;
+    busy_ctr          = App_Sonar_BusyCtr;
+    App_Sonar_PingCtr = 0u;
+    App_Sonar_EchoCtr = 0u;
+    App_Sonar_TmoCtr  = 0u;
+    App_Sonar_BusyCtr = 0u;
+    APP_CRITICAL_EXIT();
+
+    sprintf(tmp, "Sonar: %u pings, %u echoes, %u time-outs, %u triggers skipped\n\r",
+            (unsigned)ping_ctr,
+            (unsigned)echo_ctr,
+            (unsigned)tmo_ctr,
+            (unsigned)busy_ctr);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                          App_Sonar_Task()
+*
+* Description : Continuous mode: triggers on an absolute grid while the period is not 0, then frees the
+*               driver (or leaves it to the ping in flight).
+*********************************************************************************************************
+*/
+
+static  void  App_Sonar_Task (void  *p_arg)
+{
+    APP_PERIODIC  rate;
+    OS_ERR        os_err;
+    CPU_SR_ALLOC();
+
+
+    (void)p_arg;
+
+    while (DEF_TRUE) {
+        (void)OSTaskSemPend(0u,
+                            OS_OPT_PEND_BLOCKING,
+                            (CPU_TS *)0,
+                           &os_err);
+
+        App_Periodic_Init(&rate, App_Sonar_Period_ms);
+        while (App_Sonar_Period_ms != 0u) {
+            (void)App_Sonar_Trig();
+            (void)App_Periodic_Wait(&rate);
+        }
+
+        APP_CRITICAL_ENTER();
+        App_Sonar_Running = DEF_NO;
+        if (App_Sonar_InFlight == DEF_NO) {
+            App_Sonar_PingPtr = (APP_SONAR_PING *)0;
+        }
+        APP_CRITICAL_EXIT();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_Sonar_Trig()
+*
+* Description : Raises the trigger and starts the timer that lowers it. From a task.
+*
+* Return(s)   : DEF_FALSE if the previous ping is still in flight (the trigger is skipped), DEF_TRUE otherwise.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  App_Sonar_Trig (void)
+{
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    if (App_Sonar_InFlight == DEF_YES) {
+        App_Sonar_BusyCtr++;
+        APP_CRITICAL_EXIT();
+        return (DEF_FALSE);
+    }
+    App_Sonar_InFlight = DEF_YES;
+    App_Sonar_PingNbr++;
+    App_Sonar_PingCtr++;
+    App_LowPwr_StopLock();                                      /* LPTMR0 in use until the result                       */
+    APP_CRITICAL_EXIT();
+
+    if (App_Sonar_TrigInv == DEF_YES) {
+        APP_PIN_CLR(App_Sonar_TrigPin);
+    } else {
+        APP_PIN_SET(App_Sonar_TrigPin);
+    }
+    (void)App_HRTmr_Start(&App_Sonar_Tmr,
+                           APP_CFG_SONAR_TRIG_US,
+                           0u,
+                           App_Sonar_TrigEnd,
+                           0);
+    return (DEF_TRUE);
+}
+
+
+/*
+*********************************************************************************************************
+*                                 App_Sonar_TrigEnd() / App_Sonar_Tmo()
+*
+* Description : In the PIT0 ISR. Lowers the trigger (the sensor starts its burst on this edge), arms the echo
+*               handler and restarts the timer for the time-out / delivers a ping without echo.
+*********************************************************************************************************
+*/
+
+static  void  App_Sonar_TrigEnd (APP_HRTMR  *p_tmr,
+                                 void       *p_arg)
+{
+    (void)p_arg;
+
+    if (App_Sonar_TrigInv == DEF_YES) {
+        APP_PIN_SET(App_Sonar_TrigPin);
+    } else {
+        APP_PIN_CLR(App_Sonar_TrigPin);
+    }
+    App_Sonar_EchoHigh    = DEF_NO;
+    App_Sonar_EchoPingNbr = App_Sonar_PingNbr;
+    App_Sonar_EchoArmed   = DEF_YES;
+
+    (void)App_HRTmr_Start(p_tmr,
+                          APP_CFG_SONAR_TMO_US,
+                          0u,
+                          App_Sonar_Tmo,
+                          0);
+}
+
+
+static  void  App_Sonar_Tmo (APP_HRTMR  *p_tmr,
+                             void       *p_arg)
+{
+    (void)p_tmr;
+    (void)p_arg;
+
+    App_Sonar_EchoArmed = DEF_NO;
+    LPTMR0->CSR        &= ~LPTMR_CSR_TEN_MASK;                  /* Rising edge without its falling edge                 */
+    App_Sonar_Deliver(App_Sonar_PingNbr, APP_SONAR_NO_ECHO);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        App_Sonar_EchoDone()
+*
+* Description : Deferred end of echo, in the SWI: delivers the count left by the fast ISR for its ping.
+*********************************************************************************************************
+*/
+
+static  void  App_Sonar_EchoDone (void  *p_arg)
+{
+    (void)p_arg;
+
+    App_Sonar_Deliver(App_Sonar_EchoPingNbr, App_Sonar_EchoCnt);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Sonar_Deliver()
+*
+* Description : Ends a ping and delivers its result to the ping object, task queue and callback. In a
+*               kernel-aware ISR. A result for another ping than the one in flight (late echo after the
+*               time-out) is dropped.
+*
+* Argument(s) : ping_nbr    number of the ping the result belongs to.
+*               echo_us     echo time, or APP_SONAR_NO_ECHO.
+*********************************************************************************************************
+*/
+
+static  void  App_Sonar_Deliver (CPU_INT32U  ping_nbr,
+                                 CPU_INT32U  echo_us)
+{
+    APP_SONAR_PING  *p_ping;
+    OS_ERR           os_err;
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    if ((App_Sonar_InFlight == DEF_NO) ||
+        (ping_nbr           != App_Sonar_PingNbr)) {
+        APP_CRITICAL_EXIT();
+        return;
+    }
+    (void)App_HRTmr_Stop(&App_Sonar_Tmr);                       /* Time-out of a ping that got its echo                 */
+    App_Sonar_InFlight  = DEF_NO;
+    App_Sonar_EchoArmed = DEF_NO;
+    if (echo_us == APP_SONAR_NO_ECHO) {
+        App_Sonar_TmoCtr++;
+    } else {
+        App_Sonar_EchoCtr++;
+    }
+
+    p_ping            = App_Sonar_PingPtr;
+    p_ping->Echo_us   = echo_us;
+    p_ping->ResultCtr++;
+    p_ping->Done      = DEF_YES;
+    if ((App_Sonar_Running   == DEF_NO) &&
+        (App_Sonar_Period_ms == 0u)) {                          /* One measurement: the driver is free again            */
+        App_Sonar_PingPtr = (APP_SONAR_PING *)0;
+    }
+    App_LowPwr_StopUnlock();
+    APP_CRITICAL_EXIT();
+
+    if (p_ping->TCBPtr != (OS_TCB *)0) {
+        OSTaskQPost(p_ping->TCBPtr,
+                    (void *)p_ping,
+                    (OS_MSG_SIZE)echo_us,
+                    OS_OPT_POST_FIFO,
+                   &os_err);                                    /* OS_ERR_Q_MAX if the task is behind: result dropped   */
+    }
+    if (p_ping->Fnct != (APP_SONAR_FNCT)0) {
+        p_ping->Fnct(p_ping, echo_us);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_Sonar_EchoISR()
+*
+* Description : Echo pin handler (either edge), called by the PORT dispatcher with the flag already cleared.
+*               Fast port: kernel-unaware, only LPTMR0 is handled here, the result is deferred to the SWI.
+*********************************************************************************************************
+*/
+
+APP_RAMFUNC static  void  App_Sonar_EchoISR (CPU_INT32U   pin,
+                                             void        *p_arg)
+{
+    (void)p_arg;
+
+    if (App_Sonar_EchoArmed == DEF_NO) {                        /* Stray edge, or late echo after the time-out          */
+        return;
+    }
+    if (APP_PIN_RD(pin) == 1u) {
+        if (App_Sonar_EchoHigh == DEF_NO) {
+            LPTMR0->CSR       |= LPTMR_CSR_TEN_MASK;            /* Start counting                                       */
+            App_Sonar_EchoHigh = DEF_YES;
+        }
+    } else if (App_Sonar_EchoHigh == DEF_YES) {
+        LPTMR0->CNR          = 0u;                              /* Any write latches CNR for the read                   */
+        App_Sonar_EchoCnt    = LPTMR0->CNR & APP_SONAR_LPTMR_CNT_MASK;
+        LPTMR0->CSR         &= ~LPTMR_CSR_TEN_MASK;             /* Stop, counter reset                                  */
+        App_Sonar_EchoArmed  = DEF_NO;
+        (void)App_IRQ_Defer(App_Sonar_EchoDone, 0);             /* Queue full: the time-out ends the ping               */
+    }
+}
@@ -0,0 +1,132 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Asynchronous HC-SR04 driver: App_Sonar_Start() sends the trigger and returns at once, the caller does not
+* sleep through the ping nor read a global. The end of the trigger pulse is timed by app_hrtmr, the echo pulse
+* by LPTMR0 (1 MHz, one count per us), started and stopped in a fast PORT ISR. The result is delivered, in that
+* order, to the ping object (a future: App_Sonar_IsDone() / App_Sonar_Rd()), to the task message queue of the
+* ping (message: the ping, size: the echo in us) and to the callback of the ping. A ping without a falling edge
+* within APP_CFG_SONAR_TMO_US ends with APP_SONAR_NO_ECHO.
+*
+* In continuous mode a driver task triggers on an absolute grid (app_periodic.h) until App_Sonar_Stop(), and
+* every ping is delivered the same way.
+*
+* One sensor: LPTMR0 is used while a ping is in flight, which holds the app_lowpwr stop lock; stop modes are
+* allowed between pings.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_SONAR_H
+#define  APP_SONAR_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*
+* Note(s) : (1) The driver task triggers on time, a few us per ping, above the app tasks: pass App_RMS_Start()
+*               a prio_base of APP_CFG_SONAR_TASK_PRIO + 1 or more.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_SONAR_TRIG_US                                  /* Trigger pulse: at least 10 us for the HC-SR04.       */
+#define  APP_CFG_SONAR_TRIG_US                    12u
+#endif
+
+#ifndef  APP_CFG_SONAR_TMO_US                                   /* From the end of the trigger: the HC-SR04 echo lasts  */
+#define  APP_CFG_SONAR_TMO_US                  50000u           /* 38 ms when nothing is in range.                      */
+#endif
+
+#ifndef  APP_CFG_SONAR_PERIOD_MIN_MS                            /* HC-SR04: 60 ms between triggers.                     */
+#define  APP_CFG_SONAR_PERIOD_MIN_MS              60u
+#endif
+
+#ifndef  APP_CFG_SONAR_TASK_PRIO                                /* See Note #1.                                         */
+#define  APP_CFG_SONAR_TASK_PRIO                 (APP_CFG_TASK_START_PRIO + 1u)
+#endif
+
+#ifndef  APP_CFG_SONAR_TASK_STK_SIZE
+#define  APP_CFG_SONAR_TASK_STK_SIZE             256u
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SONAR_NO_ECHO                         0u           /* Echo time of a ping that timed out.                  */
+#define  APP_SONAR_US_PER_CM                      58u           /* Round trip at 343 m/s.                               */
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*
+* Note(s) : (1) Allocated by the caller and set up by App_Sonar_PingInit(); owned by the driver from
+*               App_Sonar_Start() until its result (one measurement) or App_Sonar_Stop() (continuous mode).
+*
+*           (2) Called in a kernel-aware ISR (SWI or PIT0): may post to kernel objects and must be short.
+*********************************************************************************************************
+*/
+
+typedef  struct  app_sonar_ping  APP_SONAR_PING;
+
+typedef  void  (*APP_SONAR_FNCT)(APP_SONAR_PING  *p_ping,
+                                 CPU_INT32U       echo_us);
+
+struct  app_sonar_ping {
+    APP_SONAR_FNCT          Fnct;                               /* See Note #2, or 0.                                   */
+    void                   *ArgPtr;                             /* For the callback.                                    */
+    OS_TCB                 *TCBPtr;                             /* Task queue posted with each result, or 0.            */
+    volatile  CPU_BOOLEAN   Done;                               /* Result not read yet by App_Sonar_Rd().               */
+    volatile  CPU_INT32U    Echo_us;                            /* Latest result.                                       */
+    volatile  CPU_INT32U    ResultCtr;
+};
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void         App_Sonar_Init     (CPU_INT32U       trig_pin,
+                                 CPU_INT32U       echo_pin,
+                                 CPU_BOOLEAN      trig_inv);
+
+void         App_Sonar_PingInit (APP_SONAR_PING  *p_ping,
+                                 APP_SONAR_FNCT   fnct,
+                                 void            *p_arg,
+                                 OS_TCB          *p_tcb);
+
+CPU_BOOLEAN  App_Sonar_Start    (APP_SONAR_PING  *p_ping,
+                                 CPU_INT16U       period_ms);
+
+void         App_Sonar_Stop     (void);
+
+CPU_BOOLEAN  App_Sonar_IsDone   (APP_SONAR_PING  *p_ping);
+
+CPU_INT32U   App_Sonar_Rd       (APP_SONAR_PING  *p_ping);
+
+void         App_Sonar_Report   (void);
+
+#endif
@@ -0,0 +1,349 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Time-slotted (TDMA) LED arbiter.
+* The slot table is built once from the constant channel configuration, before the executor runs: channels are
+* placed shortest period first, each at the first offset whose on-slots are free in every period of the
+* hyperperiod. The executor then only replays the table against absolute tick deadlines.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_mem.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <board.h>
+
+#include  "app_intdis.h"
+#include  "app_ledmeter.h"
+#include  "app_tdma.h"
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  CPU_INT16U   App_TDMA_GCD   (CPU_INT16U   a,
+                                     CPU_INT16U   b);
+
+static  CPU_BOOLEAN  App_TDMA_Place (APP_TDMA    *p_tdma,
+                                     CPU_INT08U   ch);
+
+static  void         App_TDMA_Apply (APP_TDMA    *p_tdma,
+                                     CPU_INT08U   mask);
+
+
+/*
+*********************************************************************************************************
+*                                           App_TDMA_Init()
+*
+* Description : Builds the slot table of a set of LED channels.
+*
+* Argument(s) : p_tdma      arbiter to initialize.
+*               p_cfg       channel configuration (must stay valid while the arbiter runs).
+*               ch_nbr      number of channels.
+*               slot_ms     slot length, in ms. Periods and on-times must be multiples of it.
+*
+* Return(s)   : DEF_TRUE if every channel got its on-slots, DEF_FALSE otherwise (channels that could not be
+*               placed stay off).
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_TDMA_Init (APP_TDMA               *p_tdma,
+                            const APP_TDMA_CH_CFG  *p_cfg,
+                            CPU_INT08U              ch_nbr,
+                            CPU_INT16U              slot_ms)
+{
+    CPU_INT08U   order[APP_CFG_TDMA_CH_MAX];
+    CPU_INT08U   i;
+    CPU_INT08U   j;
+    CPU_INT08U   tmp_ix;
+    CPU_INT32U   hyper;
+    CPU_INT16U   period;
+    CPU_BOOLEAN  ok;
+    char         tmp[80];
+
+
+    Mem_Clr(p_tdma, sizeof(APP_TDMA));
+    p_tdma->CfgPtr  = p_cfg;
+    p_tdma->ChNbr   = ch_nbr;
+    p_tdma->Slot_ms = slot_ms;
+
+    if ((ch_nbr == 0u) || (ch_nbr > APP_CFG_TDMA_CH_MAX) || (slot_ms == 0u)) {
+        APP_TRACE_DBG(("TDMA: invalid configuration.\n\r"));
+        return (DEF_FALSE);
+    }
+                                                                /* ------------------ HYPERPERIOD (LCM) ------------------- */
+    hyper = 1u;
+    for (i = 0u; i < ch_nbr; i++) {
+        if (((p_cfg[i].Period_ms % slot_ms) != 0u) ||
+            ((p_cfg[i].On_ms     % slot_ms) != 0u) ||
+             (p_cfg[i].On_ms >= p_cfg[i].Period_ms)) {
+            APP_TRACE_DBG(("TDMA: period/on-time not a multiple of the slot.\n\r"));
+            return (DEF_FALSE);
+        }
+        period = p_cfg[i].Period_ms / slot_ms;
+        hyper  = (hyper / App_TDMA_GCD((CPU_INT16U)hyper, period)) * period;
+        if (hyper > APP_CFG_TDMA_SLOT_MAX) {
+            APP_TRACE_DBG(("TDMA: hyperperiod too long, increase the slot length.\n\r"));
+            return (DEF_FALSE);
+        }
+    }
+    p_tdma->SlotNbr = (CPU_INT16U)hyper;
+                                                                /* ------------ PLACE SHORTEST PERIODS FIRST ------------- */
+    for (i = 0u; i < ch_nbr; i++) {
+        order[i] = i;
+        for (j = i; j > 0u; j--) {
+            if (p_cfg[order[j]].Period_ms >= p_cfg[order[j - 1u]].Period_ms) {
+                break;
+            }
+            tmp_ix        = order[j];
+            order[j]      = order[j - 1u];
+            order[j - 1u] = tmp_ix;
+        }
+    }
+
+    ok = DEF_TRUE;
+    for (i = 0u; i < ch_nbr; i++) {
+        if (App_TDMA_Place(p_tdma, order[i]) != DEF_TRUE) {
+            ok = DEF_FALSE;
+            sprintf(tmp, "TDMA: %s does not fit in the schedule, left off\n\r", p_cfg[order[i]].NamePtr);
+        } else {
+            sprintf(tmp, "TDMA: %s on at %u ms every %u ms for %u ms\n\r",
+                    p_cfg[order[i]].NamePtr,
+                    (unsigned)(p_tdma->Offset[order[i]] * slot_ms),
+                    (unsigned)p_cfg[order[i]].Period_ms,
+                    (unsigned)p_cfg[order[i]].On_ms);
+        }
+        APP_TRACE_DBG(( tmp ));
+    }
+
+    return (ok);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_TDMA_Run()
+*
+* Description : Executor: plays the slot table back forever. Call from the body of a dedicated task.
+*
+* Argument(s) : p_tdma      initialized arbiter.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) Releases are absolute ticks (OS_OPT_TIME_MATCH), so the time spent driving the LEDs and
+*                   any preemption do not accumulate into the schedule. Runs of slots with the same mask are
+*                   skipped, the task only wakes up on a transition.
+*********************************************************************************************************
+*/
+
+void  App_TDMA_Run (APP_TDMA  *p_tdma)
+{
+    OS_TICK     slot_ticks;
+    OS_TICK     release;
+    CPU_INT16U  slot;
+    CPU_INT16U  run;
+    OS_ERR      os_err;
+
+
+    slot_ticks = (OS_TICK)((p_tdma->Slot_ms * OSCfg_TickRate_Hz) / 1000u);
+    if (slot_ticks == 0u) {
+        slot_ticks = 1u;
+    }
+
+    release           = OSTimeGet(&os_err);
+    p_tdma->StatStart = release;
+    slot              = 0u;
+
+    while (DEF_ON) {
+        App_TDMA_Apply(p_tdma, p_tdma->SlotMask[slot]);
+
+        run = 1u;                                               /* See Note #1.                                         */
+        while ((run < p_tdma->SlotNbr) &&
+               (p_tdma->SlotMask[(slot + run) % p_tdma->SlotNbr] == p_tdma->SlotMask[slot])) {
+            run++;
+        }
+        slot     = (slot + run) % p_tdma->SlotNbr;
+        release += run * slot_ticks;
+
+        OSTimeDly(release, OS_OPT_TIME_MATCH, &os_err);         /* OS_ERR_TIME_ZERO_DLY if late: apply at once.         */
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          App_TDMA_Report()
+*
+* Description : Prints the achieved frequency and duty cycle of every channel since the previous report
+*               (or since the executor started) and restarts the measurement window.
+*
+* Argument(s) : p_tdma      running arbiter.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_TDMA_Report (APP_TDMA  *p_tdma)
+{
+    CPU_INT32U  edges[APP_CFG_TDMA_CH_MAX];
+    CPU_INT32U  on_ticks[APP_CFG_TDMA_CH_MAX];
+    CPU_INT32U  window;
+    CPU_INT32U  freq_cHz;
+    CPU_INT32U  duty_permil;
+    OS_TICK     now;
+    CPU_INT08U  i;
+    OS_ERR      os_err;
+    char        tmp[96];
+    CPU_SR_ALLOC();
+
+
+    APP_CRITICAL_ENTER();
+    now    = OSTimeGet(&os_err);
+    window = now - p_tdma->StatStart;
+    for (i = 0u; i < p_tdma->ChNbr; i++) {
+        edges[i]    = p_tdma->EdgeCtr[i];
+        on_ticks[i] = p_tdma->OnTicks[i];
+        if ((p_tdma->OnMask & DEF_BIT(i)) != 0u) {
+            on_ticks[i]       += now - p_tdma->OnStart[i];
+            p_tdma->OnStart[i] = now;
+        }
+        p_tdma->EdgeCtr[i] = 0u;
+        p_tdma->OnTicks[i] = 0u;
+    }
+    p_tdma->StatStart = now;
+    APP_CRITICAL_EXIT();
+
+    if (window == 0u) {
+        return;
+    }
+
+    for (i = 0u; i < p_tdma->ChNbr; i++) {
+        freq_cHz    = (CPU_INT32U)(((CPU_INT64U)edges[i] * 100u * OSCfg_TickRate_Hz) / window);
+        duty_permil = (CPU_INT32U)(((CPU_INT64U)on_ticks[i] * 1000u) / window);
+        sprintf(tmp, "TDMA: %-6.6s %2u.%02u Hz (nominal %2u.%02u), duty %2u.%u%% (nominal %2u.%u%%)\n\r",
+                p_tdma->CfgPtr[i].NamePtr,
+                (unsigned)(freq_cHz / 100u),
+                (unsigned)(freq_cHz % 100u),
+                (unsigned)(100000u / p_tdma->CfgPtr[i].Period_ms / 100u),
+                (unsigned)(100000u / p_tdma->CfgPtr[i].Period_ms % 100u),
+                (unsigned)(duty_permil / 10u),
+                (unsigned)(duty_permil % 10u),
+                (unsigned)((p_tdma->CfgPtr[i].On_ms * 1000u / p_tdma->CfgPtr[i].Period_ms) / 10u),
+                (unsigned)((p_tdma->CfgPtr[i].On_ms * 1000u / p_tdma->CfgPtr[i].Period_ms) % 10u));
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  CPU_INT16U  App_TDMA_GCD (CPU_INT16U  a,
+                                  CPU_INT16U  b)
+{
+    CPU_INT16U  r;
+
+
+    while (b != 0u) {
+        r = a % b;
+        a = b;
+        b = r;
+    }
+    return (a);
+}
+
+
+/* first-fit placement of one channel: the on-window must be free in every period of the hyperperiod */
+static  CPU_BOOLEAN  App_TDMA_Place (APP_TDMA    *p_tdma,
+                                     CPU_INT08U   ch)
+{
+    CPU_INT16U  period;
+    CPU_INT16U  on;
+    CPU_INT16U  offset;
+    CPU_INT16U  start;
+    CPU_INT16U  k;
+    CPU_BOOLEAN free;
+
+
+    period = p_tdma->CfgPtr[ch].Period_ms / p_tdma->Slot_ms;
+    on     = p_tdma->CfgPtr[ch].On_ms     / p_tdma->Slot_ms;
+
+    for (offset = 0u; offset < period; offset++) {
+        free = DEF_TRUE;
+        for (start = offset; (start < p_tdma->SlotNbr) && (free == DEF_TRUE); start += period) {
+            for (k = 0u; k < on; k++) {
+                if (p_tdma->SlotMask[(start + k) % p_tdma->SlotNbr] != 0u) {
+                    free = DEF_FALSE;
+                    break;
+                }
+            }
+        }
+        if (free == DEF_TRUE) {
+            for (start = offset; start < p_tdma->SlotNbr; start += period) {
+                for (k = 0u; k < on; k++) {
+                    p_tdma->SlotMask[(start + k) % p_tdma->SlotNbr] |= (CPU_INT08U)DEF_BIT(ch);
+                }
+            }
+            p_tdma->Offset[ch] = offset;
+            return (DEF_TRUE);
+        }
+    }
+
+    return (DEF_FALSE);
+}
+
+
+/* drives the LEDs whose state changes and updates the statistics */
+static  void  App_TDMA_Apply (APP_TDMA    *p_tdma,
+                              CPU_INT08U   mask)
+{
+    CPU_INT08U  changed;
+    CPU_INT08U  i;
+    OS_TICK     now;
+    OS_ERR      os_err;
+    CPU_SR_ALLOC();
+
+
+    changed = mask ^ p_tdma->OnMask;
+    now     = OSTimeGet(&os_err);
+
+    for (i = 0u; i < p_tdma->ChNbr; i++) {
+        if ((changed & DEF_BIT(i)) == 0u) {
+            continue;
+        }
+        APP_CRITICAL_ENTER();
+        if ((mask & DEF_BIT(i)) != 0u) {
+            APP_LED_CLR(p_tdma->CfgPtr[i].Pin);                 /* clearing the pin turns the LED on                    */
+            p_tdma->EdgeCtr[i]++;
+            p_tdma->OnStart[i] = now;
+        } else {
+            APP_LED_SET(p_tdma->CfgPtr[i].Pin);
+            p_tdma->OnTicks[i] += now - p_tdma->OnStart[i];
+        }
+        APP_CRITICAL_EXIT();
+    }
+    p_tdma->OnMask = mask;
+}
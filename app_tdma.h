@@ -0,0 +1,89 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Time-slotted (TDMA) LED arbiter: every LED channel gets non-overlapping on-slots over the hyperperiod of
+* all channel periods and a single executor task plays the slot table back. No lock is ever held while sleeping.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_TDMA_H
+#define  APP_TDMA_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <os.h>
+
+
+/*
+*********************************************************************************************************
+*                                            DEFAULT CONFIG
+*********************************************************************************************************
+*/
+
+#ifndef  APP_CFG_TDMA_CH_MAX
+#define  APP_CFG_TDMA_CH_MAX                       8u           /* Max nbr of LED channels, at most 8 (one bit each).   */
+#endif
+
+#ifndef  APP_CFG_TDMA_SLOT_MAX
+#define  APP_CFG_TDMA_SLOT_MAX                   200u           /* Max nbr of slots in one hyperperiod.                 */
+#endif
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_tdma_ch_cfg {
+    CPU_CHAR    *NamePtr;
+    CPU_INT32U   Pin;                                           /* GPIO pin of the LED (active low).                    */
+    CPU_INT16U   Period_ms;                                     /* Blink period, multiple of the slot length.           */
+    CPU_INT16U   On_ms;                                         /* On-time per period, multiple of the slot length.     */
+} APP_TDMA_CH_CFG;
+
+typedef  struct  app_tdma {
+    const APP_TDMA_CH_CFG  *CfgPtr;
+    CPU_INT08U              ChNbr;
+    CPU_INT16U              Slot_ms;
+    CPU_INT16U              SlotNbr;                            /* Slots per hyperperiod.                               */
+    CPU_INT16U              Offset[APP_CFG_TDMA_CH_MAX];        /* First on-slot of each channel.                       */
+    CPU_INT08U              SlotMask[APP_CFG_TDMA_SLOT_MAX];    /* Bit n set: channel n is on during the slot.          */
+
+    OS_TICK                 StatStart;                          /* Achieved frequency and duty-cycle statistics.        */
+    OS_TICK                 OnStart[APP_CFG_TDMA_CH_MAX];
+    CPU_INT32U              OnTicks[APP_CFG_TDMA_CH_MAX];
+    CPU_INT32U              EdgeCtr[APP_CFG_TDMA_CH_MAX];
+    CPU_INT08U              OnMask;
+} APP_TDMA;
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+CPU_BOOLEAN  App_TDMA_Init   (APP_TDMA               *p_tdma,
+                              const APP_TDMA_CH_CFG  *p_cfg,
+                              CPU_INT08U              ch_nbr,
+                              CPU_INT16U              slot_ms);
+
+void         App_TDMA_Run    (APP_TDMA               *p_tdma);
+
+void         App_TDMA_Report (APP_TDMA               *p_tdma);
+
+#endif
@@ -0,0 +1,203 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Timestamp service.
+* The upper 32 bits are the number of times CYCCNT was seen going backwards by App_TS_Rd64(): the extension is
+* right as long as a read happens at least once per wrap, which the kernel tick hook guarantees (one compare per
+* tick). The previous tick hook, if any, is still called.
+*
+* The conversion factors are rounded to the nearest step of 2^-24 ns and 2^-32 us per count: the relative error
+* is below 1e-8 at 120 MHz, far under the crystal tolerance.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <lib_def.h>
+
+#include  "app_intdis.h"
+#include  "app_ts.h"
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+CPU_INT32U  App_TS_Freq;
+CPU_INT64U  App_TS_nS_Q24;
+CPU_INT64U  App_TS_uS_Q32;
+CPU_INT32U  App_TS_Hi;
+CPU_INT32U  App_TS_Last;
+
+volatile  CPU_INT32U  App_TS_BenchSink;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_APP_HOOK_VOID  App_TS_TickHookPrev;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  App_TS_TickHook (void);
+
+
+/*
+*********************************************************************************************************
+*                                           App_TS_Init()
+*
+* Description : Starts the cycle counter if needed, computes the conversion factors and installs the tick hook
+*               that keeps the 64-bit extension right. Call after CPU_Init() and OSInit(); later calls do nothing,
+*               so every module that uses the service can call it.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_TS_Init (void)
+{
+    CPU_INT32U  freq;
+    CPU_SR_ALLOC();
+
+
+    if (App_TS_Freq != 0u) {
+        return;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;             /* Already done by uC/CPU with CPU_TS_TMR_EN            */
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    freq          = SystemCoreClock;
+    App_TS_nS_Q24 = ((1000000000ull << 24u) + (freq / 2u)) / freq;
+    App_TS_uS_Q32 = ((1000000ull    << 32u) + (freq / 2u)) / freq;
+    App_TS_Last   = DWT->CYCCNT;
+    App_TS_Freq   = freq;
+
+    APP_CRITICAL_ENTER();
+    App_TS_TickHookPrev   = OS_AppTimeTickHookPtr;
+    OS_AppTimeTickHookPtr = App_TS_TickHook;
+    APP_CRITICAL_EXIT();
+}
+
+
+/*
+*********************************************************************************************************
+*                                           App_TS_Bench()
+*
+* Description : Measures and prints the cost of each timestamp read and conversion, in CPU cycles per call,
+*               net of the benchmark loop.
+*
+* Argument(s) : none.
+*
+* Return(s)   : none.
+*
+* Note(s)     : (1) The float conversion is the one the sonar apps used: a frequency query and a double
+*                   division per measurement.
+*********************************************************************************************************
+*/
+
+void  App_TS_Bench (void)
+{
+    CPU_ERR     cpu_err;
+    CPU_INT32U  base10;
+    CPU_INT32U  cyc10;
+    char        tmp[80];
+
+
+    App_TS_Init();
+
+    APP_TS_BENCH(App_TS_BenchSink += 1u, base10);               /* Loop and sink update alone                           */
+
+    sprintf(tmp, "Timestamp read cost (CPU cycles per call, %u MHz):\n\r", (unsigned)(App_TS_Freq / 1000000u));
+    APP_TRACE_DBG(( tmp ));
+
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)App_TS_Rd32(), cyc10);
+    App_TS_BenchPrint("App_TS_Rd32()",       cyc10, base10);
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)App_TS_Rd64(), cyc10);
+    App_TS_BenchPrint("App_TS_Rd64()",       cyc10, base10);
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)CPU_TS_TmrRd(), cyc10);
+    App_TS_BenchPrint("CPU_TS_TmrRd()",      cyc10, base10);
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)CPU_TS_Get32(), cyc10);
+    App_TS_BenchPrint("CPU_TS_Get32()",      cyc10, base10);
+#if (CPU_CFG_TS_64_EN == DEF_ENABLED)
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)CPU_TS_Get64(), cyc10);
+    App_TS_BenchPrint("CPU_TS_Get64()",      cyc10, base10);
+#endif
+
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)App_TS_to_nS(App_TS_BenchSink), cyc10);
+    App_TS_BenchPrint("App_TS_to_nS()",      cyc10, base10);
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)App_TS_to_uS(App_TS_BenchSink), cyc10);
+    App_TS_BenchPrint("App_TS_to_uS()",      cyc10, base10);
+    APP_TS_BENCH(App_TS_BenchSink += (CPU_INT32U)((1000000.0 * App_TS_BenchSink) / CPU_TS_TmrFreqGet(&cpu_err)), cyc10);
+    App_TS_BenchPrint("float us (Note #1)",  cyc10, base10);
+}
+
+
+/*
+*********************************************************************************************************
+*                                         App_TS_BenchPrint()
+*
+* Description : Prints one APP_TS_BENCH() result, net of the loop.
+*
+* Argument(s) : p_name      name of the benchmarked operation.
+*               cyc10       APP_TS_BENCH() result, in tenths of a cycle.
+*               base10      APP_TS_BENCH() result of the loop without the operation.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+void  App_TS_BenchPrint (const  CPU_CHAR  *p_name,
+                         CPU_INT32U        cyc10,
+                         CPU_INT32U        base10)
+{
+    char  tmp[64];
+
+
+    cyc10 = (cyc10 > base10) ? (cyc10 - base10) : 0u;
+    sprintf(tmp, "  %-20s %4u.%u\n\r", p_name, (unsigned)(cyc10 / 10u), (unsigned)(cyc10 % 10u));
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         LOCAL FUNCTIONS
+*********************************************************************************************************
+*/
+
+static  void  App_TS_TickHook (void)
+{
+    (void)App_TS_Rd64();
+    if (App_TS_TickHookPrev != (OS_APP_HOOK_VOID)0) {
+        App_TS_TickHookPrev();
+    }
+}
@@ -0,0 +1,150 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Timestamp service on the DWT cycle counter (CYCCNT, one CPU clock): inline reads with no function call, a
+* 64-bit timestamp extended in software, and conversions to ns/us by a fixed-point factor computed once by
+* App_TS_Init() instead of a frequency query and a division per measurement. Does not need CPU_CFG_TS_64_EN.
+*
+* App_TS_Rd32() is a single load, for intervals up to one wrap (35 s at 120 MHz). App_TS_Rd64() extends it
+* with every interrupt masked for a few cycles, safe from any context including fast ISRs. App_TS_Bench()
+* prints the cost of each read against the uC/CPU ones.
+*********************************************************************************************************
+*/
+
+#ifndef  APP_TS_H
+#define  APP_TS_H
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+
+#include  <cpu.h>
+#include  <app_cfg.h>
+#include  <lib_def.h>
+
+#include  <system_MK64F12.h>
+
+
+/*
+*********************************************************************************************************
+*                                          GLOBAL VARIABLES
+*
+* Note(s) : (1) Written by App_TS_Init() and App_TS_Rd64() only; exported for the inline functions below.
+*********************************************************************************************************
+*/
+
+extern  CPU_INT32U  App_TS_Freq;                                /* Counts per second.                                   */
+extern  CPU_INT64U  App_TS_nS_Q24;                              /* ns per count, 24 fractional bits.                    */
+extern  CPU_INT64U  App_TS_uS_Q32;                              /* us per count, 32 fractional bits.                    */
+extern  CPU_INT32U  App_TS_Hi;                                  /* Wraps of CYCCNT seen so far.                         */
+extern  CPU_INT32U  App_TS_Last;                                /* CYCCNT at the previous App_TS_Rd64().                */
+
+extern  volatile  CPU_INT32U  App_TS_BenchSink;                 /* Benchmarked reads are added here, see APP_TS_BENCH() */
+
+
+/*
+*********************************************************************************************************
+*                                             BENCHMARK
+*
+* Note(s) : (1) APP_TS_BENCH() runs 'stmt' APP_TS_BENCH_CALLS times in a row, APP_TS_BENCH_RUNS times, and
+*               stores in 'cyc10' the fastest run in tenths of a cycle per call: that run was not interrupted.
+*               App_TS_BenchPrint() subtracts the result of the same loop without the operation.
+*********************************************************************************************************
+*/
+
+#define  APP_TS_BENCH_CALLS                      100u
+#define  APP_TS_BENCH_RUNS                         8u
+
+#define  APP_TS_BENCH(stmt, cyc10)                                                              \
+    do {                                                                                        \
+        CPU_INT32U  run_;                                                                       \
+        CPU_INT32U  i_;                                                                         \
+        CPU_INT32U  t0_;                                                                        \
+        CPU_INT32U  dt_;                                                                        \
+                                                                                                \
+        (cyc10) = DEF_INT_32U_MAX_VAL;                                                          \
+        for (run_ = 0u; run_ < APP_TS_BENCH_RUNS; run_++) {                                     \
+            t0_ = App_TS_Rd32();                                                                \
+            for (i_ = 0u; i_ < APP_TS_BENCH_CALLS; i_++) {                                      \
+                stmt;                                                                           \
+            }                                                                                   \
+            dt_ = App_TS_Rd32() - t0_;                                                          \
+            if (dt_ < (cyc10)) {                                                                \
+                (cyc10) = dt_;                                                                  \
+            }                                                                                   \
+        }                                                                                       \
+        (cyc10) = ((cyc10) * 10u) / APP_TS_BENCH_CALLS;                                         \
+    } while (0)
+
+
+/*
+*********************************************************************************************************
+*                                          FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+void  App_TS_Init       (void);
+
+void  App_TS_Bench      (void);
+
+void  App_TS_BenchPrint (const  CPU_CHAR  *p_name,
+                         CPU_INT32U        cyc10,
+                         CPU_INT32U        base10);
+
+
+/*
+*********************************************************************************************************
+*                                          INLINE FUNCTIONS
+*********************************************************************************************************
+*/
+
+__STATIC_INLINE  CPU_INT32U  App_TS_Rd32 (void)
+{
+    return (DWT->CYCCNT);
+}
+
+
+__STATIC_INLINE  CPU_INT64U  App_TS_Rd64 (void)                 /* Must run at least once per wrap, see App_TS_Init()   */
+{
+    CPU_INT32U  primask;
+    CPU_INT32U  lo;
+    CPU_INT64U  ts;
+
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    lo = DWT->CYCCNT;
+    if (lo < App_TS_Last) {
+        App_TS_Hi++;
+    }
+    App_TS_Last = lo;
+    ts = ((CPU_INT64U)App_TS_Hi << 32u) | lo;
+    __set_PRIMASK(primask);
+
+    return (ts);
+}
+
+
+__STATIC_INLINE  CPU_INT64U  App_TS_to_nS (CPU_INT64U  cnts)
+{
+    return (((cnts >> 32u) * (App_TS_nS_Q24 << 8u))
+          + (((cnts & 0xFFFFFFFFu) * App_TS_nS_Q24) >> 24u));
+}
+
+
+__STATIC_INLINE  CPU_INT64U  App_TS_to_uS (CPU_INT64U  cnts)
+{
+    return (((cnts >> 32u) * App_TS_uS_Q32)
+          + (((cnts & 0xFFFFFFFFu) * App_TS_uS_Q32) >> 32u));
+}
+
+#endif
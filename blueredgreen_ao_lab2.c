@@ -0,0 +1,317 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+*
+* Same behaviour as blueredgreen_sem_lab2.c (blue led blinks at 2.5Hz, red at 0.5Hz, green at 1Hz, colors
+* never overlap) with active objects instead of tasks, see app_ao.h: one object per led and an arbiter object
+* in place of the semaphore, all run by the AO task on its single stack
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+*
+* A blinker requests the leds (REQ), waits for the GRANT, blinks once with its own time event and gives the
+* leds back (RELEASE) before requesting them again. The arbiter grants in request order, like the semaphore
+* of the original, whose three tasks had the same priority.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include  "app_ao.h"
+#include  "app_ledmeter.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_REPORT_PERIOD_S                      10u
+
+#define  APP_SIG_REQ                       (APP_AO_SIG_USER + 0u)   /* To the arbiter, par = blinker index        */
+#define  APP_SIG_RELEASE                   (APP_AO_SIG_USER + 1u)   /* To the arbiter                             */
+#define  APP_SIG_GRANT                     (APP_AO_SIG_USER + 2u)   /* To a blinker                               */
+#define  APP_SIG_TIMEOUT                   (APP_AO_SIG_USER + 3u)   /* To a blinker, from its time event          */
+
+#define  APP_BLINKER_NBR                           3u
+#define  APP_BLINKER_Q_SIZE                        4u
+#define  APP_ARBITER_Q_SIZE                        8u
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_blinker {
+    APP_AO       AO;                                            /* First member: handlers cast APP_AO * back            */
+    CPU_INT32U   Idx;
+    CPU_INT32U   Pin;
+    CPU_INT32U   HalfPeriod_ms;
+    CPU_INT08U   ToggleCtr;
+    APP_AO_TMR   Tmr;
+    APP_AO_EVT   Q[APP_BLINKER_Q_SIZE];
+} APP_BLINKER;
+
+typedef  struct  app_arbiter {
+    APP_AO       AO;
+    CPU_BOOLEAN  Busy;
+    CPU_INT08U   WaitQ[APP_BLINKER_NBR];                        /* Blinkers waiting for the leds, in request order      */
+    CPU_INT08U   WaitIn;
+    CPU_INT08U   WaitNbr;
+    APP_AO_EVT   Q[APP_ARBITER_Q_SIZE];
+} APP_ARBITER;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  APP_BLINKER  Blinker[APP_BLINKER_NBR];
+static  APP_ARBITER  Arbiter;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart       (void  *p_arg);
+
+static  void  Blinker_Init       (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt);
+static  void  Blinker_Waiting    (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt);
+static  void  Blinker_Blinking   (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt);
+
+static  void  Arbiter_Run        (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt);
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    hardware_init();
+    GPIO_DRV_Init(NULL, ledPins);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    static  const  CPU_INT32U   pin[APP_BLINKER_NBR]   = { BOARD_GPIO_LED_BLUE, BOARD_GPIO_LED_RED, BOARD_GPIO_LED_GREEN };
+    static  const  CPU_INT32U   half[APP_BLINKER_NBR]  = { 200u,                1000u,              500u                 };
+    static  CPU_CHAR    *const  name[APP_BLINKER_NBR]  = { "blue",              "red",              "green"              };
+    OS_ERR      os_err;
+    CPU_INT08U  i;
+
+    (void)p_arg;
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+    BSP_Ser_Init(115200u);
+
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_BLUE,  "blue");          /* Measure the achieved blink rates, see app_ledmeter.h */
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_RED,   "red");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_GREEN, "green");
+    App_LedMeter_Start(10u);
+
+    App_AO_Create(&Arbiter.AO,                                  /* Above the blinkers: a release is handled first       */
+                  "leds",
+                   APP_BLINKER_NBR,
+                   Arbiter_Run,
+                  &Arbiter.Q[0u],
+                   APP_ARBITER_Q_SIZE);
+
+    for (i = 0u; i < APP_BLINKER_NBR; i++) {                    /* Created in the original request order                */
+        Blinker[i].Idx           = i;
+        Blinker[i].Pin           = pin[i];
+        Blinker[i].HalfPeriod_ms = half[i];
+        App_AO_Create(&Blinker[i].AO,
+                       name[i],
+                       APP_BLINKER_NBR - 1u - i,
+                       Blinker_Init,
+                      &Blinker[i].Q[0u],
+                       APP_BLINKER_Q_SIZE);
+    }
+
+    App_AO_Start(APP_REPORT_PERIOD_S);                          /* Dispatch latency and RAM report, see app_ao.h        */
+
+    OSTaskDel((OS_TCB *)0, &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           BLINKER STATES
+*********************************************************************************************************
+*/
+
+static  void  Blinker_Init (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt)
+{
+    APP_BLINKER  *p_blinker = (APP_BLINKER *)p_ao;
+
+
+    if (p_evt->Sig == APP_AO_SIG_INIT) {
+        App_AO_Tran(p_ao, Blinker_Waiting);
+        (void)App_AO_Post(&Arbiter.AO, APP_SIG_REQ, p_blinker->Idx);
+    }
+}
+
+
+static  void  Blinker_Waiting (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt)
+{
+    if (p_evt->Sig == APP_SIG_GRANT) {
+        App_AO_Tran(p_ao, Blinker_Blinking);
+    }
+}
+
+
+static  void  Blinker_Blinking (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt)
+{
+    APP_BLINKER  *p_blinker = (APP_BLINKER *)p_ao;
+
+
+    switch (p_evt->Sig) {
+        case APP_AO_SIG_ENTRY:                                  /* On for a half period ...                             */
+             APP_LED_TOGGLE(p_blinker->Pin);
+             p_blinker->ToggleCtr = 1u;
+             App_AO_TmrArm(&p_blinker->Tmr, p_ao, APP_SIG_TIMEOUT,
+                            APP_AO_MS_TO_TICKS(p_blinker->HalfPeriod_ms), 0u);
+             break;
+
+        case APP_SIG_TIMEOUT:
+             if (p_blinker->ToggleCtr < 2u) {                   /* ... off for a half period ...                        */
+                 APP_LED_TOGGLE(p_blinker->Pin);
+                 p_blinker->ToggleCtr++;
+                 App_AO_TmrArm(&p_blinker->Tmr, p_ao, APP_SIG_TIMEOUT,
+                                APP_AO_MS_TO_TICKS(p_blinker->HalfPeriod_ms), 0u);
+             } else {                                           /* ... then the next color                              */
+                 (void)App_AO_Post(&Arbiter.AO, APP_SIG_RELEASE, p_blinker->Idx);
+                 (void)App_AO_Post(&Arbiter.AO, APP_SIG_REQ,     p_blinker->Idx);
+                 App_AO_Tran(p_ao, Blinker_Waiting);
+             }
+             break;
+
+        default:
+             break;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                            ARBITER STATE
+*********************************************************************************************************
+*/
+
+static  void  Arbiter_Run (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt)
+{
+    APP_ARBITER  *p_arb = (APP_ARBITER *)p_ao;
+    CPU_INT08U    out;
+
+
+    switch (p_evt->Sig) {
+        case APP_SIG_REQ:
+             if (p_arb->Busy == DEF_NO) {
+                 p_arb->Busy = DEF_YES;
+                 (void)App_AO_Post(&Blinker[p_evt->Par].AO, APP_SIG_GRANT, 0u);
+             } else {                                           /* At most one request per blinker: never full          */
+                 p_arb->WaitQ[p_arb->WaitIn] = (CPU_INT08U)p_evt->Par;
+                 p_arb->WaitIn               = (CPU_INT08U)((p_arb->WaitIn + 1u) % APP_BLINKER_NBR);
+                 p_arb->WaitNbr++;
+             }
+             break;
+
+        case APP_SIG_RELEASE:
+             if (p_arb->WaitNbr == 0u) {
+                 p_arb->Busy = DEF_NO;
+             } else {
+                 out = (CPU_INT08U)((p_arb->WaitIn + APP_BLINKER_NBR - p_arb->WaitNbr) % APP_BLINKER_NBR);
+                 p_arb->WaitNbr--;
+                 (void)App_AO_Post(&Blinker[p_arb->WaitQ[out]].AO, APP_SIG_GRANT, 0u);
+             }
+             break;
+
+        default:                                                /* INIT: leds free                                      */
+             break;
+    }
+}
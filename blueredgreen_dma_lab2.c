@@ -0,0 +1,227 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+* Blink blue led at 5Hz, red led at 2Hz and green led at 1Hz
+* Colors must not overlap (solution plays a time-slotted schedule by DMA, see app_tdma.c and app_ledwave.c)
+* Needs app_tdma.c, app_ledwave.c and app_lowpwr.c, and app_ramfunc.c and app_ts.c (SRAM copy, app_ramfunc.h)
+* Needs app_intdis.c when CPU_CFG_INT_DIS_MEAS_EN is defined (app_intdis.h)
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+*
+* Same schedule as blueredgreen_tdma_lab2.c: the on-slots of each colour are computed once over the
+* hyperperiod (1 s) so that they never overlap. Instead of an executor task, the slot table is compiled into
+* PSOR/PCOR words and written to the LED ports by the DMA, paced by FTM2: once started, the blink takes no CPU
+* time at all. Every APP_SWAP_PERIOD_S seconds the start task hands over the other schedule (every period
+* doubled), at the end of the hyperperiod in progress, and prints the CPU usage.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <stdio.h>
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include  "app_ledwave.h"
+#include  "app_ramfunc.h"
+#include  "app_tdma.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SLOT_MS                              20u           /* TDMA slot length                                     */
+#define  APP_SWAP_PERIOD_S                        10u
+#define  APP_LED_NBR                               3u
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  APP_TDMA     LedSched[2];                               /* Nominal and slow schedules                           */
+
+                                                                /* On-times are 20%, 12% and 10% of the period so that  */
+                                                                /* the three colours fit in the 1 s hyperperiod.        */
+static  const  APP_TDMA_CH_CFG  LedCfg[APP_LED_NBR] = {
+    /* name     pin                    period  on */
+    { "blue",  BOARD_GPIO_LED_BLUE,    200u,  40u },            /* 5Hz                                                  */
+    { "red",   BOARD_GPIO_LED_RED,     500u,  60u },            /* 2Hz                                                  */
+    { "green", BOARD_GPIO_LED_GREEN,  1000u, 100u },            /* 1Hz                                                  */
+};
+
+static  const  APP_TDMA_CH_CFG  LedCfgSlow[APP_LED_NBR] = {
+    /* name     pin                    period  on */
+    { "blue",  BOARD_GPIO_LED_BLUE,    400u,  80u },            /* 2.5Hz                                                */
+    { "red",   BOARD_GPIO_LED_RED,    1000u, 120u },            /* 1Hz                                                  */
+    { "green", BOARD_GPIO_LED_GREEN,  2000u, 200u },            /* 0.5Hz                                                */
+};
+
+static  const  CPU_INT32U  LedPin[APP_LED_NBR] = {              /* Bit n of the slot masks: LedCfg[n]                   */
+    BOARD_GPIO_LED_BLUE,
+    BOARD_GPIO_LED_RED,
+    BOARD_GPIO_LED_GREEN,
+};
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         AppTaskStart (void  *p_arg);
+static  CPU_BOOLEAN  AppLedPlay (APP_TDMA  *p_sched, CPU_BOOLEAN  at_once);   // hands a schedule over to the DMA
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+    GPIO_DRV_Init(NULL, ledPins);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR      os_err;
+    CPU_INT08U  cur;
+    char        tmp[80];
+
+    (void)p_arg;
+
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+#if (OS_CFG_STAT_TASK_EN > 0u)
+    OSStatTaskCPUUsageInit(&os_err);                            /* Measure the idle CPU before the blink starts         */
+#endif
+
+    BSP_Ser_Init(115200u);
+
+    App_TDMA_Init(&LedSched[0], LedCfg,     APP_LED_NBR, APP_SLOT_MS);   /* Compute the on-slots of each colour     */
+    App_TDMA_Init(&LedSched[1], LedCfgSlow, APP_LED_NBR, APP_SLOT_MS);
+
+    if (App_LedWave_Init(APP_SLOT_MS) != DEF_TRUE) {
+        APP_TRACE_DBG(( "Slot too long for FTM2.\n\r" ));
+    }
+    cur = 0u;
+    (void)AppLedPlay(&LedSched[cur], DEF_YES);
+
+    while (DEF_TRUE) {                                          /* The start task becomes the swap and report task.     */
+        OSTimeDlyHMSM(0u, 0u, APP_SWAP_PERIOD_S, 0u,
+                      OS_OPT_TIME_HMSM_STRICT,
+                      &os_err);
+#if (OS_CFG_STAT_TASK_EN > 0u)
+        sprintf(tmp, "CPU usage %u.%02u%%\n\r",
+                (unsigned)(OSStatTaskCPUUsage / 100u),
+                (unsigned)(OSStatTaskCPUUsage % 100u));
+        APP_TRACE_DBG(( tmp ));
+#endif
+        cur = 1u - cur;
+        while (AppLedPlay(&LedSched[cur], DEF_NO) != DEF_TRUE) {    /* Previous hand-over still pending         */
+            OSTimeDlyHMSM(0u, 0u, 0u, 100u,
+                          OS_OPT_TIME_HMSM_STRICT,
+                          &os_err);
+        }
+        sprintf(tmp, "%s schedule handed over, starts with the next hyperperiod\n\r",
+                (cur == 0u) ? "Nominal" : "Slow");
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+
+static  CPU_BOOLEAN  AppLedPlay (APP_TDMA  *p_sched, CPU_BOOLEAN  at_once)
+{
+    APP_LEDWAVE_PAT  pat;
+
+
+    pat.PinTbl  = &LedPin[0];
+    pat.PinNbr  =  APP_LED_NBR;
+    pat.MaskTbl = &p_sched->SlotMask[0];                        /* Bit n set: LedCfg[n] on during the slot              */
+    pat.SlotNbr =  p_sched->SlotNbr;
+
+    return (App_LedWave_Play(&pat, at_once));
+}
@@ -33,6 +33,8 @@
 
 #include  <bsp_ser.h>
 
+#include  "app_ledmeter.h"
+
 
 /*
 *********************************************************************************************************
@@ -133,6 +135,11 @@ static  void  AppTaskStart (void *p_arg)
 
     BSP_Ser_Init(115200u);
 
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_BLUE,  "blue");          /* Measure the achieved blink rates, see app_ledmeter.h */
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_RED,   "red");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_GREEN, "green");
+    App_LedMeter_Start(10u);
+
     OSTaskCreate(&TaskRedTCB,                              /* Create the red task                                */
                  "App Task Red",
                   AppTaskRed,
@@ -170,11 +177,11 @@ static  void  AppTaskStart (void *p_arg)
                     (CPU_TS   *)&ts,
                     (OS_ERR   *)&os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_BLUE);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_BLUE);
         OSTimeDlyHMSM(0u, 0u, 0u, 200u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-        GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_BLUE);
+        APP_LED_TOGGLE(BOARD_GPIO_LED_BLUE);
         OSTimeDlyHMSM(0u, 0u, 0u, 200u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
@@ -202,11 +209,11 @@ static  void  AppTaskRed (void *p_arg)
                     (CPU_TS   *)&ts,
                     (OS_ERR   *)&os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_RED);
         OSTimeDlyHMSM(0u, 0u, 1u, 0u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-         GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+         APP_LED_TOGGLE(BOARD_GPIO_LED_RED);
         OSTimeDlyHMSM(0u, 0u, 1u, 0u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
@@ -237,11 +244,11 @@ static  void  AppTaskGreen (void *p_arg)
                     (CPU_TS   *)&ts,
                     (OS_ERR   *)&os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_GREEN);
         OSTimeDlyHMSM(0u, 0u, 0u, 500u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-          GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+          APP_LED_TOGGLE(BOARD_GPIO_LED_GREEN);
         OSTimeDlyHMSM(0u, 0u, 0u, 500u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
@@ -35,6 +35,8 @@
 
 #include  <bsp_ser.h>
 
+#include  "app_ledmeter.h"
+
 /*
 *********************************************************************************************************
 *                                       LOCAL GLOBAL VARIABLES
@@ -132,6 +134,11 @@ static  void  AppTaskStart (void *p_arg)
 
     BSP_Ser_Init(115200u);
 
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_BLUE,  "blue");          /* Measure the achieved blink rates, see app_ledmeter.h */
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_RED,   "red");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_GREEN, "green");
+    App_LedMeter_Start(10u);
+
     OSTaskCreate(&TaskRedTCB,                              /* Create the red task                                */
                  "App Task Red",
                   AppTaskRed,
@@ -169,11 +176,11 @@ static  void  AppTaskStart (void *p_arg)
                         &ts,
                         &os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_BLUE);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_BLUE);
         OSTimeDlyHMSM(0u, 0u, 0u, 200u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-        GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_BLUE);
+        APP_LED_TOGGLE(BOARD_GPIO_LED_BLUE);
         OSTimeDlyHMSM(0u, 0u, 0u, 200u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
@@ -201,11 +208,11 @@ static  void  AppTaskRed (void *p_arg)
                         &ts,
                         &os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_RED);
         OSTimeDlyHMSM(0u, 0u, 1u, 0u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-         GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+         APP_LED_TOGGLE(BOARD_GPIO_LED_RED);
         OSTimeDlyHMSM(0u, 0u, 1u, 0u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
@@ -236,11 +243,11 @@ static  void  AppTaskGreen (void *p_arg)
                         &ts,
                         &os_err);
 
-       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+       APP_LED_TOGGLE(BOARD_GPIO_LED_GREEN);
         OSTimeDlyHMSM(0u, 0u, 0u, 500u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
-          GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+          APP_LED_TOGGLE(BOARD_GPIO_LED_GREEN);
         OSTimeDlyHMSM(0u, 0u, 0u, 500u,
                       OS_OPT_TIME_HMSM_STRICT,
                       &os_err);
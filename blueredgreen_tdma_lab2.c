@@ -0,0 +1,220 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+* Blink blue led at 5Hz, red led at 2Hz and green led at 1Hz
+* Colors must not overlap (solution makes use of a time-slotted schedule, see app_tdma.c)
+* Needs app_tdma.c and app_rms.c, and app_ledmeter.c when APP_CFG_LED_METER_EN is enabled (app_ledmeter.h)
+* Needs app_intdis.c when CPU_CFG_INT_DIS_MEAS_EN is defined (app_intdis.h)
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+*
+* The OS_SEM/OS_MUTEX solutions hold the lock across a whole blink cycle, so the three colours run one after
+* the other and none of them reaches its nominal frequency. Here the on-slots of each colour are computed once
+* over the hyperperiod (1 s) so that they never overlap, and a single executor task switches the LEDs at the
+* slot boundaries. Achieved frequency and duty cycle are printed every APP_REPORT_PERIOD_S seconds.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include  "app_ledmeter.h"
+#include  "app_rms.h"
+#include  "app_tdma.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SLOT_MS                              20u           /* TDMA slot length                                     */
+#define  APP_REPORT_PERIOD_S                       5u
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_TCB       TaskLedTCB;
+static  CPU_STK      TaskLedStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_TCB       TaskReportTCB;
+static  CPU_STK      TaskReportStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  APP_TDMA     LedSched;
+
+                                                                /* On-times are 20%, 12% and 10% of the period so that  */
+                                                                /* the three colours fit in the 1 s hyperperiod.        */
+static  const  APP_TDMA_CH_CFG  LedCfg[] = {
+    /* name     pin                    period  on */
+    { "blue",  BOARD_GPIO_LED_BLUE,    200u,  40u },            /* 5Hz                                                  */
+    { "red",   BOARD_GPIO_LED_RED,     500u,  60u },            /* 2Hz                                                  */
+    { "green", BOARD_GPIO_LED_GREEN,  1000u, 100u },            /* 1Hz                                                  */
+};
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void  *p_arg);
+static  void  AppTaskLed (void  *p_arg);        // plays the LED schedule back
+static  void  AppTaskReport (void  *p_arg);     // prints achieved frequency and duty cycle
+
+
+/*
+*********************************************************************************************************
+*                                             TASK TABLE
+*********************************************************************************************************
+*/
+
+static  APP_RMS_TASK  AppTaskTbl[] = {
+    /* TCB             name               task           arg  stack              stack size                   T         D         C */
+    { &TaskLedTCB,    "App Task Led",    AppTaskLed,    0u, &TaskLedStk[0u],    APP_CFG_TASK_START_STK_SIZE, APP_SLOT_MS * 1000u, APP_SLOT_MS * 1000u,   50u, 0u, 0u },
+    { &TaskReportTCB, "App Task Report", AppTaskReport, 0u, &TaskReportStk[0u], APP_CFG_TASK_START_STK_SIZE, APP_REPORT_PERIOD_S * 1000000u, 0u, 5000u, 0u, 0u },
+};
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    hardware_init();
+    GPIO_DRV_Init(NULL, ledPins);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR    os_err;
+
+    (void)p_arg;
+
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+    BSP_Ser_Init(115200u);
+
+    App_TDMA_Init(&LedSched,                                    /* Compute the on-slots of each colour                  */
+                   LedCfg,
+                   sizeof(LedCfg) / sizeof(LedCfg[0]),
+                   APP_SLOT_MS);
+
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_BLUE,  "blue");          /* Cross-check with the LED meter, see app_ledmeter.h   */
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_RED,   "red");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_GREEN, "green");
+    App_LedMeter_Start(10u);
+
+    App_RMS_Start(AppTaskTbl,                                   /* Create the executor and report tasks                 */
+                  sizeof(AppTaskTbl) / sizeof(AppTaskTbl[0]),
+                  APP_CFG_TASK_START_PRIO + 1u,
+                 &os_err);
+
+    OSTaskDel((OS_TCB *)0, &os_err);
+}
+
+
+static  void  AppTaskLed (void *p_arg)
+{
+    (void)p_arg;
+
+    App_TDMA_Run(&LedSched);                                    /* Never returns                                        */
+}
+
+
+static  void  AppTaskReport (void *p_arg)
+{
+    OS_ERR    os_err;
+
+    (void)p_arg;
+
+    while (DEF_TRUE) {                                          /* Task body, always written as an infinite loop.       */
+        OSTimeDlyHMSM(0u, 0u, APP_REPORT_PERIOD_S, 0u,
+                      OS_OPT_TIME_HMSM_STRICT,
+                      &os_err);
+        App_TDMA_Report(&LedSched);
+    }
+}
@@ -14,6 +14,10 @@
 * Define two custom GPIO pins: 1) PORTB.23 as digital output; 2) PORTB.9 as digital input
 * A task should drive PORTB.23 with a freq. of 5Hz
 * Also: calculate the period a positive pulse is present on PORTB.9 and print it on the serial port
+* Both edges of PORTB.9 are timestamped by interrupt (app_pulsemeter.c): pulse width, period, frequency and
+* duty cycle are printed every APP_REPORT_PERIOD_S seconds with their min/max/mean
+* The same signal wired to PTC5 is also counted by LPTMR0 (app_freqcnt.c), for rates where per-edge interrupts
+* would not keep up
 *********************************************************************************************************
 */
 
@@ -39,7 +43,7 @@
   .config.isPullEnable = true,
   .config.pullSelect = kPortPullDown,
   .config.isPassiveFilterEnabled = false,
-  .config.interrupt = kPortIntEitherEdge
+  .config.interrupt = kPortIntEitherEdge                 // both edges go to app_pulsemeter.c
   },
 *
 * 2) In:  \Micrium\Examples\Freescale\KSDK\boards\frdmk64f120m\gpio_pins.h
@@ -77,6 +81,12 @@
 
 #include  <bsp_ser.h>
 
+#include  "app_freqcnt.h"
+#include  "app_irq.h"
+#include  "app_periodic.h"
+#include  "app_pulsemeter.h"
+#include  "app_ramfunc.h"
+
 
 /*
 *********************************************************************************************************
@@ -84,6 +94,7 @@
 *********************************************************************************************************
 */
 
+#define  APP_REPORT_PERIOD_S                       2u
 
 /*
 *********************************************************************************************************
@@ -117,6 +128,7 @@ int  main (void)
     CPU_ERR  cpu_err;
 #endif
 
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
     hardware_init();
 
     GPIO_DRV_Init(switchPins, ledPins);
@@ -128,6 +140,8 @@ int  main (void)
 
     OSA_Init();                                                 /* Init uC/OS-III.                                      */
 
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h                    */
+
     OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
                  "App Task Start",
                   AppTaskStart,
@@ -158,12 +172,7 @@ int  main (void)
 
 static void AppTaskStart (void *p_arg)
 {
-  OS_ERR err;
-  CPU_ERR cpu_err;
-  uint32_t value;
-  static uint32_t pulse_flag = 0;
-  CPU_TS64 before, after;
-  char tmp[80];
+  APP_PERIODIC drive_rate;
     
   (void)p_arg;
 
@@ -173,26 +182,17 @@ static void AppTaskStart (void *p_arg)
 
   BSP_Ser_Init(115200u);
 
+  App_PulseMeter_ChAdd(inPTB9, "PTB9");     // timestamps both edges in a fast PORTB ISR, see app_pulsemeter.h
+  App_PulseMeter_Start(APP_REPORT_PERIOD_S);
+  App_FreqCnt_Init(1000u, APP_REPORT_PERIOD_S);   // PTC5 edges counted by LPTMR0 over 1 s gates, see app_freqcnt.h
+
+  App_Periodic_Init(&drive_rate, 200u);   // released every 200 ms on an absolute grid, see app_periodic.c
+
     while (DEF_ON) {
         GPIO_DRV_TogglePinOutput( outPTB23 );
-        value = GPIO_DRV_ReadPinInput( inPTB9 );
-        if( value ){
-            if(pulse_flag == 0)
-                before = CPU_TS_Get64();    // in cpu_cfg.h must set: #define  CPU_CFG_TS_64_EN DEF_ENABLED
-            pulse_flag = 1;
-            GPIO_DRV_ClearPinOutput( BOARD_GPIO_LED_BLUE );
-        }
-        else{
-            GPIO_DRV_SetPinOutput( BOARD_GPIO_LED_BLUE );
-            if(pulse_flag == 1)
-            {
-                after = CPU_TS_Get64();     // see comment above
-                sprintf( tmp, "Elapsed time in Task R = %f s\n\r", (float)((1.0*(after-before))/CPU_TS_TmrFreqGet( &cpu_err )) );
-                APP_TRACE_DBG(( tmp ));
-            }
-            pulse_flag = 0;
+        if (App_Periodic_Wait(&drive_rate) == DEF_TRUE) {
+            App_Periodic_Report(&drive_rate, "PTB23 driver");
         }
-        OSTimeDlyHMSM(0u, 0u, 0u, 200u, OS_OPT_TIME_HMSM_STRICT, &err);
         
     }
 }
@@ -10,6 +10,8 @@
 *
 * Using INTERRUPTS: create a task that receives data from the HC-SR04 ultrasonic sensor and writes on the serial port
 * the distance (in cm) of objects.
+* The trigger, the echo and both switches are recorded for APP_LOGCAP_MS after start-up and the capture is streamed
+* on the serial port (app_logcap.h); tools/logcap2vcd.c turns the serial log into a VCD waveform.
 *********************************************************************************************************
 */
 /*
@@ -45,6 +47,15 @@
 
 #include  <bsp_ser.h>
 
+#include  "app_rms.h"
+#include  "app_hrtmr.h"
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_logcap.h"
+#include  "app_ramfunc.h"
+#include  "app_sonar.h"
+#include  "app_ts.h"
+
 
 /*
 *********************************************************************************************************
@@ -52,6 +63,10 @@
 *********************************************************************************************************
 */
 
+#define  APP_LOGCAP_MS                          5000u           /* Edge capture at start-up, 0 for none                 */
+#define  APP_PING_PERIOD_MS                      200u
+#define  APP_REPORT_PING_NBR                      25u           /* Driver and timer reports every 5 s                   */
+
 
 /*
 *********************************************************************************************************
@@ -64,10 +79,8 @@ static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
 static  OS_TCB       TaskPTB9TCB;
 static  CPU_STK      TaskPTB9Stk[APP_CFG_TASK_START_STK_SIZE];
 
-static  OS_SEM  Sem1;
-static  OS_SEM  Sem2;
-
-static  uint32_t  old_value = 0;                /* Stores old value of PTB9 line */
+static  OS_SEM  EchoSem;                        /* Posted by EchoPost() with each result of the sonar driver */
+static  APP_SONAR_PING  Ping;                   /* Latest result, see app_sonar.h */
 
 
 
@@ -79,7 +92,23 @@ static  uint32_t  old_value = 0;                /* Stores old value of PTB9 line
 
 static  void  AppTaskStart (void  *p_arg);
 static  void  TaskPTB9 (void  *p_arg);
-static  void  BSP_PTB9_int_hdlr( void );
+static  void  EchoPost( APP_SONAR_PING *p_ping, CPU_INT32U echo_us );
+
+
+/*
+*********************************************************************************************************
+*                                             TASK TABLE
+*
+* The sonar driver sends the triggers (app_sonar.h): TaskPTB9 is sporadic, one result per trigger. The driver
+* task is above the table (prio_base is APP_CFG_SONAR_TASK_PRIO + 1) and adds, every 200 ms, a few us of work
+* to the response time of TaskPTB9.
+*********************************************************************************************************
+*/
+
+static  APP_RMS_TASK  AppTaskTbl[] = {
+    /* TCB              name                task         arg  stack               stack size                   T        D       C */
+    { &TaskPTB9TCB,    "App Task ptb9",    TaskPTB9,    0u, &TaskPTB9Stk[0u],    APP_CFG_TASK_START_STK_SIZE, 200000u,  10000u, 1500u, 0u, 0u },
+};
 
 /*
 *********************************************************************************************************
@@ -95,6 +124,7 @@ int  main (void)
     CPU_ERR  cpu_err;
 #endif
 
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
     hardware_init();
     GPIO_DRV_Init(switchPins, ledPins);
 
@@ -106,10 +136,9 @@ int  main (void)
 
     OSA_Init();                                                 /* Init uC/OS-III.                                      */
 
-    INT_SYS_InstallHandler(PORTB_IRQn, BSP_PTB9_int_hdlr);
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h */
 
-    OSSemCreate( &Sem1, "Semaphore 1", 0, &err );
-    OSSemCreate( &Sem2, "Semaphore 2", 0, &err );
+    OSSemCreate( &EchoSem, "Echo", 0, &err );
 
 
     OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
@@ -126,20 +155,6 @@ int  main (void)
                  (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
                  &err);
 
-    OSTaskCreate(&TaskPTB9TCB,                              /* Create the start task                                */
-                 "App Task ptb9",
-                  TaskPTB9,
-                  0u,
-                  APP_CFG_TASK_START_PRIO,
-                 &TaskPTB9Stk[0u],
-                 (APP_CFG_TASK_START_STK_SIZE / 10u),
-                  APP_CFG_TASK_START_STK_SIZE,
-                  0u,
-                  0u,
-                  0u,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
-                 &err);
-
     OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
 
     while (DEF_ON) {                                            /* Should Never Get Here                                */
@@ -165,80 +180,79 @@ static  void  AppTaskStart (void *p_arg)
     CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
     Mem_Init();                                                 /* Initialize the Memory Management Module              */
     Math_Init();                                                /* Initialize the Mathematical Module                   */
+    App_TS_Init();                                              /* Cycle counter timestamps, see app_ts.h               */
+    App_HRTmr_Init();                                           /* Microsecond timers, see app_hrtmr.h                  */
+    App_Sonar_Init(outPTB23, inPTB9, DEF_YES);                  /* Trigger on PTB23, active low: level shifter. Echo on */
+                                                                /* ... PTB9, see app_sonar.h                            */
 
     BSP_Ser_Init(115200u);
 
+    App_RamFunc_Bench();                                        /* ISR entry jitter, flash vs SRAM, see app_ramfunc.h   */
 
+    App_RMS_Start(AppTaskTbl,                                   /* Create the echo task                                 */
+                  sizeof(AppTaskTbl) / sizeof(AppTaskTbl[0]),
+                  APP_CFG_SONAR_TASK_PRIO + 1u,                 /* Below the driver task, see app_sonar.h               */
+                 &err);
 
-    while (DEF_ON) {
-      /* send trigger signals to sensor */
-        GPIO_DRV_TogglePinOutput( outPTB23 );
-        OSTimeDlyHMSM(0u, 0u, 0u, 200u, OS_OPT_TIME_HMSM_STRICT, &err);
+    App_Sonar_PingInit(&Ping, EchoPost, 0, (OS_TCB *)0);
+    (void)App_Sonar_Start(&Ping, APP_PING_PERIOD_MS);           /* Continuous: the driver task triggers every 200 ms    */
 
+    App_IntDis_Reset();                                         /* Start-up sections are not of interest                */
+    App_IntDis_Init(10u);                                       /* Interrupts-disabled time, see app_intdis.h           */
+
+    if (APP_LOGCAP_MS > 0u) {
+        App_LogCap_ChAdd(inPTB9,   "echo");                     /* Tapped ahead of the echo handler                     */
+        App_LogCap_ChAdd(outPTB23, "trigger");
+        App_LogCap_ChAdd(kGpioSW1, "SW1");
+        App_LogCap_ChAdd(kGpioSW2, "SW2");
+        App_LogCap_Run(APP_LOGCAP_MS);
     }
 
+    OSTaskDel((OS_TCB *)0, &err);
 }
 
-/* gets echo signal timestamps and computes object distance */
+/* gets the echo time of each ping from the sonar driver and computes object distance */
 static void TaskPTB9 (void  *p_arg)
 {
     OS_ERR      os_err;
     CPU_TS      os_ts;
-    CPU_ERR     cpu_err;
-    CPU_TS64    before, after;
+    CPU_INT32U  echo_us;
+    CPU_INT32U  pings;
     char        tmp[80];
 
     (void)p_arg;
 
+    pings = 0u;
     while (DEF_ON) {
 
-        OSSemPend(&Sem1, 0,OS_OPT_PEND_BLOCKING,&os_ts, &os_err);
-        before = CPU_TS_Get64();
-
-        OSSemPend(&Sem2, 0,OS_OPT_PEND_BLOCKING,&os_ts, &os_err);
-
-        after = CPU_TS_Get64();
+        OSSemPend(&EchoSem, 0,OS_OPT_PEND_BLOCKING,&os_ts, &os_err);
+        echo_us = App_Sonar_Rd( &Ping );    /* both edges were timed by the driver */
 
         /* compute distance, refer to datasheet */
-        sprintf( tmp, "Distance  = %f cm \n\r", (float)(((1000000.0*(after-before))/CPU_TS_TmrFreqGet( &cpu_err ))/58) );
-        APP_TRACE_DBG(( tmp ));
+        if (echo_us == APP_SONAR_NO_ECHO) {
+            APP_TRACE_DBG(( "No echo \n\r" ));
+        } else {
+            sprintf( tmp, "Distance  = %f cm \n\r", (float)echo_us / APP_SONAR_US_PER_CM );   /* 58 us per cm */
+            APP_TRACE_DBG(( tmp ));
+        }
 
+        if (++pings == APP_REPORT_PING_NBR) {
+            App_Sonar_Report();
+            App_HRTmr_Report();
+            pings = 0u;
+        }
     }
 
 }
 
 
-/* ISR for inPTB9, which is sensitive to either edge  */
-static void BSP_PTB9_int_hdlr( void )
+/* result of a ping, in a kernel-aware ISR (see app_sonar.h): the task reads it with App_Sonar_Rd() */
+static void EchoPost( APP_SONAR_PING *p_ping, CPU_INT32U echo_us )
 {
-
-  uint32_t new_value;
   OS_ERR   os_err;
-  uint32_t ifsr;         /* interrupt flag status register */
-  uint32_t portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(inPTB9)];
-  uint32_t portPin = (1 << GPIO_EXTRACT_PIN(inPTB9));
-
-  CPU_CRITICAL_ENTER();
-  OSIntEnter();                                               /* Tell the OS that we are starting an ISR              */
-
-  ifsr = PORT_HAL_GetPortIntFlag(portBaseAddr);
-  new_value = GPIO_DRV_ReadPinInput( inPTB9 );                 /* acquire a sample of the current value */
-  if( (ifsr & portPin) )                                         /* Check if the pending interrupt is for inPTB9 */
-  {
-
-        if ( new_value != old_value && new_value == 1) {
-          old_value = new_value;
-          OSSemPost( &Sem1, OS_OPT_POST_1+OS_OPT_POST_NO_SCHED, &os_err );
-        }
-        else if ( new_value != old_value && new_value == 0) {
-            old_value = new_value;
-            OSSemPost( &Sem2, OS_OPT_POST_1+OS_OPT_POST_NO_SCHED, &os_err );
-        }
-
-      GPIO_DRV_ClearPinIntFlag( inPTB9 );
-  }
 
-  CPU_CRITICAL_EXIT();
+  (void)p_ping;
+  (void)echo_us;
 
-  OSIntExit();
+  OSSemPost( &EchoSem, OS_OPT_POST_1+OS_OPT_POST_NO_SCHED, &os_err );
 }
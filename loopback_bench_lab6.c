@@ -0,0 +1,344 @@
+/*
+*********************************************************************************************************
+*
+*
+*                                        Micrium uC/OS-III for
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+*
+* Loopback self-benchmark of the lab6 meters: same pins as custom_gpios_lab6.c, with PORTB.23 wired to
+* PORTB.9 and to PTC5
+* PORTB.23 is driven by the hardware-timed generator (app_siggen.c) over a sweep of frequencies and duty cycles;
+* at each point PORTB.9 is measured by the pulse meter (app_pulsemeter.c) and PTC5 by the frequency counter
+* (app_freqcnt.c), and their error against the generated wave is printed on the serial port:
+*   - period error in ppm and width error in ns (means), width jitter (max - min), duty cycle error
+*   - edges lost by the pulse meter
+*   - frequency counter error in Hz
+* A point passes if the period and width errors are within APP_BENCH_TOL_PPM and APP_BENCH_TOL_NS, no edge was
+* lost and the counter is within one edge per gate. The summary gives the highest frequency at which every duty
+* cycle passed: the sweep stops at the first frequency where none does, since the edge interrupts then take
+* most of the CPU
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+* Pins are configured as in custom_gpios_lab6.c (outPTB23 output, inPTB9 input with either-edge interrupts).
+* The generator uses PIT3 and DMA channel 3, the frequency counter PIT2 and LPTMR0.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+#include "fsl_gpio_common.h"
+
+#include  <stdio.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include  "app_freqcnt.h"
+#include  "app_irq.h"
+#include  "app_pulsemeter.h"
+#include  "app_ramfunc.h"
+#include  "app_siggen.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_BENCH_GATE_MS                       100u           /* Frequency counter gate                               */
+#define  APP_BENCH_DWELL_MIN_MS                  250u           /* Min measurement time per point (> 2 gates)           */
+#define  APP_BENCH_DWELL_MIN_PERIODS              10u           /* ... and at least that many periods                   */
+
+#define  APP_BENCH_TOL_PPM                      1000u           /* Max mean period error                                */
+#define  APP_BENCH_TOL_NS                        250u           /* Max mean width error                                 */
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  const  CPU_INT32U  AppBenchFreqTbl[] = {                /* Ascending, in Hz                                     */
+    10u, 100u, 1000u, 5000u, 10000u, 20000u, 50000u, 100000u, 200000u
+};
+
+static  const  CPU_INT16U  AppBenchDutyTbl[] = {                /* In 1/1000                                            */
+    100u, 250u, 500u, 750u, 900u
+};
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void         AppTaskStart  (void        *p_arg);
+
+static  void         AppBenchRun   (void);
+
+static  CPU_BOOLEAN  AppBenchPoint (CPU_INT32U   freq_Hz,
+                                    CPU_INT16U   duty_permil);
+
+static  void         AppBenchDly   (CPU_INT32U   ms);
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+
+    GPIO_DRV_Init(switchPins, ledPins);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h                    */
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static void AppTaskStart (void *p_arg)
+{
+  (void)p_arg;
+
+  CPU_Init();
+  Mem_Init();
+  Math_Init();
+
+  BSP_Ser_Init(115200u);
+
+  App_SigGen_Init(outPTB23);                // PIT3 + DMA drive PTB23, see app_siggen.h
+  App_PulseMeter_ChAdd(inPTB9, "PTB9");     // timestamps both edges in a fast PORTB ISR, see app_pulsemeter.h
+  App_PulseMeter_Start(0u);                 // no report task: read per point with App_PulseMeter_Rd()
+  App_FreqCnt_Init(APP_BENCH_GATE_MS, 0u);  // PTC5 edges counted by LPTMR0, see app_freqcnt.h
+
+    while (DEF_ON) {
+        AppBenchRun();
+        AppBenchDly(10000u);
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          AppBenchRun()
+*
+* Description : Sweeps the frequency and duty cycle tables and prints a summary.
+*********************************************************************************************************
+*/
+
+static  void  AppBenchRun (void)
+{
+    CPU_INT08U   f;
+    CPU_INT08U   d;
+    CPU_INT08U   pass_nbr;
+    CPU_INT16U   pass_tot;
+    CPU_INT16U   fail_tot;
+    CPU_INT32U   max_Hz;
+    CPU_BOOLEAN  all_pass;
+    char         tmp[96];
+
+
+    APP_TRACE_DBG(( "\n\rLoopback bench: PTB23 -> PTB9 (pulse meter), PTC5 (frequency counter)\n\r" ));
+
+    pass_tot = 0u;
+    fail_tot = 0u;
+    max_Hz   = 0u;
+    all_pass = DEF_TRUE;
+    for (f = 0u; f < sizeof(AppBenchFreqTbl) / sizeof(AppBenchFreqTbl[0]); f++) {
+        pass_nbr = 0u;
+        for (d = 0u; d < sizeof(AppBenchDutyTbl) / sizeof(AppBenchDutyTbl[0]); d++) {
+            if (AppBenchPoint(AppBenchFreqTbl[f], AppBenchDutyTbl[d]) == DEF_TRUE) {
+                pass_nbr++;
+            }
+        }
+        pass_tot += pass_nbr;
+        fail_tot += (sizeof(AppBenchDutyTbl) / sizeof(AppBenchDutyTbl[0])) - pass_nbr;
+
+        if (pass_nbr != sizeof(AppBenchDutyTbl) / sizeof(AppBenchDutyTbl[0])) {
+            all_pass = DEF_FALSE;
+        } else if (all_pass == DEF_TRUE) {                      /* Only while every lower frequency passed too          */
+            max_Hz = AppBenchFreqTbl[f];
+        }
+        if (pass_nbr == 0u) {
+            break;
+        }
+    }
+    App_SigGen_Stop();
+
+    sprintf(tmp, "Pulse meter within tolerance up to %u Hz (%u points passed, %u failed)\n\r",
+            (unsigned)max_Hz,
+            (unsigned)pass_tot,
+            (unsigned)fail_tot);
+    APP_TRACE_DBG(( tmp ));
+}
+
+
+/*
+*********************************************************************************************************
+*                                         AppBenchPoint()
+*
+* Description : Generates one frequency and duty cycle, measures it and prints the errors.
+*
+* Return(s)   : DEF_TRUE if the point is within tolerance, DEF_FALSE otherwise.
+*
+* Note(s)     : (1) The first window (edges around the restart of the generator) is read and discarded.
+*********************************************************************************************************
+*/
+
+static  CPU_BOOLEAN  AppBenchPoint (CPU_INT32U  freq_Hz,
+                                    CPU_INT16U  duty_permil)
+{
+    APP_PULSEMETER_RES  res;
+    CPU_INT32U          period_ns;
+    CPU_INT32U          high_ns;
+    CPU_INT32U          dwell_ms;
+    CPU_INT32S          period_ppm;
+    CPU_INT32S          width_ns;
+    CPU_INT32S          duty_err;
+    CPU_INT32U          duty_abs;
+    CPU_INT32S          cnt_err_Hz;
+    CPU_INT32U          cnt_Hz;
+    CPU_BOOLEAN         pass;
+    char                tmp[128];
+
+
+    if (App_SigGen_Set(freq_Hz, duty_permil, &period_ns, &high_ns) == DEF_FALSE) {
+        sprintf(tmp, "%7u Hz %3u.%u%%: out of generator range\n\r",
+                (unsigned)freq_Hz, (unsigned)(duty_permil / 10u), (unsigned)(duty_permil % 10u));
+        APP_TRACE_DBG(( tmp ));
+        return (DEF_FALSE);
+    }
+
+    dwell_ms = (APP_BENCH_DWELL_MIN_PERIODS * 1000u) / freq_Hz;
+    if (dwell_ms < APP_BENCH_DWELL_MIN_MS) {
+        dwell_ms = APP_BENCH_DWELL_MIN_MS;
+    }
+    AppBenchDly(2000u / freq_Hz + 10u);                         /* Settle for two periods, see Note #1                  */
+    (void)App_PulseMeter_Rd(inPTB9, &res);
+    AppBenchDly(dwell_ms);
+    (void)App_PulseMeter_Rd(inPTB9, &res);
+    cnt_Hz = App_FreqCnt_Get();
+
+    pass = DEF_FALSE;
+    if ((res.PulseCtr != 0u) && (res.PeriodCtr != 0u)) {
+        period_ppm = (CPU_INT32S)(((CPU_INT64S)res.PeriodMean_ns - (CPU_INT64S)period_ns) * 1000000 / (CPU_INT64S)period_ns);
+        width_ns   = (CPU_INT32S)res.WidthMean_ns - (CPU_INT32S)high_ns;
+        duty_err   = (CPU_INT32S)(((CPU_INT64U)res.WidthMean_ns * 1000u) / res.PeriodMean_ns)
+                   - (CPU_INT32S)(((CPU_INT64U)high_ns          * 1000u) / period_ns);
+        duty_abs   = (CPU_INT32U)((duty_err < 0) ? -duty_err : duty_err);
+        cnt_err_Hz = (CPU_INT32S)cnt_Hz - (CPU_INT32S)(1000000000u / period_ns);
+
+        if (((CPU_INT32U)((period_ppm < 0) ? -period_ppm : period_ppm) <= APP_BENCH_TOL_PPM) &&
+            ((CPU_INT32U)((width_ns   < 0) ? -width_ns   : width_ns)   <= APP_BENCH_TOL_NS)  &&
+            (res.LostCtr == 0u)) {
+            pass = DEF_TRUE;
+        }
+        if ((CPU_INT32U)((cnt_err_Hz < 0) ? -cnt_err_Hz : cnt_err_Hz) > (1000u / APP_BENCH_GATE_MS) + 1u) {
+            pass = DEF_FALSE;                                   /* More than one edge per gate                          */
+        }
+
+        sprintf(tmp, "%7u Hz %3u.%u%%: period %+d ppm, width %+d ns (jitter %u ns), duty %c%u.%u%%, lost %u, cnt %+d Hz %s\n\r",
+                (unsigned)freq_Hz, (unsigned)(duty_permil / 10u), (unsigned)(duty_permil % 10u),
+                (int)period_ppm,
+                (int)width_ns,
+                (unsigned)(res.WidthMax_ns - res.WidthMin_ns),
+                (duty_err < 0) ? '-' : '+', (unsigned)(duty_abs / 10u), (unsigned)(duty_abs % 10u),
+                (unsigned)res.LostCtr,
+                (int)cnt_err_Hz,
+                (pass == DEF_TRUE) ? "PASS" : "FAIL");
+    } else {
+        sprintf(tmp, "%7u Hz %3u.%u%%: %u pulses, %u periods, %u lost edges FAIL\n\r",
+                (unsigned)freq_Hz, (unsigned)(duty_permil / 10u), (unsigned)(duty_permil % 10u),
+                (unsigned)res.PulseCtr,
+                (unsigned)res.PeriodCtr,
+                (unsigned)res.LostCtr);
+    }
+    APP_TRACE_DBG(( tmp ));
+
+    return (pass);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          AppBenchDly()
+*********************************************************************************************************
+*/
+
+static  void  AppBenchDly (CPU_INT32U  ms)
+{
+    OS_ERR  os_err;
+
+
+    OSTimeDlyHMSM(0u, 0u, 0u, ms, OS_OPT_TIME_HMSM_NON_STRICT, &os_err);
+}
@@ -12,9 +12,10 @@
 *
 * Using POLLING: create a task that receives data from the HC-SR04 ultrasonic sensor and writes on the serial port
 * the distance (in cm) of objects.
-* NB: Polling has proven not to work on certain HC-SR04 sensors because sampling the value may be too slow
-*     with respect to the echo signal (see while loops in the task). For this reason, a solution using
-*     interrupts is to be prefered.
+* NB: Polling has proven not to work on certain HC-SR04 sensors because sampling the value through the GPIO
+*     driver was too slow with respect to the echo signal, and a missing echo hung the task. The echo is now
+*     sampled by app_pollcap.c (direct PDIR reads, cycle counter timestamps, timeouts); its sample rate and
+*     resolution are printed every APP_POLL_REPORT_NBR measurements. Interrupts remain the better solution.
 *********************************************************************************************************
 */
 
@@ -51,6 +52,10 @@
 
 #include  <bsp_ser.h>
 
+#include  "app_periodic.h"
+#include  "app_pollcap.h"
+#include  "app_ts.h"
+
 
 /*
 *********************************************************************************************************
@@ -58,6 +63,11 @@
 *********************************************************************************************************
 */
 
+#define  APP_POLL_INT_DIS                     DEF_NO            /* DEF_YES: no interrupt between samples, ticks lost    */
+#define  APP_POLL_RISE_TIMEOUT_US              10000u           /* Echo starts within 0.5 ms of the trigger             */
+#define  APP_POLL_WIDTH_TIMEOUT_US             40000u           /* 38 ms echo when nothing is in range                  */
+#define  APP_POLL_REPORT_NBR                     100u           /* Measurements between two capture reports (10 s)      */
+
 
 /*
 *********************************************************************************************************
@@ -130,12 +140,13 @@ int  main (void)
 
 static void AppTaskStart (void *p_arg)
 {
-  OS_ERR os_err;
-  CPU_ERR cpu_err;
-  CPU_TS64 before;
-  CPU_TS64 after;
+  CPU_INT32U start;
+  CPU_INT32U width;
+  CPU_INT32U meas_nbr;
+  APP_POLLCAP echo;
   char tmp[80];
   float distance;
+  APP_PERIODIC trig_rate;
 
   (void)p_arg;
 
@@ -145,22 +156,37 @@ static void AppTaskStart (void *p_arg)
 
   BSP_Ser_Init(115200u);
 
+  App_TS_Init();                          /* inline cycle counter reads, see app_ts.h */
+  App_TS_Bench();                         /* print the cost of each timestamp read once */
+
+  App_PollCap_Init(&echo, inPTB9, APP_POLL_INT_DIS);   /* PDIR address and mask resolved once, see app_pollcap.h */
+  meas_nbr = 0u;
+
+  App_Periodic_Init(&trig_rate, 100u);    /* one measurement every 100 ms, see app_periodic.c */
+
      while (DEF_ON) {
-       /* set trigger to high for at least 10 us */
-       GPIO_DRV_ClearPinOutput( outPTB23 );
-       OSTimeDlyHMSM(0u, 0u, 0u, 1u, OS_OPT_TIME_HMSM_STRICT, &os_err);
-       GPIO_DRV_SetPinOutput( outPTB23 );
-       /* start polling echo signal */
-       while((GPIO_DRV_ReadPinInput( inPTB9 )) == 0);
-       before = CPU_TS_Get64();
-       while((GPIO_DRV_ReadPinInput( inPTB9 )) == 1);
-       after = CPU_TS_Get64();
-       /* timestamps received, now compute distance and print it */
-       distance = (float)((1000000.0*(after-before))/CPU_TS_TmrFreqGet( &cpu_err ));
-       distance = distance/58;
-       sprintf( tmp, "Distance measured = %f cm\n\r", distance );
+       /* set trigger to high for at least 10 us: the sensor starts on the falling edge */
+       GPIO_DRV_ClearPinOutput( outPTB23 );     /* set PTB23 (trigger) to high, the line is inverted */
+       start = App_TS_Rd32();
+       while ((App_TS_Rd32() - start) < 12u * (App_TS_Freq / 1000000u));
+       GPIO_DRV_SetPinOutput( outPTB23 );       /* set PTB23 (trigger) to low */
+       /* poll the echo signal, both waits bounded */
+       if (App_PollCap_Pulse(&echo, APP_POLL_RISE_TIMEOUT_US, APP_POLL_WIDTH_TIMEOUT_US, &width) == DEF_TRUE) {
+           /* timestamps received, now compute distance and print it */
+           distance = (float)App_TS_to_nS(width);
+           distance = distance/58000;        /* 58 us per cm */
+           sprintf( tmp, "Distance measured = %f cm\n\r", distance );
+       } else {
+           sprintf( tmp, "No echo\n\r" );
+       }
        APP_TRACE_DBG(( tmp ));
-       /* wait for at least 60 ms between triggers */
-       OSTimeDlyHMSM(0u, 0u, 0u, 90u, OS_OPT_TIME_HMSM_STRICT, &os_err);
+       if (++meas_nbr >= APP_POLL_REPORT_NBR) {
+           App_PollCap_Report(&echo, "Echo capture");
+           meas_nbr = 0u;
+       }
+       /* wait for the next release: at least 60 ms between triggers since the echo lasts 38 ms at most */
+       if (App_Periodic_Wait(&trig_rate) == DEF_TRUE) {
+           App_Periodic_Report(&trig_rate, "Trigger");
+       }
     }
 }
@@ -0,0 +1,392 @@
+/* Robert Margelli - 224854 */
+/* Same behaviour as prox_alert_sys.c with active objects instead of MainTask and BlinkerTask, see app_ao.h:
+   the sonar object triggers the sensor and turns the echo into a range, the blinker object blinks the range.
+   Both run on the AO task stack; waits are time events instead of OSTimeDlyHMSM()/App_Periodic_Wait().
+   The blink itself is played by the DMA (app_ledwave.h): the blinker only hands a new pattern over on a range change. */
+
+/* includes */
+#include "fsl_interrupt_manager.h"
+#include "fsl_gpio_common.h"
+#include <stdint.h>
+#include <stdio.h>
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+#include  <app_cfg.h>
+#include  <os.h>
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+#include  <bsp_ser.h>
+#include  "app_ao.h"
+#include  "app_hrtmr.h"
+#include  "app_ledwave.h"
+#include  "app_lowpwr.h"
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_pin.h"
+#include  "app_portisr.h"
+#include  "app_ramfunc.h"
+
+/* macros and typedefs */
+#define lptmr_start() (LPTMR0->CSR |= (1 << 0))         /* enable timer (starts counting), sets TEN bit */
+#define disable_timer() (LPTMR0->CSR &= 0xFFFFFFFEu)    /* disable timer (), unsets TEN bit */
+#define SAMPLE_REPORT_NBR 100u                  /* print the run-mode time per sample every 100 samples (7 s) */
+#define SAMPLE_PERIOD_MS 70u                    /* must wait 60ms between triggerings, 70 ms provides a safe margin */
+#define TRIGGER_US 12u                          /* trigger pulse width: at least 10 us for the HC-SR04 */
+#define RANGE_NONE 0xFFu                        /* no range yet: the first distance is always a new range */
+#define BLINK_SLOT_MS 100u                      /* LED pattern slot: every half period is a multiple of it */
+#define BLINK_SLOT_MAX 20u                      /* longest pattern: 1 s on, 1 s off */
+typedef enum {red, blue, green} color;          /* simple enum for LED color */
+
+/* signals */
+#define SIG_TRIGGER (APP_AO_SIG_USER + 0u)      /* sonar: start of a sample (periodic time event) */
+#define SIG_ECHO (APP_AO_SIG_USER + 2u)         /* sonar: falling edge of the echo, par = LPTMR counter */
+#define SIG_RANGE (APP_AO_SIG_USER + 3u)        /* blinker: new range, par = (color << 16) | half period in ms */
+
+/* active objects */
+typedef struct {
+    APP_AO AO;                                  /* first member: handlers cast APP_AO * back */
+    APP_AO_TMR SampleTmr;
+    APP_HRTMR TriggerTmr;                       /* ends the trigger pulse, below the tick resolution (app_hrtmr.h) */
+    uint8_t range;                              /* current range, index in range_tbl */
+    uint32_t samples;                           /* samples since the last run-time report */
+    uint32_t missed;                            /* triggers without a falling edge before the next one */
+    APP_AO_EVT Q[8];
+} SONAR;
+
+typedef struct {
+    APP_AO AO;
+    uint8_t masks[BLINK_SLOT_MAX];              /* pattern being built, compiled by App_LedWave_Play() */
+    APP_AO_EVT Q[4];
+} BLINKER;
+
+/* Task resources */
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+/* Global variables */
+static SONAR Sonar;
+static BLINKER Blinker;
+static const CPU_INT32U led_pins[] = {BOARD_GPIO_LED_RED, BOARD_GPIO_LED_BLUE, BOARD_GPIO_LED_GREEN};   /* by color */
+APP_RAMDATA uint16_t counter = 0;   /* stores timer counter register (CNR) value, in SRAM_U with the ISR data */
+volatile uint8_t echo_pending = 0;  /* set at the trigger, cleared by the falling edge: the stop lock is held meanwhile */
+
+/* distance ranges, in cm: upper bound (excluded), LED color and half period (0u means keep the LED on) */
+static const struct {
+    float ub;
+    color led_color;
+    uint32_t half_period;
+} range_tbl[] = {
+    {  10.0f, red,     0u},
+    {  25.0f, red,   200u},
+    {  50.0f, red,   300u},
+    {  75.0f, red,   400u},
+    { 100.0f, red,   500u},
+    { 120.0f, blue,  100u},
+    { 140.0f, blue,  200u},
+    { 160.0f, blue,  300u},
+    { 180.0f, blue,  400u},
+    { 200.0f, blue,  500u},
+    {   1e9f, green, 1000u},
+};
+
+/* Function prototypes */
+static  void  AppTaskStart (void  *p_arg);
+static void Sonar_Run(APP_AO *p_ao, const APP_AO_EVT *p_evt);
+static void Blinker_Run(APP_AO *p_ao, const APP_AO_EVT *p_evt);
+APP_RAMFUNC static void ptb9_handler(CPU_INT32U pin, void *p_arg);   /* SRAM, see app_ramfunc.h */
+static void echo_done(void *p_arg);
+static void trigger_end(APP_HRTMR *p_tmr, void *p_arg);
+void LPTMR_init(void);
+APP_RAMFUNC uint32_t get_counter_value(void);
+void os_err_check(OS_ERR os_err);
+
+
+/* Main: initializes OS, creates the active objects and AppTaskStart */
+int  main (void)
+{
+    OS_ERR   os_err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+    GPIO_DRV_Init(switchPins, ledPins);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+    if (cpu_err != CPU_ERR_NONE)
+    {
+        APP_TRACE_DBG(( "CPU error." ));
+    }
+#endif
+    OSA_Init();                                                 /* Init uC/OS-III */
+
+    /* the sonar gets the higher priority (shorter period), as MainTask did */
+    App_AO_Create(&Sonar.AO, "sonar", 1u, Sonar_Run, &Sonar.Q[0], sizeof(Sonar.Q) / sizeof(Sonar.Q[0]));
+    App_AO_Create(&Blinker.AO, "blinker", 0u, Blinker_Run, &Blinker.Q[0], sizeof(Blinker.Q) / sizeof(Blinker.Q[0]));
+
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h */
+    App_PortISR_Set(inPTB9, ptb9_handler, 0);                   /* PTB9 edges, see app_portisr.h */
+    App_PortISR_FastSet(inPTB9);                                /* LPTMR0 started/stopped above the kernel */
+
+    BSP_Ser_Init(115200u);              /* useful for debugging purposes to output to serial  */
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task */
+                 "App Task Start",
+                 AppTaskStart,
+                 0u,
+                 APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                 APP_CFG_TASK_START_STK_SIZE,
+                 0u,
+                 0u,
+                 0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+    os_err_check(os_err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here */
+        ;
+    }
+}
+
+
+/* AppTaskStart: initializes services, modules, starts the AO task and then dies */
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR      os_err;
+    (void)p_arg;
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services. */
+    Mem_Init();                                                 /* Initialize the Memory Management Module */
+    Math_Init();                                                /* Initialize the Mathematical Module */
+
+    /* hardware inits for lptmr */
+    MCG->C2 |= 1;       /* select fast internal reference clock (irc) (4 MHz) - MCG Control 2 Register */
+    /* divide irc by 4 (get 1 MHz) - MCG Control and Status Register: FCRDIV written whole (reset value 1),
+       the write-1-to-clear flags LOCS0 and ATMF written back 0 */
+    MCG->SC = (MCG->SC & ~(MCG_SC_FCRDIV_MASK | MCG_SC_LOCS0_MASK | MCG_SC_ATMF_MASK)) | MCG_SC_FCRDIV(2u);
+    LPTMR_init();       /* initialize lptmr registers */
+
+    /* stop (VLPS) between the falling edge of the echo and the next trigger, see app_lowpwr.h
+       PTB9 is not an LLWU pin, so LLS could not see the echo: VLPS is the deepest mode used */
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 0u);
+
+    /* microsecond one-shot for the trigger pulse, see app_hrtmr.h */
+    App_HRTmr_Init();
+
+    /* LED patterns played by FTM2 and the DMA, see app_ledwave.h */
+    if (App_LedWave_Init(BLINK_SLOT_MS) != DEF_TRUE)
+    {
+        APP_TRACE_DBG(( "LED pattern slot too long.\n\r" ));
+    }
+
+    /* run both objects, the AO report is printed with the run-mode report */
+    App_AO_Start(0u);
+
+    /* worst interrupts-disabled time, printed with the run-mode report, see app_intdis.h */
+    App_IntDis_Reset();
+
+    OSTaskDel((OS_TCB *)0, &os_err);       /* delete this task */
+    os_err_check(os_err);
+
+}
+
+
+/* sonar: sends the trigger signal every 70 ms, computes the distance and tells the blinker if it is in a new range */
+static void Sonar_Run(APP_AO *p_ao, const APP_AO_EVT *p_evt)
+{
+    SONAR *p_sonar = (SONAR *)p_ao;
+    char tmp[80];           /* used for debugging */
+    float distance;                             /* stores distance value */
+    uint8_t range;
+    uint32_t run_ms;
+    CPU_SR_ALLOC();
+
+    switch (p_evt->Sig)
+    {
+        case APP_AO_SIG_INIT:
+            p_sonar->range = RANGE_NONE;
+            App_AO_TmrArm(&p_sonar->SampleTmr, p_ao, SIG_TRIGGER, APP_AO_MS_TO_TICKS(SAMPLE_PERIOD_MS), APP_AO_MS_TO_TICKS(SAMPLE_PERIOD_MS));
+            break;
+
+        case SIG_TRIGGER:
+            /* the echo is timed by LPTMR0 on the MCG internal clock: no stop mode until its falling edge */
+            APP_CRITICAL_ENTER();   /* echo_done() may run in between otherwise */
+            if (echo_pending)       /* no falling edge since the previous trigger: give the lock back */
+            {
+                p_sonar->missed++;
+                App_LowPwr_StopUnlock();
+            }
+            echo_pending = 1;
+            App_LowPwr_StopLock();
+            APP_CRITICAL_EXIT();
+
+            /* send trigger signal to ultrasonic sensor */
+            APP_PIN_CLR( outPTB23 );                         /* set PTB23 (trigger) to high */
+            (void)App_HRTmr_Start(&p_sonar->TriggerTmr, TRIGGER_US, 0u, trigger_end, 0);
+
+            /* average time spent in run mode per sample, the rest is WAIT/VLPS */
+            if (++p_sonar->samples == SAMPLE_REPORT_NBR)
+            {
+                run_ms = App_LowPwr_Report();
+                sprintf(tmp, "Run mode: %u us per sample, %u missed echoes\n\r", (unsigned)((run_ms * 1000u) / p_sonar->samples), (unsigned)p_sonar->missed);
+                APP_TRACE_DBG(( tmp ));
+                App_IntDis_Report();
+                App_AO_Report();
+                App_HRTmr_Report();
+                p_sonar->samples = 0u;
+                p_sonar->missed = 0u;
+            }
+            break;
+
+        case SIG_ECHO:
+            /* compute distance and check if in a new range */
+            distance = ((float)(1.0 * p_evt->Par)/(58));
+            for (range = 0u; range < (sizeof(range_tbl) / sizeof(range_tbl[0])) - 1u; range++)
+            {
+                if (distance < range_tbl[range].ub)
+                {
+                    break;
+                }
+            }
+            if (range != p_sonar->range)   /* new distance is in another range */
+            {
+                p_sonar->range = range;
+                (void)App_AO_Post(&Blinker.AO, SIG_RANGE, ((uint32_t)range_tbl[range].led_color << 16) | range_tbl[range].half_period);
+            }
+            /* debugging, prints distance to serial */
+            sprintf(tmp, "Measured distance = %f cm \n\r", distance);
+            APP_TRACE_DBG(( tmp ));
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/* blinker: blinks an LED with a specific color and frequency, restarted on each range change.
+   The pattern (on for the first half period, off for the second) is played by the DMA, the other LEDs stay off */
+static void Blinker_Run(APP_AO *p_ao, const APP_AO_EVT *p_evt)
+{
+    BLINKER *p_blinker = (BLINKER *)p_ao;
+    APP_LEDWAVE_PAT pat;
+    uint32_t half_slots;
+    uint16_t i;
+
+    switch (p_evt->Sig)
+    {
+        case SIG_RANGE:
+            half_slots = (p_evt->Par & 0xFFFFu) / BLINK_SLOT_MS;
+            pat.PinTbl = &led_pins[0];
+            pat.PinNbr = sizeof(led_pins) / sizeof(led_pins[0]);
+            pat.MaskTbl = &p_blinker->masks[0];
+            pat.SlotNbr = (half_slots == 0u) ? 1u : (CPU_INT16U)(2u * half_slots);   /* 0: keep the LED on */
+            for (i = 0u; i < pat.SlotNbr; i++)
+            {
+                p_blinker->masks[i] = ((half_slots == 0u) || (i < half_slots)) ? (uint8_t)(1u << (p_evt->Par >> 16)) : 0u;
+            }
+            (void)App_LedWave_Play(&pat, DEF_YES);          /* restarts at once with the LED on */
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/* PTB9 handler (either edge), called by the PORTB dispatcher with the flag already cleared.
+   PORTB is a fast port: only the timer is handled here, the rest is done by echo_done() */
+APP_RAMFUNC static void ptb9_handler(CPU_INT32U pin, void *p_arg)
+{
+    APP_RAMDATA static  uint32_t  old_level = 0;    /* stores old value of PTB9 line */
+    uint32_t new_level;
+
+    (void)pin;
+    (void)p_arg;
+
+    new_level = APP_PIN_RD( inPTB9 );              /* one load: constant register address and bit */
+    if(new_level != old_level)     /* edge on echo signal occured */
+    {
+        /* rising edge of echo signal, start counting */
+        if (new_level == 1) {
+            old_level = new_level;
+            lptmr_start();      /* start counting */
+        }
+        /* falling edge of echo signal, read counter value and stop counting*/
+        else if (new_level == 0)
+        {
+            old_level = new_level;
+            counter = get_counter_value();      /* store CNR reg value */
+            disable_timer();            /* stop the timer */
+            (void)App_IRQ_Defer(echo_done, 0);
+        }
+    }
+}
+
+/* end of the trigger pulse (PIT0 ISR, see app_hrtmr.h): the sensor starts its burst on this edge */
+static void trigger_end(APP_HRTMR *p_tmr, void *p_arg)
+{
+    (void)p_tmr;
+    (void)p_arg;
+
+    APP_PIN_SET( outPTB23 );                         /* set PTB23 (trigger) to low */
+}
+
+/* deferred end of echo (SWI, kernel-aware): stop modes allowed until the next trigger, echo to the sonar */
+static void echo_done(void *p_arg)
+{
+    CPU_SR_ALLOC();
+
+    (void)p_arg;
+
+    APP_CRITICAL_ENTER();
+    if (echo_pending)
+    {
+        echo_pending = 0;
+        App_LowPwr_StopUnlock();
+    }
+    APP_CRITICAL_EXIT();
+
+    (void)App_AO_Post(&Sonar.AO, SIG_ECHO, counter);
+}
+
+/* LPTMR initialization */
+void LPTMR_init(void)
+{
+    SIM_SCGC5 |= (1 << 0);            /* enable clock software access to LPTMR - System Clock Gating Control Register 5 */
+
+    /* reset lptmr registers */
+    LPTMR0->CSR = 0;
+    LPTMR0->PSR = 0;
+
+    LPTMR0->CSR |= (1 << 2);        /* free-running mode: CNR is reset on overflow  */
+    LPTMR0->PSR |= (1 << 2);        /* bypass LPTMR prescaler (use 1 MHz irc for LPTMR) */
+}
+
+/* returns CNR register value */
+APP_RAMFUNC uint32_t get_counter_value(void)
+{
+    LPTMR0->CNR = 1;     /* looks strange but we must write (any value) in CNR register right before reading its value */
+    uint16_t lower_half_mask = 0xFFFFu;
+    return (LPTMR0->CNR & lower_half_mask);      /* return CNR value (only lower 16 bits are used to count) */
+}
+
+
+/* simple error check */
+void os_err_check(OS_ERR os_err)
+{
+    if (os_err != OS_ERR_NONE)
+    {
+        APP_TRACE_DBG(( "OS Error." ));
+    }
+}
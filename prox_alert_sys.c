@@ -13,10 +13,21 @@
 #include  <system_MK64F12.h>
 #include  <board.h>
 #include  <bsp_ser.h>
+#include  "app_blink.h"
+#include  "app_hrtmr.h"
+#include  "app_ramfunc.h"
+#include  "app_rms.h"
+#include  "app_ledmeter.h"
+#include  "app_lowpwr.h"
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_pin.h"
+#include  "app_sonar.h"
 
 /* macros and typedefs */
-#define lptmr_start() (LPTMR0->CSR |= (1 << 0))         /* enable timer (starts counting), sets TEN bit */
-#define disable_timer() (LPTMR0->CSR &= 0xFFFFFFFEu)    /* disable timer (), unsets TEN bit */
+#define SAMPLE_PERIOD_MS 70u                    /* the HC-SR04 needs 60 ms between triggers, 70 ms provides a safe margin */
+#define SAMPLE_REPORT_NBR 100u                  /* print the run-mode time per sample every 100 samples (7 s) */
+#define BLINK_TICK_MS 100u                      /* blink engine resolution: every half period is a multiple of it */
 typedef enum {red, blue, green} color;          /* simple enum for LED color */
 
 /* Task resources */
@@ -30,17 +41,25 @@ static  CPU_STK      BlinkerStk[APP_CFG_TASK_START_STK_SIZE];
 /* Global variables */
 color led_color = red;          /* stores value of LED to turn on */
 uint32_t half_period = 0u;      /* 0u means keep the LED on */
-uint16_t counter = 0;           /* stores timer counter register (CNR) value */
+static APP_BLINK blinker;       /* one timing wheel for the three LEDs, served by BlinkerTask, see app_blink.h */
+static APP_BLINK_CH leds[3];    /* indexed by color */
+static APP_SONAR_PING ping;     /* latest result of the continuous measurement, see app_sonar.h */
 
 /* Function prototypes */
 static  void  AppTaskStart (void  *p_arg);
 static  void  MainTask (void  *p_arg);
 static void BlinkerTask (void *p_arg);
-static void ptb9_handler(void);
-void LPTMR_init(void);
-uint32_t get_counter_value(void);
+static void blink_set(color c, uint32_t half);
+static void ping_done(APP_SONAR_PING *p_ping, CPU_INT32U echo_us);
 void os_err_check(OS_ERR os_err);
 
+/* Task table, see app_rms.h: MainTask is sporadic, one run per ping result */
+static  APP_RMS_TASK  AppTaskTbl[] = {
+    /* TCB           name                                        task         arg  stack            stack size                   T        D        C */
+    { &MainTaskTCB, "MainTask: responsible for all operations", MainTask,    0u, &MainTaskStk[0u], APP_CFG_TASK_START_STK_SIZE,  70000u,  70000u, 1000u, 0u, 0u },
+    { &BlinkerTCB,  "BlinkerTask: blinks LED",                  BlinkerTask, 0u, &BlinkerStk[0u],  APP_CFG_TASK_START_STK_SIZE, 100000u, 100000u,   50u, 0u, 0u },
+};
+
 
 /* Main: initializes OS and creates AppTaskStart */
 int  main (void)
@@ -51,6 +70,9 @@ int  main (void)
     CPU_ERR  cpu_err;
 #endif
     
+    /* copy the SRAM code and data before anything uses them, see app_ramfunc.h */
+    App_RamFunc_Init();
+    
     hardware_init();
     GPIO_DRV_Init(switchPins, ledPins);
     
@@ -64,7 +86,7 @@ int  main (void)
 #endif
     OSA_Init();                                                 /* Init uC/OS-III */
     
-    INT_SYS_InstallHandler(PORTB_IRQn, ptb9_handler);           /* installs ISR for PTB9 */
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h */
     
     BSP_Ser_Init(115200u);              /* useful for debugging purposes to output to serial  */
     
@@ -91,7 +113,7 @@ int  main (void)
 }
 
 
-/* AppTaskStart: initializes services, modules, creates the main task (MainTask) and then dies */
+/* AppTaskStart: initializes services, modules, creates MainTask and BlinkerTask and then dies */
 static  void  AppTaskStart (void *p_arg)
 {
     OS_ERR      os_err;
@@ -101,42 +123,52 @@ static  void  AppTaskStart (void *p_arg)
     Mem_Init();                                                 /* Initialize the Memory Management Module */
     Math_Init();                                                /* Initialize the Mathematical Module */
     
-    /* hardware inits for lptmr */
-    MCG->C2 |= 1;       /* select fast internal reference clock (irc) (4 MHz) - MCG Control 2 Register */
-    MCG->SC |= 0x04u;   /* divide irc by 4 (get 1 MHz) -  MCG Control and Status Register */
-    LPTMR_init();       /* initialize lptmr registers */
+    /* cost of the driver vs app_pin.h accesses used by the blinker and the echo ISR, see app_pin.h */
+    App_Pin_Bench(BOARD_GPIO_LED_BLUE, inPTB9);
     
-    OSTaskCreate(&MainTaskTCB,                              /* Create the MainTask */
-                 "MainTask: responsible for all operations",
-                 MainTask,
-                 0u,
-                 APP_CFG_TASK_START_PRIO,
-                 &MainTaskStk[0u],
-                 (APP_CFG_TASK_START_STK_SIZE / 10u),
-                 APP_CFG_TASK_START_STK_SIZE,
-                 0u,
-                 0u,
-                 0u,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
-                 &os_err);
-    os_err_check(os_err);
+    /* cost of the blink engine at 3, 16 and 64 channels, see app_blink.h */
+    App_Blink_Bench();
     
+    /* the three LEDs share one blink engine, RED on until the first measurement */
+    App_Blink_Init(&blinker, BLINK_TICK_MS);
+    App_Blink_ChInit(&leds[red], BOARD_GPIO_LED_RED);
+    App_Blink_ChInit(&leds[blue], BOARD_GPIO_LED_BLUE);
+    App_Blink_ChInit(&leds[green], BOARD_GPIO_LED_GREEN);
+    blink_set(red, 0u);
     
-    OSTaskCreate(&BlinkerTCB,                              /* Create the BlinkerTask */
-                 "BlinkerTask: blinks LED",
-                 BlinkerTask,
-                 0u,
-                 APP_CFG_TASK_START_PRIO,
-                 &BlinkerStk[0u],
-                 (APP_CFG_TASK_START_STK_SIZE / 10u),
-                 APP_CFG_TASK_START_STK_SIZE,
-                 0u,
-                 0u,
-                 0u,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
-                 &os_err);
+    /* microsecond timers, the sonar driver times the trigger pulse with them, see app_hrtmr.h */
+    App_HRTmr_Init();
+    
+    /* asynchronous sonar driver: PTB23 trigger (cleared for the pulse), PTB9 echo timed on LPTMR0 */
+    App_Sonar_Init(outPTB23, inPTB9, DEF_YES);
+    
+    /* stop (VLPS) between the falling edge of the echo and the next trigger, see app_lowpwr.h
+       PTB9 is not an LLWU pin, so LLS could not see the echo: VLPS is the deepest mode used */
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 0u);
+    
+    /* measure the achieved blink rates when APP_CFG_LED_METER_EN is enabled, see app_ledmeter.h */
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_RED, "red");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_BLUE, "blue");
+    App_LedMeter_ChAdd(BOARD_GPIO_LED_GREEN, "green");
+    App_LedMeter_Start(10u);
+    
+    /* create MainTask and BlinkerTask, MainTask gets the higher priority (shorter period)
+       both below the sonar driver task, which only sends a trigger every 70 ms, see app_sonar.h */
+    if (App_RMS_Start(AppTaskTbl, sizeof(AppTaskTbl) / sizeof(AppTaskTbl[0]), APP_CFG_SONAR_TASK_PRIO + 1u, &os_err) != DEF_TRUE)
+    {
+        APP_TRACE_DBG(( "Task set is not schedulable.\n\r" ));
+    }
     os_err_check(os_err);
     
+    /* one ping every SAMPLE_PERIOD_MS, ping_done() wakes MainTask up with each result */
+    App_Sonar_PingInit(&ping, ping_done, 0, (OS_TCB *)0);
+    if (App_Sonar_Start(&ping, SAMPLE_PERIOD_MS) != DEF_TRUE)
+    {
+        APP_TRACE_DBG(( "Sonar busy.\n\r" ));
+    }
+    
+    /* worst interrupts-disabled time, printed with the run-mode report, see app_intdis.h */
+    App_IntDis_Reset();
     
     OSTaskDel((OS_TCB *)0, &os_err);       /* delete this task */
     os_err_check(os_err);
@@ -144,30 +176,37 @@ static  void  AppTaskStart (void *p_arg)
 }
 
 
-/* sends trigger signal, computes distance and wakes up BlinkerTask if distance is in a new range */
+/* handles each ping: computes distance and changes the blink if distance is in a new range */
 static  void  MainTask (void  *p_arg)
 {
-    OS_ERR      os_err;
     char tmp[80];           /* used for debugging */
-    float distance;                             /* stores distance value */
+    float distance = 0.0;                       /* stores distance value, kept when a ping gets no echo */
     uint8_t range = 0;                   /* keeps track of current range */
     /* lbs[0] and ubs[0] are used only at first run since no previous range is available for comparison*/
     float lbs[12] = {500.0, 0.0, 10.0, 25.0, 50.0, 75.0, 100.0, 120.0, 140.0, 160.0, 180.0, 200.0};
     float ubs[12] = {0.0, 10.0, 25.0, 50.0, 75.0, 100.0, 120.0, 140.0, 160.0, 180.0, 200.0, 500.0};
+    uint32_t samples = 0u;                      /* samples since the last run-time report */
+    uint32_t missed = 0u;                       /* pings without a falling edge within the time-out */
+    uint32_t run_ms;
+    CPU_INT32U echo_us;
+    OS_ERR os_err;
     
     (void)p_arg;
     
     while (DEF_ON) {
-        /* send trigger signal to ultrasonic sensor */
-        GPIO_DRV_ClearPinOutput( outPTB23 );             /* set PTB23 (trigger) to high */
-        OSTimeDlyHMSM(0u, 0u, 0u, 5u, OS_OPT_TIME_HMSM_STRICT, &os_err);
-        os_err_check(os_err);
-        GPIO_DRV_SetPinOutput( outPTB23 );               /* set PTB23 (trigger) to low */
-        OSTimeDlyHMSM(0u, 0u, 0u, 65u, OS_OPT_TIME_HMSM_STRICT, &os_err);      /* must wait 60us between triggerings, this provides a safe margin */
-        os_err_check(os_err);
+        /* the driver triggers every SAMPLE_PERIOD_MS on its own: sleep until ping_done() hands over a result */
+        (void)OSTaskSemPend(0u, OS_OPT_PEND_BLOCKING, (CPU_TS *)0, &os_err);
         
         /* compute distance and check if in a new range */
-        distance = ((float)(1.0 * counter)/(58));        /* update distance to new value */
+        echo_us = App_Sonar_Rd(&ping);
+        if (echo_us == APP_SONAR_NO_ECHO)
+        {
+            missed++;
+        }
+        else
+        {
+            distance = (float)echo_us / APP_SONAR_US_PER_CM;   /* update distance to new value */
+        }
         if(distance < lbs[range] || distance >= ubs[range])  /* new distance is in another range */
         {
             /* <if else> cascade to find distance range and call blink function with parameters related to range */
@@ -237,117 +276,64 @@ static  void  MainTask (void  *p_arg)
                 led_color = green;
                 half_period = 1000u;
             }
-            OSTimeDlyResume(&BlinkerTCB, &os_err);            /* wake up blinker */
+            blink_set(led_color, half_period);                /* takes effect at once, BlinkerTask is woken up if needed */
         }
         /* debugging, prints distance to serial */
          sprintf(tmp, "Measured distance = %f cm \n\r", distance);
          APP_TRACE_DBG(( tmp ));
          
+         /* average time spent in run mode per sample, the rest is WAIT/VLPS */
+         if (++samples == SAMPLE_REPORT_NBR)
+         {
+             run_ms = App_LowPwr_Report();
+             sprintf(tmp, "Run mode: %u us per sample, %u missed echoes\n\r", (unsigned)((run_ms * 1000u) / samples), (unsigned)missed);
+             APP_TRACE_DBG(( tmp ));
+             App_IntDis_Report();
+             App_HRTmr_Report();
+             App_Sonar_Report();
+             App_Blink_Report(&blinker);
+             samples = 0u;
+             missed = 0u;
+         }
+         
     }
 }
 
 
-/* blink an LED with a specific color and frequency */
+/* runs the blink engine of the three LEDs: wakes up only on an LED edge, never while the LED is steady */
 void BlinkerTask(void *p_arg)
 {
-    OS_ERR      os_err;
     (void)p_arg;
     
-    while (DEF_ON) {
-        if(half_period == 0u)   /* keep RED LED on */
-        {
-            GPIO_DRV_ClearPinOutput( BOARD_GPIO_LED_RED );
-        }
-        else
-        {
-            /* turn off any ON LED */
-            GPIO_DRV_SetPinOutput( BOARD_GPIO_LED_RED );
-            GPIO_DRV_SetPinOutput( BOARD_GPIO_LED_BLUE );
-            GPIO_DRV_SetPinOutput( BOARD_GPIO_LED_GREEN );
-            /* blink  */
-            if(led_color == red)
-            {
-                GPIO_DRV_ClearPinOutput(BOARD_GPIO_LED_RED);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-                GPIO_DRV_SetPinOutput(BOARD_GPIO_LED_RED);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-            }
-            else if(led_color == blue)
-            {
-                GPIO_DRV_ClearPinOutput(BOARD_GPIO_LED_BLUE);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-                GPIO_DRV_SetPinOutput(BOARD_GPIO_LED_BLUE);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-            }
-            else if (led_color == green)
-            {
-                GPIO_DRV_ClearPinOutput(BOARD_GPIO_LED_GREEN);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-                GPIO_DRV_SetPinOutput(BOARD_GPIO_LED_GREEN);
-                OSTimeDlyHMSM(0u, 0u, 0u, half_period, OS_OPT_TIME_HMSM_STRICT, &os_err);
-            }
-        }
-    }
+    App_Blink_Run(&blinker);            /* never returns */
 }
 
-
-/* ISR for PTB9 GPIO pin, which is sensitive to either edge */
-static void ptb9_handler(void)
+/* blink LED 'c' with the given half period (0u: keep it on) and turn the other two off */
+static void blink_set(color c, uint32_t half)
 {
-    static  uint32_t  old_level = 0;                /* stores old value of PTB9 line */
-    uint32_t new_level;
-    uint32_t ifsr;         /* interrupt flag status register */
-    uint32_t portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(inPTB9)];
-    uint32_t portPin = (1 << GPIO_EXTRACT_PIN(inPTB9));
+    APP_BLINK_CH_CFG cfg;
+    uint8_t i;
     
-    CPU_CRITICAL_ENTER();
-    OSIntEnter();                                               /* Tell the OS that we are starting an ISR              */
-    
-    ifsr = PORT_HAL_GetPortIntFlag(portBaseAddr);
-    new_level = GPIO_DRV_ReadPinInput( inPTB9 );                 /*  */
-    if( (ifsr & portPin) )                                         /* Check if the pending interrupt is for inPTB9 */
+    cfg.Period_ms = (half == 0u) ? BLINK_TICK_MS : (CPU_INT16U)(2u * half);
+    cfg.On_ms = (half == 0u) ? BLINK_TICK_MS : (CPU_INT16U)half;    /* on-time equal to the period: steady */
+    cfg.Pattern = 1u;
+    cfg.PatternLen = 1u;
+    for (i = 0u; i < 3u; i++)
     {
-        if(new_level != old_level)     /* edge on echo signal occured */
-        {
-            /* rising edge of echo signal, start counting */
-            if (new_level == 1) {
-                old_level = new_level;
-                lptmr_start();      /* start counting */
-            }
-            /* falling edge of echo signal, read counter value and stop counting*/
-            else if (new_level == 0)
-            {
-                old_level = new_level;
-                counter = get_counter_value();      /* store CNR reg value */
-                disable_timer();            /* stop the timer */
-            }
-        }
-        GPIO_DRV_ClearPinIntFlag( inPTB9 );
+        (void)App_Blink_ChSet(&blinker, &leds[i], (i == (uint8_t)c) ? &cfg : (APP_BLINK_CH_CFG *)0);
     }
-    
-    CPU_CRITICAL_EXIT();
-    OSIntExit();
 }
 
-/* LPTMR initialization */
-void LPTMR_init(void)
+
+/* result of a ping (SWI or PIT0 ISR, kernel-aware, see app_sonar.h): MainTask reads it with App_Sonar_Rd() */
+static void ping_done(APP_SONAR_PING *p_ping, CPU_INT32U echo_us)
 {
-    SIM_SCGC5 |= (1 << 0);            /* enable clock software access to LPTMR - System Clock Gating Control Register 5 */
+    OS_ERR os_err;
     
-    /* reset lptmr registers */
-    LPTMR0->CSR = 0;
-    LPTMR0->PSR = 0;
+    (void)p_ping;
+    (void)echo_us;
     
-    LPTMR0->CSR |= (1 << 2);        /* free-running mode: CNR is reset on overflow  */
-    LPTMR0->PSR |= (1 << 2);        /* bypass LPTMR prescaler (use 1 MHz irc for LPTMR) */
-}
-
-/* returns CNR register value */
-uint32_t get_counter_value(void)
-{
-    LPTMR0->CNR = 1;     /* looks strange but we must write (any value) in CNR register right before reading its value */
-    uint16_t lower_half_mask = 0xFFFFu;
-    return (LPTMR0->CNR & lower_half_mask);      /* return CNR value (only lower 16 bits are used to count) */
+    (void)OSTaskSemPost(&MainTaskTCB, OS_OPT_POST_NONE, &os_err);
 }
 
 
@@ -0,0 +1,421 @@
+/*
+*********************************************************************************************************
+*
+*                                        Micrium uC/OS-III and
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+* Create two tasks: 1) turns on red led while SW1 is pressed 2) turns on green led while SW2 is pressed
+* Colors must not overlap (solution makes use of either-edge switch interrupts and an ownership state machine)
+* The switch pins are set to interrupt on either edge at startup, ".config.interrupt" in "gpio_pins.c" is overridden
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+*
+* redsw_greensw_lab3.c holds the semaphore while polling the switch, so one task spins at 100% CPU and the other
+* one starves. Here each task blocks on its task queue and only runs when its switch ISR posts a press or a
+* release. The LED belongs to at most one colour at a time (LedOwner); a press while the other colour owns the
+* LED is remembered (APP_SW_STATE_WAIT) and the LED is handed over when the owner is released.
+*
+* The kernel timestamps each post, so the task measures the latency from the ISR to the LED write. Latency and
+* CPU usage are printed every APP_REPORT_PERIOD_S seconds. Contact bounce is not filtered: a bounce only
+* produces extra press/release pairs that the state machine absorbs.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <stdio.h>
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include <fsl_gpio_common.h>    // externs g_PortBaseAddr needed in ISR
+
+#include  "app_intdis.h"
+#include  "app_irq.h"
+#include  "app_portisr.h"
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_SW_Q_SIZE                             8u           /* Events queued per task (press/release/grant)         */
+#define  APP_REPORT_PERIOD_S                      10u
+
+#define  APP_SW_EVT_PRESS                          1u           /* Events, carried in the message size                  */
+#define  APP_SW_EVT_RELEASE                        2u
+#define  APP_SW_EVT_GRANT                          3u           /* The other colour released the LED to us              */
+
+#define  APP_SW_STATE_IDLE                         0u           /* Switch released                                      */
+#define  APP_SW_STATE_WAIT                         1u           /* Switch pressed, the other colour owns the LED        */
+#define  APP_SW_STATE_ON                           2u           /* Switch pressed, LED owned and on                     */
+
+#define  APP_SW_NONE                            0xFFu           /* LedOwner when no colour is on                        */
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_sw_ch {
+    OS_TCB      *TCB_Ptr;
+    CPU_CHAR    *NamePtr;
+    CPU_INT32U   Sw;                                            /* Switch pin, active low.                              */
+    CPU_INT32U   Led;                                           /* LED pin, active low.                                 */
+    CPU_INT08U   State;                                         /* APP_SW_STATE_xxx, changed inside critical sections.  */
+    CPU_INT08U   Other;                                         /* Index of the competing channel.                      */
+    CPU_INT32U   LatCtr;                                        /* ISR post to LED write latency, in CPU_TS ticks.      */
+    CPU_INT64U   LatSum;
+    CPU_TS       LatMax;
+} APP_SW_CH;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_TCB       TaskRedTCB;
+static  CPU_STK      TaskRedStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_TCB       TaskGreenTCB;
+static  CPU_STK      TaskGreenStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  APP_SW_CH    SwCh[2] = {
+    /* TCB            name     switch     LED        state              other */
+    { &TaskRedTCB,   "red",   kGpioSW1,  kGpioLED2, APP_SW_STATE_IDLE, 1u, 0u, 0u, 0u },
+    { &TaskGreenTCB, "green", kGpioSW2,  kGpioLED1, APP_SW_STATE_IDLE, 0u, 0u, 0u, 0u },
+};
+
+static  CPU_INT08U   LedOwner = APP_SW_NONE;                    /* Channel that owns the LED, changed inside critical   */
+                                                                /* sections together with the channel states.           */
+static  CPU_TS_TMR   TS_Freq;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void  *p_arg);
+static  void  AppTaskSw (void  *p_arg);         // one instance per colour, p_arg is the APP_SW_CH
+static  void  AppSwPost (APP_SW_CH  *p_ch);
+static  void  Sw_Intr_Handler (CPU_INT32U  pin, void  *p_arg);
+static  CPU_INT32U  AppTS_to_uS (CPU_INT64U  ts);
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+// app_portisr handler of both switches (SW1 on PORTC, SW2 on PORTA), p_arg is the APP_SW_CH;
+// the flag is already cleared and the task switch, if needed, happens when the dispatcher returns
+static void Sw_Intr_Handler(CPU_INT32U pin, void *p_arg)
+{
+  (void)pin;
+
+  AppSwPost((APP_SW_CH *)p_arg);
+}
+
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+    GPIO_DRV_Init(switchPins, ledPins);
+                                                                /* Interrupt on press and on release                    */
+    PORT_HAL_SetPinIntMode(g_portBaseAddr[GPIO_EXTRACT_PORT(kGpioSW1)], GPIO_EXTRACT_PIN(kGpioSW1), kPortIntEitherEdge);
+    PORT_HAL_SetPinIntMode(g_portBaseAddr[GPIO_EXTRACT_PORT(kGpioSW2)], GPIO_EXTRACT_PIN(kGpioSW2), kPortIntEitherEdge);
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    App_IRQ_Init();                                             // NVIC priority plan, see app_irq.h
+    App_PortISR_Set(kGpioSW1, Sw_Intr_Handler, &SwCh[0]);      // route the switch edges, see app_portisr.h
+    App_PortISR_Set(kGpioSW2, Sw_Intr_Handler, &SwCh[1]);
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR      os_err;
+    CPU_ERR     cpu_err;
+    CPU_INT08U  i;
+    char        tmp[128];
+
+    (void)p_arg;
+
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+#if (OS_CFG_STAT_TASK_EN > 0u)
+    OSStatTaskCPUUsageInit(&os_err);                            /* Measure the idle CPU before the app tasks run        */
+#endif
+
+    BSP_Ser_Init(115200u);
+
+    TS_Freq = CPU_TS_TmrFreqGet(&cpu_err);
+
+    OSTaskCreate(&TaskRedTCB,                                   /* Create the red task                                  */
+                 "App Task Red",
+                  AppTaskSw,
+                 &SwCh[0],
+                  APP_CFG_TASK_START_PRIO + 1u,
+                 &TaskRedStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  APP_SW_Q_SIZE,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+
+    OSTaskCreate(&TaskGreenTCB,                                 /* Create the green task                                */
+                 "App Task Green",
+                  AppTaskSw,
+                 &SwCh[1],
+                  APP_CFG_TASK_START_PRIO + 1u,
+                 &TaskGreenStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  APP_SW_Q_SIZE,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &os_err);
+
+    App_IntDis_Reset();                                         /* Start-up sections are not of interest                */
+
+    while (DEF_TRUE) {                                          /* The start task becomes the report task.              */
+        OSTimeDlyHMSM(0u, 0u, APP_REPORT_PERIOD_S, 0u,
+                      OS_OPT_TIME_HMSM_STRICT,
+                      &os_err);
+#if (OS_CFG_STAT_TASK_EN > 0u)
+        sprintf(tmp, "CPU usage %u.%02u%%\n\r",
+                (unsigned)(OSStatTaskCPUUsage / 100u),
+                (unsigned)(OSStatTaskCPUUsage % 100u));
+        APP_TRACE_DBG(( tmp ));
+#endif
+        for (i = 0u; i < 2u; i++) {
+            if (SwCh[i].LatCtr == 0u) {
+                continue;
+            }
+            sprintf(tmp, "%-5.5s: %u presses, ISR to LED latency %u us avg, %u us max\n\r",
+                    SwCh[i].NamePtr,
+                    (unsigned)SwCh[i].LatCtr,
+                    (unsigned)AppTS_to_uS(SwCh[i].LatSum / SwCh[i].LatCtr),
+                    (unsigned)AppTS_to_uS(SwCh[i].LatMax));
+            APP_TRACE_DBG(( tmp ));
+        }
+        App_IntDis_Report();                                    /* Bounds the latency above, see app_intdis.h           */
+    }
+}
+
+// Notes on pin usage:
+// GPIO_DRV_ReadPinInput(kGpioSW1) == 0 // button is pressed
+// GPIO_DRV_SetPinOutput(pinName)       // ex: kGpioLED1, setting means turning pin off
+// GPIO_DRV_ClearPinOutput(pinName)     // clearing the led means turning it on on K64F
+
+static  void  AppTaskSw (void *p_arg)
+{
+    APP_SW_CH    *p_ch = (APP_SW_CH *)p_arg;
+    APP_SW_CH    *p_other;
+    CPU_INT08U    me;
+    OS_MSG_SIZE   evt;
+    OS_ERR        os_err;
+    CPU_TS        ts;
+    CPU_TS        lat;
+    CPU_BOOLEAN   led_on;
+
+
+    me      = (p_ch == &SwCh[0]) ? 0u : 1u;
+    p_other = &SwCh[p_ch->Other];
+
+    GPIO_DRV_SetPinOutput(p_ch->Led);                           /* LED off until the first press                        */
+
+    while (DEF_TRUE) {                                          /* Task body, always written as an infinite loop.       */
+
+        (void)OSTaskQPend(0u,                                   /* Sleep until the ISR (or the other task) posts        */
+                          OS_OPT_PEND_BLOCKING,
+                         &evt,
+                         &ts,                                   /* Time of the post                                     */
+                         &os_err);
+        if (os_err != OS_ERR_NONE) {
+            continue;
+        }
+
+        led_on = DEF_FALSE;
+        OSSchedLock(&os_err);                                   /* Only the two tasks share the state: no need to mask  */
+        switch (evt) {                                          /* interrupts, the switch ISRs stay enabled             */
+            case APP_SW_EVT_PRESS:
+                 if (p_ch->State != APP_SW_STATE_IDLE) {        /* Bounce: already pressed                              */
+                     break;
+                 }
+                 if (LedOwner == APP_SW_NONE) {
+                     LedOwner    = me;
+                     p_ch->State = APP_SW_STATE_ON;
+                     GPIO_DRV_ClearPinOutput(p_ch->Led);        /* turn on LED                                          */
+                     led_on      = DEF_TRUE;
+                 } else {
+                     p_ch->State = APP_SW_STATE_WAIT;           /* Other colour on: get the LED when it is released     */
+                 }
+                 break;
+
+            case APP_SW_EVT_GRANT:
+                 if ((p_ch->State == APP_SW_STATE_WAIT) &&
+                     (LedOwner    == me)) {
+                     p_ch->State = APP_SW_STATE_ON;
+                     GPIO_DRV_ClearPinOutput(p_ch->Led);
+                 }
+                 break;
+
+            case APP_SW_EVT_RELEASE:
+                 if (p_ch->State == APP_SW_STATE_ON) {
+                     GPIO_DRV_SetPinOutput(p_ch->Led);          /* turn off LED                                         */
+                 }
+                 if (LedOwner == me) {                          /* Also true in WAIT if a grant is still queued         */
+                     LedOwner = APP_SW_NONE;
+                     if (p_other->State == APP_SW_STATE_WAIT) { /* Hand the LED over to the waiting colour              */
+                         LedOwner = p_ch->Other;
+                         OSTaskQPost(p_other->TCB_Ptr,
+                                     (void *)0,
+                                     APP_SW_EVT_GRANT,
+                                     OS_OPT_POST_FIFO,
+                                    &os_err);
+                     }
+                 }
+                 p_ch->State = APP_SW_STATE_IDLE;
+                 break;
+
+            default:
+                 break;
+        }
+        OSSchedUnlock(&os_err);
+
+        if (led_on == DEF_TRUE) {                               /* Latency of a direct press, grants are not counted    */
+            lat = OS_TS_GET() - ts;
+            p_ch->LatCtr++;
+            p_ch->LatSum += lat;
+            if (lat > p_ch->LatMax) {
+                p_ch->LatMax = lat;
+            }
+        }
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          AppSwPost()
+*
+* Description : Posts a press or a release to the task of a switch. Called from the switch ISRs with the
+*               interrupt flag already cleared, so the pin level read here is the one after the edge.
+*
+* Argument(s) : p_ch        switch channel.
+*
+* Return(s)   : none.
+*********************************************************************************************************
+*/
+
+static  void  AppSwPost (APP_SW_CH  *p_ch)
+{
+    OS_ERR       os_err;
+    OS_MSG_SIZE  evt;
+
+
+    evt = (GPIO_DRV_ReadPinInput(p_ch->Sw) == 0u) ? APP_SW_EVT_PRESS : APP_SW_EVT_RELEASE;
+
+    OSTaskQPost(p_ch->TCB_Ptr,
+                (void *)0,
+                evt,
+                OS_OPT_POST_FIFO,
+               &os_err);                                        /* OS_ERR_Q_MAX when bouncing faster than the task runs */
+}
+
+
+/*
+*********************************************************************************************************
+*                                          AppTS_to_uS()
+*
+* Description : Converts CPU timestamp ticks to microseconds.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  AppTS_to_uS (CPU_INT64U  ts)
+{
+    if (TS_Freq == 0u) {
+        return (0u);
+    }
+    return ((CPU_INT32U)((ts * 1000000u) / TS_Freq));
+}
@@ -159,9 +159,7 @@ static  void  AppTaskStart (void *p_arg)
                  (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
                  &os_err);
 
-
-    while (DEF_TRUE) {                                          /* Task body, always written as an infinite loop.       */
-    }
+    OSTaskDel((OS_TCB *)0, &os_err);                            /* Nothing left to do, do not spin                      */
 }
 
 // Notes on pin usage:
@@ -10,7 +10,7 @@
 *
 *
 * Set up an interrupt handler that turns on/off the blue led when SW1 is toggled
-* Must set ".config.interrupt = kPortIntFallingEdge" for switch definition in "gpio_pins.c"
+* SW1 is debounced by app_debounce.c, which sets it to interrupt on either edge
 *********************************************************************************************************
 */
 
@@ -36,35 +36,27 @@
 
 #include <fsl_gpio_common.h>    // externs g_PortBaseAddr needed in ISR
 
+#include  "app_debounce.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_ramfunc.h"
+
 /*
 *********************************************************************************************************
 *                                                main()
 *********************************************************************************************************
 */
 
-// handler associated to SW1 (labeled SW2 on board): turns on/off blue led
-void SW1_Intr_Handler(void)
+// called by the debounce engine once SW1 has settled on a new level: turns on/off blue led
+static void SW1_Debounced(CPU_INT32U pin, CPU_INT32U level, void *p_arg)
 {
-  static uint32_t ifsr;          // interrupt flag status register
-  uint32_t portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(kGpioSW1)];
-
-  CPU_CRITICAL_ENTER();         // enter critical section (disable interrupts)
-
-  OSIntEnter();         // notify to scheduler the beginning of an ISR ("This allows �C/OS-III to keep track of interrupt nesting")
-
-  ifsr = PORT_HAL_GetPortIntFlag(portBaseAddr);         // get intr flag reg related to port C
+  (void)pin;
+  (void)p_arg;
 
-  if( (ifsr & 0x40u) ) // check if kGpioSW1 generated the interrupt [pin 6 -> 7th flag (flags start with index 0)]
+  if( level == 0u )     // pressed
   {
       GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_BLUE);             // turn on/off led
-
-      GPIO_DRV_ClearPinIntFlag( kGpioSW1 );       // clear int flag related to SW1 to avoid recalling the handler
   }
-
-  CPU_CRITICAL_EXIT();  // renable interrupts
-
-  OSIntExit();          /* notify to scheduler the end of an ISR ("determines if a higher priority task is ready-to-run.
-                          If so, the interrupt returns to the higher priority task instead of the interrupted task.") */
 }
 
 
@@ -76,6 +68,7 @@ int  main (void)
     CPU_ERR  cpu_err;
 #endif
 printf("TEST STDOUT");
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
     hardware_init();
     GPIO_DRV_Init(switchPins, ledPins);
 
@@ -87,7 +80,11 @@ printf("TEST STDOUT");
 
     OSA_Init();                                                 /* Init uC/OS-III.                                      */
 
-    INT_SYS_InstallHandler(PORTC_IRQn, SW1_Intr_Handler);       // associate ISR with the interrupt source
+    BSP_Ser_Init(115200u);                                      /* for the residency and edge count reports             */
+    App_IRQ_Init();                                             /* NVIC priority plan, see app_irq.h                    */
+    App_Debounce_Init(10u);                                     /* settle SW1 on PIT1, see app_debounce.h               */
+    App_Debounce_ChAdd(kGpioSW1, "SW1", DEF_TRUE, SW1_Debounced, 0);
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 10u);                 /* sleep between presses, see app_lowpwr.h              */
 
     OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
 
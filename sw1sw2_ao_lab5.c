@@ -0,0 +1,204 @@
+/*
+*********************************************************************************************************
+*
+*                                         Micrium uC/OS-III on
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+*
+* Same behaviour as sw1sw2_interrupts_lab5.c (SW1 toggles the red led, SW2 the green one, leds can be on at the
+* same time) with one active object per switch instead of one task and one semaphore per switch, see app_ao.h
+* Switches are debounced by app_debounce.c (one event post per press)
+* The post to LED latency (dispatch latency of each object) and the RAM of both designs are printed by the AO
+* task every APP_REPORT_PERIOD_S seconds
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include <fsl_gpio_common.h>
+
+#include  "app_ao.h"
+#include  "app_debounce.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_ramfunc.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_REPORT_PERIOD_S                      10u
+
+#define  APP_SIG_PRESS                     (APP_AO_SIG_USER + 0u)
+
+#define  APP_SW_Q_SIZE                             4u
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  app_sw {
+    APP_AO       AO;                                            /* First member: handlers cast APP_AO * back            */
+    CPU_INT32U   LedPin;
+    APP_AO_EVT   Q[APP_SW_Q_SIZE];
+} APP_SW;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  APP_SW       SwRed;
+static  APP_SW       SwGreen;
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+static  void  AppTaskStart (void  *p_arg);
+static  void  Sw_Run (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt);
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+// called by the debounce engine (PIT1 ISR) once a switch has settled on a new level, p_arg is its object
+static void Sw_Debounced(CPU_INT32U pin, CPU_INT32U level, void *p_arg)
+{
+  if( level == 0u )     // pressed
+  {
+    (void)App_AO_Post((APP_AO *)p_arg, APP_SIG_PRESS, pin);
+  }
+}
+
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+    GPIO_DRV_Init(switchPins, ledPins);
+
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    SwRed.LedPin   = BOARD_GPIO_LED_RED;
+    SwGreen.LedPin = BOARD_GPIO_LED_GREEN;
+    App_AO_Create(&SwRed.AO,   "SW1", 1u, Sw_Run, &SwRed.Q[0u],   APP_SW_Q_SIZE);
+    App_AO_Create(&SwGreen.AO, "SW2", 0u, Sw_Run, &SwGreen.Q[0u], APP_SW_Q_SIZE);
+
+    App_IRQ_Init();                                             // NVIC priority plan, see app_irq.h
+    App_Debounce_Init(10u);                                     // settle the switches on PIT1, see app_debounce.h
+    App_Debounce_ChAdd(kGpioSW1, "SW1", DEF_TRUE, Sw_Debounced, (void *)&SwRed.AO);
+    App_Debounce_ChAdd(kGpioSW2, "SW2", DEF_TRUE, Sw_Debounced, (void *)&SwGreen.AO);
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR      os_err;
+
+    (void)p_arg;
+
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+    BSP_Ser_Init(115200u);
+
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 10u);                 /* Sleep between presses, see app_lowpwr.h              */
+
+    APP_TRACE_DBG(("listening on kgpiosw1 and kgpiosw2, toggling red and green leds...\n\r"));
+
+    App_AO_Start(APP_REPORT_PERIOD_S);                          /* Runs both switches, see app_ao.h                     */
+
+    OSTaskDel((OS_TCB *)0, &os_err);
+}
+
+
+/*
+*********************************************************************************************************
+*                                            SWITCH STATE
+*********************************************************************************************************
+*/
+
+static  void  Sw_Run (APP_AO  *p_ao, const  APP_AO_EVT  *p_evt)
+{
+    APP_SW  *p_sw = (APP_SW *)p_ao;
+
+
+    if (p_evt->Sig == APP_SIG_PRESS) {
+        GPIO_DRV_TogglePinOutput(p_sw->LedPin);
+    }
+}
@@ -0,0 +1,322 @@
+/*
+*********************************************************************************************************
+*
+*                                         Micrium uC/OS-III on
+*                                        Freescale Kinetis K64
+*                                               on the
+*
+*                                         Freescale FRDM-K64F
+*                                          Evaluation Board
+*
+*
+*
+* Same behaviour as sw1sw2_interrupts_lab5.c (SW1 toggles the red led, SW2 the green one, leds can be on at the
+* same time) with a single handler task pending on an event flag group instead of one task and one semaphore
+* per switch
+* Switches are debounced by app_debounce.c (one flag post per press)
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             ADDITIONAL NOTES
+*
+* Each debounced press sets its own bit in SwFlags; the task pends with set-any semantics and consumes the
+* bits it was given, so presses of both switches between two wake-ups are serviced by one wake-up. A second
+* press of the same switch before the task runs is merged into the first one (a semaphore would count it):
+* with the 10 ms settle window and the task deadline below, this cannot happen for a human press.
+*
+* RAM of the switch handling (TCBs, stacks and kernel objects) for both designs and the latency from the post
+* (PIT1 ISR) to the LED write are printed every APP_REPORT_PERIOD_S seconds; sw1sw2_interrupts_lab5.c prints
+* the same latency line for comparison.
+*********************************************************************************************************
+*/
+
+/*
+*********************************************************************************************************
+*                                             INCLUDE FILES
+*********************************************************************************************************
+*/
+#include "fsl_interrupt_manager.h"
+
+#include  <stdio.h>
+#include  <math.h>
+#include  <lib_math.h>
+#include  <cpu_core.h>
+
+#include  <app_cfg.h>
+#include  <os.h>
+
+#include  <fsl_os_abstraction.h>
+#include  <system_MK64F12.h>
+#include  <board.h>
+
+#include  <bsp_ser.h>
+
+#include <fsl_gpio_common.h>
+
+#include  "app_debounce.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_ramfunc.h"
+#include  "app_rms.h"
+
+
+/*
+*********************************************************************************************************
+*                                            LOCAL DEFINES
+*********************************************************************************************************
+*/
+
+#define  APP_REPORT_PERIOD_S                      10u
+
+#define  APP_SW_FLAG_RED                    DEF_BIT_00          /* SW1                                                  */
+#define  APP_SW_FLAG_GREEN                  DEF_BIT_01          /* SW2                                                  */
+#define  APP_SW_FLAG_ALL                   (APP_SW_FLAG_RED | APP_SW_FLAG_GREEN)
+
+                                                                /* RAM of the switch handling, per design               */
+#define  APP_RAM_TASK                      (sizeof(OS_TCB) + APP_CFG_TASK_START_STK_SIZE * sizeof(CPU_STK))
+#define  APP_RAM_SEM_DESIGN                (2u * (APP_RAM_TASK + sizeof(OS_SEM)))
+#define  APP_RAM_FLAG_DESIGN               (APP_RAM_TASK + sizeof(OS_FLAG_GRP))
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+static  OS_TCB       AppTaskStartTCB;
+static  CPU_STK      AppTaskStartStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_TCB       TaskSwTCB;
+static  CPU_STK      TaskSwStk[APP_CFG_TASK_START_STK_SIZE];
+
+static  OS_FLAG_GRP  SwFlags;
+
+static  CPU_INT32U   LatCtr;                                    /* Post to LED latency, written by TaskSw only          */
+static  CPU_TS       LatSum;
+static  CPU_TS       LatMax;
+static  CPU_INT32U   WakeCtr;
+static  CPU_TS_TMR_FREQ  TS_Freq;
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+static  void  AppTaskStart (void  *p_arg);
+static  void  AppTaskSw (void  *p_arg);
+static  CPU_INT32U  AppTS_to_uS (CPU_INT64U  ts);
+
+/*
+*********************************************************************************************************
+*                                             TASK TABLE
+*
+* The task is sporadic: the period is the minimum time between two presses; one run may toggle both leds.
+*********************************************************************************************************
+*/
+static  APP_RMS_TASK  AppTaskTbl[] = {
+    /* TCB          name          task       arg  stack            stack size                   T       D       C */
+    { &TaskSwTCB,   "App Task Sw", AppTaskSw, 0u, &TaskSwStk[0u], APP_CFG_TASK_START_STK_SIZE, 25000u, 10000u, 40u, 0u, 0u },
+};
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+// called by the debounce engine (PIT1 ISR) once a switch has settled on a new level, p_arg is its flag bit
+static void Sw_Debounced(CPU_INT32U pin, CPU_INT32U level, void *p_arg)
+{
+  OS_ERR  os_err;
+
+  (void)pin;
+
+  if( level == 0u )     // pressed
+  {
+    OSFlagPost(&SwFlags,
+               (OS_FLAGS)(CPU_ADDR)p_arg,
+                OS_OPT_POST_FLAG_SET,
+               &os_err);
+  }
+}
+
+
+int  main (void)
+{
+    OS_ERR   err;
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_ERR  cpu_err;
+#endif
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
+    hardware_init();
+    GPIO_DRV_Init(switchPins, ledPins);
+
+
+#if (CPU_CFG_NAME_EN == DEF_ENABLED)
+    CPU_NameSet((CPU_CHAR *)"MK64FN1M0VMD12",
+                (CPU_ERR  *)&cpu_err);
+#endif
+
+    OSA_Init();                                                 /* Init uC/OS-III.                                      */
+
+    OSFlagCreate(&SwFlags,                                      /* One bit per switch, all clear                        */
+                 "sw flags",
+                 (OS_FLAGS)0,
+                 &err);
+
+    App_IRQ_Init();                                             // NVIC priority plan, see app_irq.h
+    App_Debounce_Init(10u);                                     // settle the switches on PIT1, see app_debounce.h
+    App_Debounce_ChAdd(kGpioSW1, "SW1", DEF_TRUE, Sw_Debounced, (void *)APP_SW_FLAG_RED);
+    App_Debounce_ChAdd(kGpioSW2, "SW2", DEF_TRUE, Sw_Debounced, (void *)APP_SW_FLAG_GREEN);
+
+    OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
+                 "App Task Start",
+                  AppTaskStart,
+                  0u,
+                  APP_CFG_TASK_START_PRIO,
+                 &AppTaskStartStk[0u],
+                 (APP_CFG_TASK_START_STK_SIZE / 10u),
+                  APP_CFG_TASK_START_STK_SIZE,
+                  0u,
+                  0u,
+                  0u,
+                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+                 &err);
+
+    OSA_Start();                                                /* Start multitasking (i.e. give control to uC/OS-III). */
+
+    while (DEF_ON) {                                            /* Should Never Get Here                                */
+        ;
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          TASKS
+*********************************************************************************************************
+*/
+
+static  void  AppTaskStart (void *p_arg)
+{
+    OS_ERR      os_err;
+    CPU_ERR     cpu_err;
+    CPU_INT32U  lat_ctr;
+    CPU_TS      lat_sum;
+    CPU_TS      lat_max;
+    CPU_INT32U  wake_ctr;
+    char        tmp[128];
+    CPU_SR_ALLOC();
+
+    (void)p_arg;
+
+
+    CPU_Init();                                                 /* Initialize the uC/CPU Services.                      */
+    Mem_Init();                                                 /* Initialize the Memory Management Module              */
+    Math_Init();                                                /* Initialize the Mathematical Module                   */
+
+    BSP_Ser_Init(115200u);
+
+    TS_Freq = CPU_TS_TmrFreqGet(&cpu_err);
+
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 10u);                 /* Sleep between presses, see app_lowpwr.h              */
+
+    App_RMS_Start(AppTaskTbl,                                   /* Create the switch task                               */
+                  sizeof(AppTaskTbl) / sizeof(AppTaskTbl[0]),
+                  APP_CFG_TASK_START_PRIO + 1u,
+                 &os_err);
+
+    sprintf(tmp, "Switch RAM: %u bytes (1 task, 1 flag group), %u bytes with 2 tasks and 2 semaphores\n\r",
+            (unsigned)APP_RAM_FLAG_DESIGN,
+            (unsigned)APP_RAM_SEM_DESIGN);
+    APP_TRACE_DBG(( tmp ));
+
+    while (DEF_TRUE) {                                          /* The start task becomes the report task.              */
+        OSTimeDlyHMSM(0u, 0u, APP_REPORT_PERIOD_S, 0u,
+                      OS_OPT_TIME_HMSM_STRICT,
+                      &os_err);
+
+        CPU_CRITICAL_ENTER();
+        lat_ctr  = LatCtr;
+        lat_sum  = LatSum;
+        lat_max  = LatMax;
+        wake_ctr = WakeCtr;
+        CPU_CRITICAL_EXIT();
+        if (lat_ctr == 0u) {
+            continue;
+        }
+        sprintf(tmp, "%u presses in %u wake-ups, post to LED latency %u us avg, %u us max\n\r",
+                (unsigned)lat_ctr,
+                (unsigned)wake_ctr,
+                (unsigned)AppTS_to_uS(lat_sum / lat_ctr),
+                (unsigned)AppTS_to_uS(lat_max));
+        APP_TRACE_DBG(( tmp ));
+    }
+}
+
+static  void  AppTaskSw (void *p_arg)
+{
+    OS_ERR      os_err;
+    OS_FLAGS    flags;
+    CPU_TS      ts;
+    CPU_TS      lat;
+    CPU_INT32U  nbr;
+    CPU_SR_ALLOC();
+
+    (void)p_arg;
+
+    APP_TRACE_DBG(("listening on kgpiosw1 and kgpiosw2, toggling red and green leds...\n\r"));
+
+    while (DEF_TRUE) {                                          /* Task body, always written as an infinite loop.       */
+
+        (void)OSFlagPend(&SwFlags,
+                          APP_SW_FLAG_ALL,
+                          0u,
+                          OS_OPT_PEND_BLOCKING + OS_OPT_PEND_FLAG_SET_ANY + OS_OPT_PEND_FLAG_CONSUME,
+                         &ts,                                   /* Time of the last post                                */
+                         &os_err);
+        if (os_err != OS_ERR_NONE) {
+            continue;
+        }
+        flags = OSFlagPendGetFlagsRdy(&os_err);                 /* Both bits if both switches were pressed              */
+
+        nbr = 0u;
+        if ((flags & APP_SW_FLAG_RED) != 0u) {
+            GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+            nbr++;
+        }
+        if ((flags & APP_SW_FLAG_GREEN) != 0u) {
+            GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+            nbr++;
+        }
+        lat = OS_TS_GET() - ts;
+
+        CPU_CRITICAL_ENTER();
+        WakeCtr++;
+        LatCtr += nbr;
+        LatSum += lat * nbr;
+        if (lat > LatMax) {
+            LatMax = lat;
+        }
+        CPU_CRITICAL_EXIT();
+    }
+}
+
+
+/*
+*********************************************************************************************************
+*                                          AppTS_to_uS()
+*
+* Description : Converts CPU timestamp ticks to microseconds.
+*********************************************************************************************************
+*/
+
+static  CPU_INT32U  AppTS_to_uS (CPU_INT64U  ts)
+{
+    if (TS_Freq == 0u) {
+        return (0u);
+    }
+    return ((CPU_INT32U)((ts * 1000000u) / TS_Freq));
+}
@@ -13,6 +13,9 @@
 * Create two tasks: 1) turns on/off red led when SW1 is pressed; 2) turns on/off green led when SW2 is pressed
 * Use an ISR to respond to the triggering of the switches and use two distinct semaphores;
 * leds can be on at the same time
+* Switches are debounced by app_debounce.c (one semaphore post per press)
+* The post to LED latency is printed every APP_REPORT_PERIOD_S seconds, see sw1sw2_flags_lab5.c for the single
+* task version
 *********************************************************************************************************
 */
 
@@ -23,6 +26,7 @@
 */
 #include "fsl_interrupt_manager.h"
 
+#include  <stdio.h>
 #include  <math.h>
 #include  <lib_math.h>
 #include  <cpu_core.h>
@@ -38,6 +42,12 @@
 
 #include <fsl_gpio_common.h>    // externs g_PortBaseAddr needed in ISR
 
+#include  "app_debounce.h"
+#include  "app_irq.h"
+#include  "app_lowpwr.h"
+#include  "app_ramfunc.h"
+#include  "app_rms.h"
+
 
 /*
 *********************************************************************************************************
@@ -45,6 +55,8 @@
 *********************************************************************************************************
 */
 
+#define  APP_REPORT_PERIOD_S                      10u
+
 
 /*
 *********************************************************************************************************
@@ -65,6 +77,11 @@ static OS_SEM MySem2;
 // static CPU_TS ts;
 static OS_ERR os_err;
 
+static  CPU_INT32U   LatCtr;                                    /* Post to LED latency, both tasks                      */
+static  CPU_TS       LatSum;
+static  CPU_TS       LatMax;
+static  CPU_TS_TMR_FREQ  TS_Freq;
+
 /*
 *********************************************************************************************************
 *                                      LOCAL FUNCTION PROTOTYPES
@@ -73,65 +90,37 @@ static OS_ERR os_err;
 static  void  AppTaskStart (void  *p_arg);
 static  void  AppTaskRed (void  *p_arg);
 static  void  AppTaskGreen (void  *p_arg);
+static  void  AppLatAdd (CPU_TS  ts);
+
+/*
+*********************************************************************************************************
+*                                             TASK TABLE
+*
+* Both tasks are sporadic: the period is the minimum time between two presses of the same switch.
+*********************************************************************************************************
+*/
+static  APP_RMS_TASK  AppTaskTbl[] = {
+    /* TCB           name              task          arg  stack               stack size                   T       D       C */
+    { &TaskRedTCB,   "App Task Red",   AppTaskRed,   0u, &TaskRedStk[0u],   APP_CFG_TASK_START_STK_SIZE, 50000u, 10000u, 20u, 0u, 0u },
+    { &TaskGreenTCB, "App Task Green", AppTaskGreen, 0u, &TaskGreenStk[0u], APP_CFG_TASK_START_STK_SIZE, 50000u, 10000u, 20u, 0u, 0u },
+};
+
 /*
 *********************************************************************************************************
 *                                                main()
 *********************************************************************************************************
 */
-// handler associated to SW1 (labeled SW2 on board)
-void SW1_Intr_Handler(void)
+// called by the debounce engine (PIT1 ISR) once a switch has settled on a new level, p_arg is its semaphore
+static void Sw_Debounced(CPU_INT32U pin, CPU_INT32U level, void *p_arg)
 {
-  static uint32_t c_ifsr;          // port c interrupt flag status register
-  uint32_t c_portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(kGpioSW1)];
-  uint32_t portPinMask = (1 << GPIO_EXTRACT_PIN(kGpioSW1));
-
-  CPU_CRITICAL_ENTER();         // enter critical section (disable interrupts)
+  (void)pin;
 
-  OSIntEnter();         // notify to scheduler the beginning of an ISR ("This allows ?C/OS-III to keep track of interrupt nesting")
-
-  c_ifsr = PORT_HAL_GetPortIntFlag(c_portBaseAddr);         // get intr flag reg related to port C
-
-  if( (c_ifsr & portPinMask) ) // check if kGpioSW1 generated the interrupt [pin 6 -> 7th flag (flags start with index 0)]
+  if( level == 0u )     // pressed
   {
-      //sem_sw1_post
-    OSSemPost(&MySem1,
-                         OS_OPT_POST_1 + OS_OPT_POST_NO_SCHED,
+    OSSemPost((OS_SEM *)p_arg,
+                         OS_OPT_POST_1,
                         &os_err);
   }
-
-  GPIO_DRV_ClearPinIntFlag( kGpioSW1 );
-  CPU_CRITICAL_EXIT();  // renable interrupts
-
-  OSIntExit();          /* notify to scheduler the end of an ISR ("determines if a higher priority task is ready-to-run.
-                          If so, the interrupt returns to the higher priority task instead of the interrupted task.") */
-}
-
-// handler associated to SW2 (labeled SW3 on board)
-void SW2_Intr_Handler(void)
-{
-  static uint32_t a_ifsr;          // port a interrupt flag status register
-  uint32_t a_portBaseAddr = g_portBaseAddr[GPIO_EXTRACT_PORT(kGpioSW2)];
-  uint32_t portPinMask = (1 << GPIO_EXTRACT_PIN(kGpioSW2));
-
-  CPU_CRITICAL_ENTER();         // enter critical section (disable interrupts)
-
-  OSIntEnter();         // notify to scheduler the beginning of an ISR ("This allows ?C/OS-III to keep track of interrupt nesting")
-
-  a_ifsr = PORT_HAL_GetPortIntFlag(a_portBaseAddr);             // get intr flag reg related to port A
-
-  if((a_ifsr & portPinMask))
-   {
-     //sem_sw2_post
-    OSSemPost(&MySem2,
-                         OS_OPT_POST_1 + OS_OPT_POST_NO_SCHED,
-                        &os_err);
-  }
-
-  GPIO_DRV_ClearPinIntFlag( kGpioSW2 );
-  CPU_CRITICAL_EXIT();  // renable interrupts
-
-  OSIntExit();          /* notify to scheduler the end of an ISR ("determines if a higher priority task is ready-to-run.
-                          If so, the interrupt returns to the higher priority task instead of the interrupted task.") */
 }
 
 
@@ -142,6 +131,7 @@ int  main (void)
 #if (CPU_CFG_NAME_EN == DEF_ENABLED)
     CPU_ERR  cpu_err;
 #endif
+    App_RamFunc_Init();                                         /* SRAM code and data, before any use (app_ramfunc.h)   */
     hardware_init();
     GPIO_DRV_Init(switchPins, ledPins);
 
@@ -163,8 +153,10 @@ int  main (void)
                  0,
                 &err);
 
-    INT_SYS_InstallHandler(PORTC_IRQn, SW1_Intr_Handler);       // associate ISR with sw1 intr source
-    INT_SYS_InstallHandler(PORTA_IRQn, SW2_Intr_Handler);       // associate ISR with sw2 intr source
+    App_IRQ_Init();                                             // NVIC priority plan, see app_irq.h
+    App_Debounce_Init(10u);                                     // settle the switches on PIT1, see app_debounce.h
+    App_Debounce_ChAdd(kGpioSW1, "SW1", DEF_TRUE, Sw_Debounced, &MySem1);
+    App_Debounce_ChAdd(kGpioSW2, "SW2", DEF_TRUE, Sw_Debounced, &MySem2);
 
     OSTaskCreate(&AppTaskStartTCB,                              /* Create the start task                                */
                  "App Task Start",
@@ -196,7 +188,13 @@ int  main (void)
 
 static  void  AppTaskStart (void *p_arg)
 {
-    OS_ERR    os_err;
+    OS_ERR      os_err;
+    CPU_ERR     cpu_err;
+    CPU_INT32U  lat_ctr;
+    CPU_TS      lat_sum;
+    CPU_TS      lat_max;
+    char        tmp[96];
+    CPU_SR_ALLOC();
 
     (void)p_arg;
 
@@ -207,35 +205,33 @@ static  void  AppTaskStart (void *p_arg)
 
     BSP_Ser_Init(115200u);
 
-    OSTaskCreate(&TaskRedTCB,                              /* Create the red task                                */
-                 "App Task Red",
-                  AppTaskRed,
-                  0u,
-                  APP_CFG_TASK_START_PRIO,
-                 &TaskRedStk[0u],
-                 (APP_CFG_TASK_START_STK_SIZE / 10u),
-                  APP_CFG_TASK_START_STK_SIZE,
-                  0u,
-                  0u,
-                  0u,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
-                 &os_err);
+    TS_Freq = CPU_TS_TmrFreqGet(&cpu_err);
 
-    OSTaskCreate(&TaskGreenTCB,                              /* Create the green task                                */
-                 "App Task Green",
-                  AppTaskGreen,
-                  0u,
-                  APP_CFG_TASK_START_PRIO,
-                 &TaskGreenStk[0u],
-                 (APP_CFG_TASK_START_STK_SIZE / 10u),
-                  APP_CFG_TASK_START_STK_SIZE,
-                  0u,
-                  0u,
-                  0u,
-                 (OS_OPT_TASK_STK_CHK | OS_OPT_TASK_STK_CLR | OS_OPT_TASK_SAVE_FP),
+    App_LowPwr_Init(APP_LOWPWR_MODE_VLPS, 10u);                 /* Sleep between presses, see app_lowpwr.h              */
+
+    App_RMS_Start(AppTaskTbl,                                   /* Create the red and green tasks                       */
+                  sizeof(AppTaskTbl) / sizeof(AppTaskTbl[0]),
+                  APP_CFG_TASK_START_PRIO + 1u,
                  &os_err);
 
-    while (DEF_TRUE) {                                          /* Task body, always written as an infinite loop.       */
+    while (DEF_TRUE) {                                          /* The start task becomes the report task.              */
+        OSTimeDlyHMSM(0u, 0u, APP_REPORT_PERIOD_S, 0u,
+                      OS_OPT_TIME_HMSM_STRICT,
+                      &os_err);
+
+        CPU_CRITICAL_ENTER();
+        lat_ctr = LatCtr;
+        lat_sum = LatSum;
+        lat_max = LatMax;
+        CPU_CRITICAL_EXIT();
+        if ((lat_ctr == 0u) || (TS_Freq == 0u)) {
+            continue;
+        }
+        sprintf(tmp, "%u presses, post to LED latency %u us avg, %u us max\n\r",
+                (unsigned)lat_ctr,
+                (unsigned)(((CPU_INT64U)(lat_sum / lat_ctr) * 1000000u) / TS_Freq),
+                (unsigned)(((CPU_INT64U)lat_max * 1000000u) / TS_Freq));
+        APP_TRACE_DBG(( tmp ));
     }
 }
 
@@ -257,6 +253,7 @@ static  void  AppTaskRed (void *p_arg)
                         &os_err);
 
        GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_RED);
+       AppLatAdd(ts);                   // ts: time of the post
 
 
 
@@ -282,6 +279,26 @@ static  void  AppTaskGreen (void *p_arg)
                         &os_err);
 
        GPIO_DRV_TogglePinOutput(BOARD_GPIO_LED_GREEN);
+       AppLatAdd(ts);
+
+    }
+}
+
+
+// adds the latency from the post (time stamp ts) to now
+static  void  AppLatAdd (CPU_TS  ts)
+{
+    CPU_TS  lat;
+    CPU_SR_ALLOC();
+
+
+    lat = OS_TS_GET() - ts;
 
+    CPU_CRITICAL_ENTER();
+    LatCtr++;
+    LatSum += lat;
+    if (lat > LatMax) {
+        LatMax = lat;
     }
+    CPU_CRITICAL_EXIT();
 }
@@ -0,0 +1,156 @@
+/*
+*********************************************************************************************************
+*
+*                                    Frequency counter host check
+*
+* Host program for app_freqcnt.c built against the stand-ins of app_freqcnt_host.h: plays the input edges and
+* the PIT2 gates (with a spread of ISR latency on the gate samples and a CPU timestamp that wraps) for a few
+* input rates, and checks that every gate frequency is within one edge per gate of the input. One case masks
+* the counter wrap interrupt so that the wrap is still pending when the gate samples the count. The reports of
+* App_FreqCnt_Report() are printed after each case.
+*
+* Build : cc -std=c99 -DAPP_FREQCNT_HOST -I.. -o freqcnt_host freqcnt_host.c ../app_freqcnt.c
+* Usage : freqcnt_host         (exit status 0 when every case passes)
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+#include  <stdint.h>
+
+#include  "app_freqcnt.h"
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#define  FREQCNT_HOST_GATE_MS                    100u
+#define  FREQCNT_HOST_GATE_NBR                     8u           /* Gates per case.                                      */
+#define  FREQCNT_HOST_LAT_MAX                    600u           /* Gate ISR latency spread, in timestamp counts.        */
+#define  FREQCNT_HOST_TS_START            0xFFF00000u           /* The timestamp wraps during the first case.           */
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  freqcnt_host_case {
+    const  char  *NamePtr;
+    uint32_t      Freq_Hz;
+    int           OvfPend;                                      /* Wrap interrupt masked until the gate sample.         */
+} FREQCNT_HOST_CASE;
+
+
+/*
+*********************************************************************************************************
+*                                       LOCAL GLOBAL VARIABLES
+*********************************************************************************************************
+*/
+
+static  const  FREQCNT_HOST_CASE  FreqCnt_HostCase[] = {
+    { "1 kHz",                         1000u,              0 },
+    { "123.457 kHz",                 123457u,              0 },
+    { "one wrap per gate, pending",  655360u,              1 },
+    { "max measurable",              APP_FREQCNT_MAX_HZ,   0 },
+};
+
+static  uint64_t  FreqCnt_HostTime;                             /* Since the first sample, in timestamp counts.         */
+static  uint64_t  FreqCnt_HostEdgeCtr;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  int  FreqCnt_HostCaseRun (const  FREQCNT_HOST_CASE  *p_case);
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (void)
+{
+    size_t  i;
+    int     err;
+
+
+    App_FreqCnt_HostTS = FREQCNT_HOST_TS_START;
+    App_FreqCnt_Init(FREQCNT_HOST_GATE_MS, 0u);
+    App_FreqCnt_HostGate();                                     /* First sample: no gate yet                            */
+
+    err = 0;
+    for (i = 0u; i < sizeof(FreqCnt_HostCase) / sizeof(FreqCnt_HostCase[0]); i++) {
+        err |= FreqCnt_HostCaseRun(&FreqCnt_HostCase[i]);
+    }
+    printf((err == 0) ? "freqcnt_host: all cases passed\n" : "freqcnt_host: FAILED\n");
+    return ((err == 0) ? 0 : 1);
+}
+
+
+/*
+*********************************************************************************************************
+*                                        FreqCnt_HostCaseRun()
+*
+* Description : Runs the gates of one case: the edges up to each sample follow the input rate over the real
+*               time between samples, the latency included.
+*
+* Return(s)   : 0 if every gate frequency is within one edge per gate of the input, 1 otherwise.
+*********************************************************************************************************
+*/
+
+static  int  FreqCnt_HostCaseRun (const  FREQCNT_HOST_CASE  *p_case)
+{
+    const  uint64_t  gate_cnts = ((uint64_t)APP_FREQCNT_HOST_TS_HZ / 1000u) * FREQCNT_HOST_GATE_MS;
+    const  uint32_t  tol_Hz    = 1000u / FREQCNT_HOST_GATE_MS + 1u;
+    uint64_t         time_base;
+    uint64_t         edge_base;
+    uint64_t         edge_ctr;
+    uint32_t         lat;
+    uint32_t         freq;
+    uint32_t         err_Hz;
+    uint32_t         err_max;
+    uint32_t         k;
+
+
+    time_base = FreqCnt_HostTime;
+    edge_base = FreqCnt_HostEdgeCtr;
+    err_max   = 0u;
+    for (k = 1u; k <= FREQCNT_HOST_GATE_NBR; k++) {
+        lat      = (k * 373u) % FREQCNT_HOST_LAT_MAX;
+        FreqCnt_HostTime = time_base + k * gate_cnts + lat;
+        edge_ctr = edge_base + ((uint64_t)p_case->Freq_Hz * (FreqCnt_HostTime - time_base)) / APP_FREQCNT_HOST_TS_HZ;
+
+        if (p_case->OvfPend != 0) {
+            App_FreqCnt_HostLPTMR.CSR &= ~LPTMR_CSR_TIE_MASK;
+        }
+        App_FreqCnt_HostEdges((uint32_t)(edge_ctr - FreqCnt_HostEdgeCtr));
+        FreqCnt_HostEdgeCtr = edge_ctr;
+        App_FreqCnt_HostTS  = (CPU_TS_TMR)(FREQCNT_HOST_TS_START + FreqCnt_HostTime);
+        App_FreqCnt_HostGate();
+        App_FreqCnt_HostLPTMR.CSR |= LPTMR_CSR_TIE_MASK;
+
+        freq    = App_FreqCnt_Get();
+        err_Hz  = (freq > p_case->Freq_Hz) ? (freq - p_case->Freq_Hz) : (p_case->Freq_Hz - freq);
+        err_max = (err_Hz > err_max) ? err_Hz : err_max;
+    }
+
+    printf("%-28s %9u Hz: last gate %9u Hz, max error %u Hz (tolerance %u Hz) %s\n",
+           p_case->NamePtr,
+           (unsigned)p_case->Freq_Hz,
+           (unsigned)freq,
+           (unsigned)err_max,
+           (unsigned)tol_Hz,
+           (err_max <= tol_Hz) ? "ok" : "FAIL");
+    App_FreqCnt_Report();
+
+    return ((err_max <= tol_Hz) ? 0 : 1);
+}
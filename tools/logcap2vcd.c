@@ -0,0 +1,343 @@
+/*
+*********************************************************************************************************
+*
+*                                  Logic-analyzer capture to VCD converter
+*
+* Host tool for app_logcap.c: reads a serial log, finds a capture (LOGCAP header, LCD hex lines, LOGCAP END,
+* see app_logcap.h for the format), decodes its delta + varint records and writes a VCD waveform with a 1 ns
+* timescale, for GTKWave, PulseView or any other VCD viewer. Other lines of the log are ignored.
+*
+* Build : cc -std=c99 -O2 -o logcap2vcd logcap2vcd.c
+* Usage : logcap2vcd [-n <capture index, 0 = first>] [<serial log> [<vcd file>]]   (stdin / stdout otherwise)
+*********************************************************************************************************
+*/
+
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <stdint.h>
+#include  <inttypes.h>
+
+
+/*
+*********************************************************************************************************
+*                                               DEFINES
+*********************************************************************************************************
+*/
+
+#define  LOGCAP_CH_MAX                             8u
+#define  LOGCAP_LINE_MAX                        1024u
+#define  LOGCAP_NAME_MAX                          32u
+
+
+/*
+*********************************************************************************************************
+*                                              DATA TYPES
+*********************************************************************************************************
+*/
+
+typedef  struct  logcap {
+    uint32_t   TS_Freq;
+    uint32_t   ChNbr;
+    uint32_t   InitLevels;
+    uint32_t   ByteNbr;                                         /* Announced by the header.                             */
+    uint32_t   GlitchCtr;
+    uint32_t   LostCtr;
+    char       Name[LOGCAP_CH_MAX][LOGCAP_NAME_MAX];
+    uint8_t   *BufPtr;
+    size_t     BufLen;                                          /* Received.                                            */
+    size_t     BufSize;
+} LOGCAP;
+
+
+/*
+*********************************************************************************************************
+*                                      LOCAL FUNCTION PROTOTYPES
+*********************************************************************************************************
+*/
+
+static  int       LogCap_Rd      (FILE *p_in, unsigned  cap_ix, LOGCAP  *p_cap);
+
+static  int       LogCap_HdrParse (const  char  *p_line, LOGCAP  *p_cap);
+
+static  int       LogCap_HexAdd  (const  char  *p_hex, LOGCAP  *p_cap);
+
+static  int       LogCap_VCD_Wr  (FILE *p_out, const  LOGCAP  *p_cap);
+
+static  uint64_t  LogCap_TS_to_nS (uint64_t  cnts, uint32_t  freq);
+
+
+/*
+*********************************************************************************************************
+*                                                main()
+*********************************************************************************************************
+*/
+
+int  main (int  argc, char  *argv[])
+{
+    FILE      *p_in;
+    FILE      *p_out;
+    LOGCAP     cap;
+    unsigned   cap_ix;
+    int        argi;
+    int        err;
+
+
+    cap_ix = 0u;
+    argi   = 1;
+    if ((argc > argi + 1) && (strcmp(argv[argi], "-n") == 0)) {
+        cap_ix = (unsigned)strtoul(argv[argi + 1], NULL, 10);
+        argi  += 2;
+    }
+
+    p_in  = stdin;
+    p_out = stdout;
+    if (argc > argi) {
+        p_in = fopen(argv[argi], "r");
+        if (p_in == NULL) {
+            perror(argv[argi]);
+            return (1);
+        }
+    }
+    if (argc > argi + 1) {
+        p_out = fopen(argv[argi + 1], "w");
+        if (p_out == NULL) {
+            perror(argv[argi + 1]);
+            return (1);
+        }
+    }
+
+    memset(&cap, 0, sizeof(cap));
+    err = LogCap_Rd(p_in, cap_ix, &cap);
+    if (err == 0) {
+        err = LogCap_VCD_Wr(p_out, &cap);
+    }
+
+    free(cap.BufPtr);
+    if (p_in  != stdin) {
+        fclose(p_in);
+    }
+    if (p_out != stdout) {
+        fclose(p_out);
+    }
+    return ((err == 0) ? 0 : 1);
+}
+
+
+/*
+*********************************************************************************************************
+*                                             LogCap_Rd()
+*
+* Description : Reads the capture of index 'cap_ix' from the log.
+*
+* Return(s)   : 0 if a complete capture was read, -1 otherwise (message on stderr).
+*********************************************************************************************************
+*/
+
+static  int  LogCap_Rd (FILE     *p_in,
+                        unsigned  cap_ix,
+                        LOGCAP   *p_cap)
+{
+    char      line[LOGCAP_LINE_MAX];
+    char     *p_str;
+    unsigned  ix;
+    int       in_cap;
+
+
+    ix     = 0u;
+    in_cap = 0;
+    while (fgets(line, sizeof(line), p_in) != NULL) {
+        line[strcspn(line, "\n")] = '\0';                      /* The target ends its lines with "\n\r"               */
+
+        if (in_cap == 0) {
+            p_str = strstr(line, "LOGCAP ");
+            if ((p_str == NULL) || (strncmp(p_str, "LOGCAP END", 10u) == 0)) {
+                continue;
+            }
+            if (ix++ != cap_ix) {
+                continue;
+            }
+            if (LogCap_HdrParse(p_str + 7u, p_cap) != 0) {
+                fprintf(stderr, "logcap2vcd: bad header: %s\n", p_str);
+                return (-1);
+            }
+            in_cap = 1;
+
+        } else if (strstr(line, "LOGCAP END") != NULL) {
+            if (p_cap->BufLen != p_cap->ByteNbr) {
+                fprintf(stderr, "logcap2vcd: %zu bytes received, %" PRIu32 " announced (serial data lost?)\n",
+                        p_cap->BufLen, p_cap->ByteNbr);
+            }
+            return (0);
+
+        } else {
+            p_str = strstr(line, "LCD ");
+            if (p_str == NULL) {
+                continue;                                       /* Other trace output                                   */
+            }
+            if (LogCap_HexAdd(p_str + 4u, p_cap) != 0) {
+                fprintf(stderr, "logcap2vcd: bad data line: %s\n", p_str);
+                return (-1);
+            }
+        }
+    }
+
+    fprintf(stderr, (in_cap == 0) ? "logcap2vcd: capture %u not found\n"
+                                  : "logcap2vcd: capture %u truncated (no LOGCAP END)\n", cap_ix);
+    return (-1);
+}
+
+
+/*
+*********************************************************************************************************
+*                                          LogCap_HdrParse()
+*
+* Description : Parses "<ts_hz> <ch_nbr> <init_levels> <byte_nbr> <glitches> <lost> <name0>,<name1>,...".
+*********************************************************************************************************
+*/
+
+static  int  LogCap_HdrParse (const  char    *p_line,
+                              LOGCAP         *p_cap)
+{
+    char         names[LOGCAP_LINE_MAX];
+    char        *p_name;
+    uint32_t     i;
+
+
+    names[0] = '\0';
+    if (sscanf(p_line, "%" SCNu32 " %" SCNu32 " %" SCNx32 " %" SCNu32 " %" SCNu32 " %" SCNu32 " %1023s",
+               &p_cap->TS_Freq, &p_cap->ChNbr, &p_cap->InitLevels,
+               &p_cap->ByteNbr, &p_cap->GlitchCtr, &p_cap->LostCtr, names) < 6) {
+        return (-1);
+    }
+    if ((p_cap->TS_Freq == 0u) || (p_cap->ChNbr == 0u) || (p_cap->ChNbr > LOGCAP_CH_MAX)) {
+        return (-1);
+    }
+
+    names[strcspn(names, "\r")] = '\0';
+    p_name = strtok(names, ",");
+    for (i = 0u; i < p_cap->ChNbr; i++) {
+        if (p_name != NULL) {
+            snprintf(p_cap->Name[i], LOGCAP_NAME_MAX, "%s", p_name);
+            p_name = strtok(NULL, ",");
+        } else {
+            snprintf(p_cap->Name[i], LOGCAP_NAME_MAX, "ch%" PRIu32, i);
+        }
+    }
+
+    p_cap->BufSize = (p_cap->ByteNbr != 0u) ? p_cap->ByteNbr : 1u;
+    p_cap->BufPtr  = malloc(p_cap->BufSize);
+    p_cap->BufLen  = 0u;
+    return ((p_cap->BufPtr != NULL) ? 0 : -1);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           LogCap_HexAdd()
+*
+* Description : Appends the bytes of one LCD line.
+*********************************************************************************************************
+*/
+
+static  int  LogCap_HexAdd (const  char    *p_hex,
+                            LOGCAP         *p_cap)
+{
+    unsigned   byte;
+    uint8_t   *p_buf;
+
+
+    while ((p_hex[0] != '\0') && (p_hex[0] != '\r') && (p_hex[1] != '\0')) {
+        if (sscanf(p_hex, "%2x", &byte) != 1) {
+            return (-1);
+        }
+        if (p_cap->BufLen == p_cap->BufSize) {                  /* More than announced: keep it anyway                  */
+            p_buf = realloc(p_cap->BufPtr, p_cap->BufSize * 2u);
+            if (p_buf == NULL) {
+                return (-1);
+            }
+            p_cap->BufPtr   = p_buf;
+            p_cap->BufSize *= 2u;
+        }
+        p_cap->BufPtr[p_cap->BufLen++] = (uint8_t)byte;
+        p_hex += 2;
+    }
+    return (0);
+}
+
+
+/*
+*********************************************************************************************************
+*                                           LogCap_VCD_Wr()
+*
+* Description : Decodes the records and writes the waveform. Channel i has the VCD identifier '!' + i.
+*********************************************************************************************************
+*/
+
+static  int  LogCap_VCD_Wr (FILE           *p_out,
+                            const  LOGCAP  *p_cap)
+{
+    uint64_t  t;
+    uint64_t  val;
+    uint32_t  levels;
+    uint32_t  prev;
+    uint32_t  mask;
+    uint32_t  i;
+    uint32_t  rec_nbr;
+    unsigned  shift;
+    size_t    ix;
+
+
+    mask = (1u << p_cap->ChNbr) - 1u;
+
+    fprintf(p_out, "$comment app_logcap capture: %" PRIu32 " Hz timestamps, %" PRIu32 " glitches, %" PRIu32 " lost edges $end\n",
+            p_cap->TS_Freq, p_cap->GlitchCtr, p_cap->LostCtr);
+    fprintf(p_out, "$timescale 1ns $end\n$scope module logcap $end\n");
+    for (i = 0u; i < p_cap->ChNbr; i++) {
+        fprintf(p_out, "$var wire 1 %c %s $end\n", (char)('!' + i), p_cap->Name[i]);
+    }
+    fprintf(p_out, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+    for (i = 0u; i < p_cap->ChNbr; i++) {
+        fprintf(p_out, "%u%c\n", (unsigned)((p_cap->InitLevels >> i) & 1u), (char)('!' + i));
+    }
+    fprintf(p_out, "$end\n");
+
+    t       = 0u;
+    prev    = p_cap->InitLevels & mask;
+    rec_nbr = 0u;
+    ix      = 0u;
+    while (ix < p_cap->BufLen) {
+        val   = 0u;
+        shift = 0u;
+        do {                                                    /* LEB128                                               */
+            if ((ix >= p_cap->BufLen) || (shift > 63u)) {
+                fprintf(stderr, "logcap2vcd: truncated record at byte %zu\n", ix);
+                return (-1);
+            }
+            val   |= (uint64_t)(p_cap->BufPtr[ix] & 0x7Fu) << shift;
+            shift += 7u;
+        } while ((p_cap->BufPtr[ix++] & 0x80u) != 0u);
+
+        levels = (uint32_t)val & mask;
+        t     += val >> p_cap->ChNbr;
+        fprintf(p_out, "#%" PRIu64 "\n", LogCap_TS_to_nS(t, p_cap->TS_Freq));
+        for (i = 0u; i < p_cap->ChNbr; i++) {
+            if (((levels ^ prev) >> i) & 1u) {
+                fprintf(p_out, "%u%c\n", (unsigned)((levels >> i) & 1u), (char)('!' + i));
+            }
+        }
+        prev = levels;
+        rec_nbr++;
+    }
+
+    fprintf(stderr, "logcap2vcd: %" PRIu32 " edges over %" PRIu64 " ns, %" PRIu32 " glitches, %" PRIu32 " lost\n",
+            rec_nbr, LogCap_TS_to_nS(t, p_cap->TS_Freq), p_cap->GlitchCtr, p_cap->LostCtr);
+    return (0);
+}
+
+
+static  uint64_t  LogCap_TS_to_nS (uint64_t  cnts,
+                                   uint32_t  freq)
+{
+    return ((cnts / freq) * 1000000000u + ((cnts % freq) * 1000000000u) / freq);
+}